@@ -40,17 +40,181 @@
 #include "src-gen/git_test_svi.h"
 #include "src-gen/git_test_pi.h"
 #include "src-stub/git_test_control.h"
+#include "src-stub/git_test_cfgimg.h"
+#include "src-stub/git_test_cfgidx.h"
+#include "src-stub/git_test_snap.h"
+#include "src-stub/git_test_sviclnt.h"
+
+/*
+ * Example: temperature control of a heated tank.
+ * The tank and its sensor are simulated by function blocks, so the example
+ * runs without I/O: "Heat" (heating power in %, set by the controller)
+ * -> "Tank" -> "TempTank" -> "Sensor" -> "TempRaw". The controller works on
+ * "TempRaw" through a filter. For a real tank, take the temperature from
+ * the process image and write the heating power to it.
+ * The sequence "Heater" enables the controller.
+ * Set values of the HMI: Setp/Mode bit 0 start, Setp/Value[0] temperature
+ * in degC. If another module provides the temperature setpoint, configure
+ * it as (SviClient) Var1, a REAL32; it is used while it can be read.
+ * The example is not run unless it is switched on in the configuration of
+ * the module: (Example) Tank = 1.
+ */
+#define TANK_POWER_KW       12.0f       /* heating power at 100 % */
+#define TANK_TEMPTOL        2.0f        /* at temperature within +/- K */
+#define TANK_TEMPMAX        90.0f       /* over-temperature in degC */
+
+/* Defines: input bits of the sequence "Heater" */
+#define TANK_IN_START       0x1         /* start requested by the HMI */
+#define TANK_IN_ATTEMP      0x2         /* temperature within TANK_TEMPTOL */
+#define TANK_IN_OVERTEMP    0x4         /* temperature above TANK_TEMPMAX */
+
+/* Defines: output bits of the sequence "Heater" */
+#define TANK_OUT_HEAT       0x1         /* controller in automatic mode */
+
+/* Parameters of a first order lag: Out = Offset + Gain * In, delayed by T_s */
+typedef struct PT1_PARAM
+{
+    REAL32  Gain;                       /* gain of the input */
+    REAL32  Offset;                     /* output at input 0 */
+    REAL32  T_s;                        /* time constant in s */
+    REAL32  Init;                       /* output after init */
+} PT1_PARAM;
+
+/* State of a first order lag */
+typedef struct PT1_STATE
+{
+    REAL32  Out;                        /* output of the last cycle */
+} PT1_STATE;
+
+/* Functions: being called only within this file */
+MLOCAL void Pt1_Init(void *pState, const void *pParam);
+MLOCAL void Pt1_Cycle(const GIT_TEST_FB_CTX *pCtx);
+MLOCAL void Tank_Start(void);
+MLOCAL SINT32 Tank_PidSetup(void);
+MLOCAL void Tank_Control(const IN_VARS *pInVars, OUT_VARS *pOutVars);
+
+/* Global variables: function block types and their parameters */
+MLOCAL const GIT_TEST_FB_TYPE Pt1Type = {"Pt1", sizeof(PT1_STATE), Pt1_Init, Pt1_Cycle, 1, 1};
+MLOCAL const PT1_PARAM TankParam = {0.8f, 20.0f, 600.0f, 20.0f};    /* 80 K over ambient at 100 % */
+MLOCAL const PT1_PARAM SensorParam = {1.0f, 0.0f, 2.0f, 20.0f};
+
+/* Global variables: temperature controller and filter of the example */
+MLOCAL const GIT_TEST_PID_CFG TankPidCfg[] = {
+    /* Sp, Pv, Man and Out are set/read in the bank; Kp in %/K, 0..100 % */
+    {{GIT_TEST_PID_SRC_NONE}, {GIT_TEST_PID_SRC_NONE},
+     {GIT_TEST_PID_SRC_NONE}, {GIT_TEST_PID_SRC_NONE},
+     10.0f, 300.0f, 20.0f, 2.0f, 0.0f, 100.0f, 1}
+};
+MLOCAL const GIT_TEST_FILT_SECT TankFiltSect[] = {
+    {GIT_TEST_FILT_D_PT1, 0.5f}
+};
+MLOCAL GIT_TEST_PID_BANK TankPid;
+MLOCAL UINT32 TankPidVersion = 0;       /* parameter set of the controller settings */
+MLOCAL GIT_TEST_FILT_BANK TankFilt;
+MLOCAL REAL32 TankFiltState[GIT_TEST_FILT_BIQUAD_STATELEN(1, 1)];
+MLOCAL SINT32 TankHeatSig = -1;         /* index of "Heat" */
+MLOCAL SINT32 TankTempSig = -1;         /* index of "TempRaw" */
+MLOCAL SINT32 TankSeq = -1;             /* instance of "Heater" */
+MLOCAL REAL32 TankTemp = 0;             /* filtered temperature */
+
+/* Global variables: copy of the state of the example, see git_test_control_stateSave() */
+MLOCAL GIT_TEST_PID_BANK TankPidSave;
+MLOCAL GIT_TEST_FILT_BANK TankFiltSave;
+MLOCAL REAL32 TankFiltStateSave[GIT_TEST_FILT_BIQUAD_STATELEN(1, 1)];
+MLOCAL REAL32 TankTempSave = 0;
+
+/*
+ * Function blocks, sorted by their data flow and run at each cycle before
+ * git_test_control_cycle().
+ */
+const GIT_TEST_FB_BLOCK git_test_FbList[] = {
+    /* "Heat" is external, it is set in Tank_Control() for the next cycle */
+    {"Tank", &Pt1Type, {"Heat"}, {"TempTank"}, &TankParam},
+    {"Sensor", &Pt1Type, {"TempTank"}, {"TempRaw"}, &SensorParam},
+
+    {NULL, NULL}
+};
+
+/*
+ * State machines for sequence control, compiled into transition tables at
+ * init and stepped in git_test_control_cycle().
+ */
+MLOCAL const GIT_TEST_SM_STATE HeaterStates[] = {
+    {"Off", 0}, {"Heat", TANK_OUT_HEAT}, {"Hold", TANK_OUT_HEAT}, {"Fault", 0}, {"Cool", 0}
+};
+MLOCAL const GIT_TEST_SM_TRANS HeaterTrans[] = {
+    /* also from "Cool", over-temperature again */
+    {GIT_TEST_SM_ANY, "Fault", TANK_IN_OVERTEMP, TANK_IN_OVERTEMP, 0},
+    {"Off", "Heat", TANK_IN_START, TANK_IN_START, 0},
+    {"Heat", "Off", TANK_IN_START, 0, 0},
+    {"Heat", "Hold", TANK_IN_ATTEMP, TANK_IN_ATTEMP, 0},
+    {"Heat", "Fault", 0, 0, 3600000},   /* temperature not reached within 1 h */
+    {"Hold", "Off", TANK_IN_START, 0, 0},
+    {"Hold", "Heat", TANK_IN_ATTEMP, 0, 10000},  /* left the band for 10 s */
+    {"Fault", "Cool", TANK_IN_OVERTEMP, 0, 0},
+    {"Cool", "Off", TANK_IN_START, 0, 5000}    /* 5 s without over-temperature */
+};
+MLOCAL const GIT_TEST_SM_MACHINE HeaterMachine = {
+    "Heater", HeaterStates, sizeof(HeaterStates) / sizeof(GIT_TEST_SM_STATE),
+    HeaterTrans, sizeof(HeaterTrans) / sizeof(GIT_TEST_SM_TRANS)
+};
+
+const GIT_TEST_SM_INST git_test_SmList[] = {
+    {"Heater", &HeaterMachine},
+
+    {NULL, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Start of the control task, before its first cycle.
+*        The retained state has been restored, set up everything which is
+*        kept outside of git_test_Retain here.
+*******************************************************************************/
+void git_test_control_start(void)
+{
+    Tank_Start();
+}
+
+/**
+********************************************************************************
+* @brief Keeps a copy of the state which git_test_control_cycle() keeps
+*        outside of git_test_Retain, e.g. before the warm-up cycles.
+*******************************************************************************/
+void git_test_control_stateSave(void)
+{
+    TankPidSave = TankPid;
+    TankFiltSave = TankFilt;
+    memcpy(TankFiltStateSave, TankFiltState, sizeof(TankFiltState));
+    TankTempSave = TankTemp;
+}
+
+/**
+********************************************************************************
+* @brief Restores the copy of git_test_control_stateSave().
+*******************************************************************************/
+void git_test_control_stateRestore(void)
+{
+    TankPid = TankPidSave;
+    TankFilt = TankFiltSave;
+    memcpy(TankFiltState, TankFiltStateSave, sizeof(TankFiltState));
+    TankTemp = TankTempSave;
+}
 
 /**
 ********************************************************************************
 * @brief Cyclic application function. Implement your business logic here.
+*        In the warm-up cycles git_test_AppDryRun() is TRUE: do not write
+*        direct outputs (git_test_write_*) or cause other effects outside
+*        of the module then. Keep state outside of git_test_Retain within
+*        git_test_control_stateSave()/git_test_control_stateRestore().
 *
 * @param[in]  pInVars   process image in data structure
 * @param[in]  pOutVars  process image out data structure
 *******************************************************************************/
 void git_test_control_cycle(const IN_VARS *pInVars, OUT_VARS *pOutVars)
 {
-    //TODO: Add your business logic here.
+    Tank_Control(pInVars, pOutVars);
 }
 
 /**
@@ -147,14 +311,25 @@ void git_test_pi_cbf_errorStateChangeOut(void)
 /**
 ********************************************************************************
  * @brief This is your callback function to validate the configuration values.
- *        The function is called only once after the configuration values had
- *        been read from the mconfig.ini.
+ *        The function is called each time the configuration values have
+ *        been read: from the mconfig.ini at init and at a new configuration
+ *        (RpcNewCfg), and from the binary configuration image.
+ *        The task settings have already been read, an infeasible task set
+ *        is rejected before any task is spawned.
 *******************************************************************************/
 SINT32 git_test_config_cbf_validate(CONFIG *pConfig)
 {
-    //TODO: add your validation code here
+    SINT32 ret;
 
-    return (OK);
+    /* All tasks must complete within their cycle time */
+    ret = git_test_AppSchedCheck();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Accepted: CONFIG of the module, stored in the binary configuration image */
+    return (git_test_cfgimg_takeConfig(pConfig, sizeof(*pConfig)));
 }
 
 /**
@@ -243,3 +418,146 @@ void git_test_direct_getErrorInChan(SINT32 ErrorIndex)
         // Everything returned to ok
     }
 }
+
+/**
+********************************************************************************
+* @brief Sets up the output of a first order lag.
+*
+* @param[out] pState      state of the block
+* @param[in]  pParam      parameters, PT1_PARAM
+*******************************************************************************/
+MLOCAL void Pt1_Init(void *pState, const void *pParam)
+{
+    ((PT1_STATE *)pState)->Out = ((const PT1_PARAM *)pParam)->Init;
+}
+
+/**
+********************************************************************************
+* @brief Cycle of a first order lag, backward Euler.
+*
+* @param[in]  pCtx        context of the block
+*******************************************************************************/
+MLOCAL void Pt1_Cycle(const GIT_TEST_FB_CTX *pCtx)
+{
+    PT1_STATE *pState = (PT1_STATE *)pCtx->pState;
+    const PT1_PARAM *pParam = (const PT1_PARAM *)pCtx->pParam;
+    REAL32  Dt = pCtx->pEnv->Dt_s;
+    REAL32  Target = pParam->Offset + (pParam->Gain * GIT_TEST_FB_IN(pCtx, 0));
+
+    pState->Out += (Target - pState->Out) * Dt / (pParam->T_s + Dt);
+    GIT_TEST_FB_OUT(pCtx, 0) = pState->Out;
+}
+
+/**
+********************************************************************************
+* @brief Example: start of the temperature control of the tank.
+*        The controller is set up and continues in its retained state,
+*        as do the sequences. The example is not run if it is not switched
+*        on by (Example) Tank or on an error.
+*******************************************************************************/
+MLOCAL void Tank_Start(void)
+{
+    SINT32  Enable = FALSE;
+
+    /* Not part of the shipped cycle unless switched on */
+    (void)git_test_cfgidx_getInt("Example", "Tank", FALSE, &Enable);
+    if (!Enable)
+    {
+        TankHeatSig = -1;
+        return;
+    }
+
+    TankHeatSig = git_test_fb_findSignal("Heat");
+    TankTempSig = git_test_fb_findSignal("TempRaw");
+    TankSeq = git_test_sm_findInst("Heater");
+    TankPidVersion = 0;
+
+    if ((TankHeatSig < 0) || (TankTempSig < 0) || (TankSeq < 0) ||
+        (git_test_filt_biquadInit(&TankFilt, 1, TankFiltSect, 1, TankFiltState,
+                                  GIT_TEST_FILT_BIQUAD_STATELEN(1, 1)) < 0) ||
+        (Tank_PidSetup() < 0))
+    {
+        TankHeatSig = -1;
+        return;
+    }
+
+    git_test_pid_load(&TankPid, &git_test_Retain.Pid);
+}
+
+/**
+********************************************************************************
+* @brief Example: settings of the controller, taken over at the start and
+*        with each new parameter set. The states of the controller are kept.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, bad settings
+*******************************************************************************/
+MLOCAL SINT32 Tank_PidSetup(void)
+{
+    /* Settings from the parameter set would be taken from GIT_TEST_CYCLE_CONFIG */
+    if (git_test_pid_setup(&TankPid, TankPidCfg, 1) < 0)
+    {
+        /* Reported by git_test_pid_setup() */
+        return (ERROR);
+    }
+
+    TankPidVersion = git_test_pParam ? git_test_pParam->Version : 1;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Example: temperature control of the tank.
+*        Only the states of the controller are kept in GIT_TEST_RETAIN_DATA,
+*        its settings are set up again at each start and with each new
+*        parameter set. In manual mode the heating power is 0.
+*
+* @param[in]  pInVars   process image in data structure
+* @param[in]  pOutVars  process image out data structure
+*******************************************************************************/
+MLOCAL void Tank_Control(const IN_VARS *pInVars, OUT_VARS *pOutVars)
+{
+    GIT_TEST_PID_BANK *pPid = &TankPid;
+    REAL32  Dt = git_test_AppCycleDt();
+    const REAL32 *pRemoteSp = (const REAL32 *)git_test_sviclnt_getVal(0);
+    REAL32  Sp = pRemoteSp ? *pRemoteSp : git_test_SnapWork.Setp.Value[0];
+    REAL32  TempRaw;
+    UINT32  Inputs;
+
+    if (TankHeatSig < 0)
+    {
+        return;
+    }
+
+    /* New parameter set */
+    if (git_test_pParam && (git_test_pParam->Version != TankPidVersion) && (Tank_PidSetup() < 0))
+    {
+        TankHeatSig = -1;
+        return;
+    }
+
+    /* Measured temperature, filtered */
+    TempRaw = *git_test_fb_signal(TankTempSig);
+    git_test_filt_run(&TankFilt, &TempRaw, &TankTemp, Dt);
+
+    /* Sequences of git_test_SmList[], all instances in one step */
+    Inputs = (git_test_SnapWork.Setp.Mode & 0x1) ? TANK_IN_START : 0;
+    Inputs |= ((TankTemp > (Sp - TANK_TEMPTOL)) && (TankTemp < (Sp + TANK_TEMPTOL))) ?
+              TANK_IN_ATTEMP : 0;
+    Inputs |= (TankTemp > TANK_TEMPMAX) ? TANK_IN_OVERTEMP : 0;
+    git_test_sm_setInputs(TankSeq, Inputs);
+    git_test_sm_step(Dt);
+    git_test_pid_setAuto(pPid, 0, (git_test_sm_outputs(TankSeq) & TANK_OUT_HEAT) ? TRUE : FALSE);
+
+    pPid->Sp[0] = Sp;
+    pPid->Pv[0] = TankTemp;
+    pPid->Man[0] = 0;
+    git_test_pid_cycle(pPid, pInVars, pOutVars, Dt);
+
+    /* Heating power of the next cycle, and the energy used */
+    *git_test_fb_signal(TankHeatSig) = pPid->Out[0];
+    git_test_Retain.Energy_kWh += (TANK_POWER_KW * pPid->Out[0] / 100.0f) * (Dt / 3600.0f);
+
+    /* Checkpointed at cycle end */
+    git_test_pid_save(pPid, &git_test_Retain.Pid);
+}
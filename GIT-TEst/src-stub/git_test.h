@@ -18,10 +18,42 @@
 
 /*--- Defines ---*/
 
+/* Application specific SMI calls, see git_test_AppSmiSvr() */
+#define GIT_TEST_PROC_RECIPESET     100 /* store a recipe */
+#define GIT_TEST_PROC_RECIPESELECT  102 /* activate a stored recipe */
+
+/* Recipes */
+#define GIT_TEST_NB_RECIPES         8   /* number of recipe slots */
+#define GIT_TEST_RECIPE_DATALEN     512 /* maximum size of a recipe in bytes */
 
 
 /*--- Structures ---*/
 
+/* GIT_TEST_PROC_RECIPESET: Data has the layout of CONFIG of the module */
+typedef struct GIT_TEST_RECIPESET_C
+{
+    UINT32  Recipe;                     /* recipe index, 0..GIT_TEST_NB_RECIPES-1 */
+    UINT32  Len;                        /* size of Data, must be sizeof(CONFIG) */
+    UINT8   Data[GIT_TEST_RECIPE_DATALEN];
+} GIT_TEST_RECIPESET_C;
+
+typedef struct GIT_TEST_RECIPESET_R
+{
+    SINT32  RetCode;                    /* SMI_E_OK or SMI_E_FAILED */
+} GIT_TEST_RECIPESET_R;
+
+/* GIT_TEST_PROC_RECIPESELECT: all values of the recipe change in the same cycle */
+typedef struct GIT_TEST_RECIPESELECT_C
+{
+    UINT32  Recipe;                     /* recipe index */
+} GIT_TEST_RECIPESELECT_C;
+
+typedef struct GIT_TEST_RECIPESELECT_R
+{
+    SINT32  RetCode;                    /* SMI_E_OK or SMI_E_FAILED */
+    UINT32  Version;                    /* version of the published parameter set */
+} GIT_TEST_RECIPESELECT_R;
+
 
 /*--- Function prototyping ---*/
 
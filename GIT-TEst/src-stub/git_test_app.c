@@ -20,8 +20,10 @@
 #include <inetLib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <symLib.h>
 #include <sysSymTbl.h>
+#include <sigLib.h>
 
 /* MSys includes */
 #include <mtypes.h>
@@ -39,8 +41,26 @@
 #include "../src-gen/git_test_direct_int.h"
 #include "../src-gen/git_test_config.h"
 #include "git_test_e.h"
+#include "git_test.h"
 #include "git_test_int.h"
 #include "git_test_control.h"
+#include "git_test_snap.h"
+#include "git_test_wrq.h"
+#include "git_test_sviclnt.h"
+#include "git_test_svidx.h"
+#include "git_test_blk.h"
+#include "git_test_cfgidx.h"
+#include "git_test_cfgimg.h"
+#include "git_test_param.h"
+#include "git_test_log.h"
+#include "git_test_arena.h"
+#include "git_test_smirpl.h"
+#include "git_test_stack.h"
+#include "git_test_retain.h"
+#include "git_test_persist.h"
+#include "git_test_lut.h"
+#include "git_test_fb.h"
+#include "git_test_sm.h"
 
 
 
@@ -48,34 +68,47 @@
 SINT32  git_test_AppEOI(void);
 void    git_test_AppDeinit(void);
 SINT32  git_test_CfgRead(void);
+SINT32  git_test_AppNewCfg(void);
+SINT32  git_test_AppSchedCheck(void);
+void    git_test_AppArenaRelease(void);
+void    git_test_AppIdle(void);
+void    git_test_AppResume(void);
+SINT32  git_test_AppSviInit(void);
+void    git_test_AppSviDeinit(void);
+SINT32  git_test_AppSviAddGlobVars(SVI_GLOBVAR *pVarList, UINT32 NbOfVars);
+SINT32  git_test_AppSviAddVirtVars(SVI_VIRTVAR *pVarList, UINT32 NbOfVars);
 void    git_test_IsrSemGive(UINT32 UserPara, UINT32 Type);
 
 /* Functions: task administration, being called only within this file */
 MLOCAL SINT32 Task_CreateAll(void);
 MLOCAL void Task_DeleteAll(void);
-MLOCAL SINT32 Task_CfgRead(void);
+MLOCAL SINT32 Task_Create(TASK_PROPERTIES *pTaskData, UINT32 idx);
+MLOCAL void Task_Release(TASK_PROPERTIES *pTaskData);
+MLOCAL void Task_Entry(TASK_PROPERTIES *pTaskData);
+MLOCAL void Task_ExcHandler(int Signal);
+MLOCAL void Task_Supervise(void);
 MLOCAL SINT32 Task_InitTiming(TASK_PROPERTIES *pTaskData);
 MLOCAL SINT32 Task_InitTiming_Tick(TASK_PROPERTIES *pTaskData);
 MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES *pTaskData);
 MLOCAL void Task_WaitCycle(TASK_PROPERTIES *pTaskData);
+MLOCAL void Task_Resume(TASK_PROPERTIES *pTaskData);
+MLOCAL void Task_WaitRun(TASK_PROPERTIES *pTaskData);
+MLOCAL void Task_WaitWarmup(void);
+MLOCAL SINT32 Task_WdogCreate(TASK_PROPERTIES *pTaskData);
 
 /* Functions: worker task "Control" */
 MLOCAL void Control_Main(TASK_PROPERTIES *pTaskData);
 MLOCAL void Control_CycleInit(void);
-MLOCAL void Control_CycleStart(void);
+MLOCAL void Control_Warmup(TASK_PROPERTIES *pTaskData);
+MLOCAL void Control_CycleStart(UINT32 DryRun);
 MLOCAL void Control_Cycle(TASK_PROPERTIES *pTaskData);
 MLOCAL void Control_CycleEnd(TASK_PROPERTIES *pTaskData);
-
-/* Functions: SVI client */
-MLOCAL SINT32 SviClnt_Init(void);
-MLOCAL void SviClnt_Deinit(void);
-
+MLOCAL void Control_Record(TASK_PROPERTIES *pTaskData);
 
 /* Functions: handle incoming user specific SMI calls */
 SINT32  git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId);
-
-/* Global variables: SVI client */
-MLOCAL  SINT32(**pSviLib) () = NULL;    /* Information about external SVI server */
+MLOCAL SINT32 Smi_RecipeSet(APP_SMI_R *pSmiSrvReply);
+MLOCAL SINT32 Smi_RecipeSelect(APP_SMI_R *pSmiSrvReply);
 
 /*
  * Global variables: Settings for application task
@@ -87,9 +120,9 @@ MLOCAL TASK_PROPERTIES TaskProperties_aControl = {
     "",                 /* unique task name, maximum length 14 */
     "ControlTask",                      /* configuration group name */
     Control_Main,                       /* task entry function (function pointer) */
-    0,                                  /* default task priority (->Task_CfgRead) */
+    0,                                  /* default task priority (->Task_CfgParse) */
     5,                                  /* default ratio of watchdog time / cycle time
-                                         * (->Task_CfgRead) */
+                                         * (->Task_CfgParse) */
     10000,                              /* task stack size in bytes, standard size is 10000 */
     TRUE                                /* task uses floating point operations */
 };
@@ -102,6 +135,65 @@ MLOCAL TASK_PROPERTIES *TaskList[] = {
     &TaskProperties_aControl
 };
 
+/* Defines: warm-up of the tasks, see Control_Warmup() */
+#define APP_WARMUP_MAXCYCLES    1000    /* maximum of "WarmupCycles" */
+#define APP_WARMUP_TIMEOUT      2000    /* maximum wait time for the warm-up at EOI in ms */
+
+/* Defines: time base of the control task, see git_test_AppCycleDt() */
+#define APP_CYCLEDT_MAXRATIO    10      /* limit of a measured time base in nominal periods */
+
+/* Defines: restart of a task after an exception, see Task_Supervise() */
+#define APP_RESTART_HOLDOFF 1000        /* minimum time between two restarts of a task in ms */
+#define APP_TASK_NBOFVARS   4           /* SVI variables per task */
+
+/* Global variables: restart counters of all tasks, exported via SVI */
+MLOCAL CHAR AppTaskVarName[(sizeof(TaskList) / sizeof(TASK_PROPERTIES *)) * APP_TASK_NBOFVARS][SVI_ADDRLEN];
+MLOCAL SVI_GLOBVAR AppTaskVarList[(sizeof(TaskList) / sizeof(TASK_PROPERTIES *)) * APP_TASK_NBOFVARS];
+
+/* Parsed task settings, one per TaskList[] entry, also stored in the configuration image */
+typedef struct TASK_CFG
+{
+    UINT32  TimeBase;                   /* selection of time base */
+    UINT32  Priority;                   /* priority for this task */
+    REAL32  CycleTime_ms;               /* cycle time for this task in ms */
+    UINT32  Wcet_us;                    /* declared worst case execution time, 0 = unknown */
+    UINT32  StackSize;                  /* stack size of this task in bytes */
+    UINT32  ResumeAlign;                /* resume from STOP in the common phase */
+    UINT32  WarmupCycles;               /* dry-run cycles before the first cycle */
+} TASK_CFG;
+
+/* Complete parsed configuration, staged before it is applied */
+typedef struct APP_CFG
+{
+    TASK_CFG Task[sizeof(TaskList) / sizeof(TASK_PROPERTIES *)];
+    CHAR    SviClntNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN];
+} APP_CFG;
+
+/* Global variables: configuration */
+MLOCAL UINT32 AppRunning = FALSE;       /* application tasks have been started */
+MLOCAL volatile UINT32 AppResumeTick = 0;       /* tickGet() of the first cycle after RUN */
+MLOCAL REAL32 AppCycleDt_s = 0;         /* time since the last cycle of the control task */
+MLOCAL UINT32 AppDryRun = FALSE;        /* warm-up cycles are running, see git_test_AppDryRun() */
+MLOCAL UINT32 AppWaveIdx = 0;           /* next sample in the write buffer of Blk/Wave */
+MLOCAL APP_CFG *pAppCfgStaged = NULL;   /* settings being validated, see git_test_AppSchedCheck() */
+MLOCAL CONFIG AppConfig;                /* CONFIG in use, see git_test_cfgimg_setConfig() */
+MLOCAL CONFIG AppConfigStaged;          /* CONFIG being loaded, taken over if all is valid */
+MLOCAL APP_CFG *pAppCfgBuf[2] = {NULL, NULL};  /* staging copies, carved from the arena */
+
+/* Functions: configuration, being called only within this file */
+MLOCAL SINT32 Task_CfgParse(TASK_CFG *pTaskCfg);
+MLOCAL void Task_CfgGet(TASK_CFG *pTaskCfg);
+MLOCAL SINT32 Task_CfgApply(const TASK_CFG *pTaskCfg);
+MLOCAL APP_CFG *App_CfgBuf(UINT32 Idx);
+MLOCAL SINT32 App_StackInit(void);
+MLOCAL SINT32 App_TaskSviInit(void);
+MLOCAL void App_TaskVarName(UINT32 idx, CHAR *pName, UINT32 Len);
+MLOCAL SINT32 App_CfgParse(APP_CFG *pCfg);
+MLOCAL SINT32 App_CfgApply(APP_CFG *pCfg);
+MLOCAL SINT32 App_CfgImgLoad(APP_CFG *pCfg);
+MLOCAL void App_CfgImgSave(const APP_CFG *pCfg);
+MLOCAL SINT32 Task_Period(const TASK_CFG *pTaskCfg, UINT32 *pPeriod_us);
+
 
 
 /**
@@ -113,9 +205,15 @@ MLOCAL TASK_PROPERTIES *TaskList[] = {
 *******************************************************************************/
 MLOCAL void Control_Main(TASK_PROPERTIES *pTaskData)
 {
+    /* Messages of this task are formatted by the bTask */
+    (void)git_test_log_attach();
+
     /* Initialization upon task entry */
     Control_CycleInit();
 
+    /* Dry-run cycles, the first real cycle starts at RUN */
+    Control_Warmup(pTaskData);
+
     /*
      * This loop is executed endlessly
      * as long as there is no request to quit the task
@@ -123,7 +221,7 @@ MLOCAL void Control_Main(TASK_PROPERTIES *pTaskData)
     while (!pTaskData->Quit)
     {
         /* cycle start administration */
-        Control_CycleStart();
+        Control_CycleStart(FALSE);
 
         /* operational code */
         Control_Cycle(pTaskData);
@@ -131,6 +229,8 @@ MLOCAL void Control_Main(TASK_PROPERTIES *pTaskData)
         /* cycle end administration */
         Control_CycleEnd(pTaskData);
     }
+
+    git_test_log_detach();
 }
 
 /**
@@ -142,18 +242,120 @@ MLOCAL void Control_CycleInit(void)
 
     /* TODO: add what is necessary before cyclic operation starts */
 
+    /* Sequences continue in their retained states */
+    git_test_sm_load(&git_test_Retain.Sm);
+
+    /* Application state outside of git_test_Retain */
+    git_test_control_start();
+
+}
+
+/**
+********************************************************************************
+* @brief Runs the control cycle "WarmupCycles" times without effect.
+*        The first cycles after the start run several times slower (cold
+*        caches, first calls of the process image, SVI clients and the
+*        log). So they are run as dry-run: inputs are read, but outputs are
+*        not written, nothing is published, queued SVI writes and a new
+*        parameter set are left for the first real cycle. Direct outputs are
+*        suppressed by git_test_control_cycle() via git_test_AppDryRun().
+*        The retained state, the states of the function blocks, sequences
+*        and git_test_control_cycle() and the outputs are restored
+*        afterwards, the execution times of the blocks are cleared.
+*        Then the task waits for RUN, the first real cycle is on time.
+*        Stacks are not pre-touched, it would hide the high-water mark of
+*        the stack supervision.
+*
+* @param[in]  pTaskData   task properties
+*******************************************************************************/
+MLOCAL void Control_Warmup(TASK_PROPERTIES *pTaskData)
+{
+    static GIT_TEST_RETAIN_DATA Retain;
+    static OUT_VARS OutVars;
+    UINT32  First_us = 0;
+    UINT32  Last_us = 0;
+    UINT32  Start;
+    UINT32  idx;
+
+    if (pTaskData->WarmupCycles)
+    {
+        Retain = git_test_Retain;
+        OutVars = pTaskData->outVars;
+        git_test_fb_stateSave();
+        git_test_sm_stateSave();
+        git_test_control_stateSave();
+
+        AppDryRun = TRUE;
+        for (idx = 0; (idx < pTaskData->WarmupCycles) && !pTaskData->Quit; idx++)
+        {
+            Start = m_GetProcTime();
+            Control_CycleStart(TRUE);
+            Control_Cycle(pTaskData);
+            Last_us = m_GetProcTime() - Start;
+            if (idx == 0)
+            {
+                First_us = Last_us;
+            }
+
+            /* Not yet supervised by the cycle timing */
+            if (pTaskData->WdogId)
+            {
+                (void)sys_WdogTrigg(pTaskData->WdogId);
+            }
+        }
+        AppDryRun = FALSE;
+
+        git_test_Retain = Retain;
+        pTaskData->outVars = OutVars;
+        git_test_fb_stateRestore();
+        git_test_sm_stateRestore();
+        git_test_control_stateRestore();
+
+        /* Not representative, first cycles with cold caches */
+        git_test_fb_resetTimes();
+
+        /* The first real cycle has no previous one */
+        pTaskData->PrevCycleStartTime = 0;
+
+        LOG_I(1, __func__, "Task '%s': %d warm-up cycles, first %d us, last %d us",
+              pTaskData->Name, pTaskData->WarmupCycles, First_us, Last_us);
+    }
+
+    pTaskData->WarmupDone = TRUE;
+    if (pTaskData->WarmupCycles)
+    {
+        Task_WaitRun(pTaskData);
+        pTaskData->CycleStartTime = m_GetProcTime();
+    }
 }
 
 /**
 ********************************************************************************
 * @brief Administration code to be called once at each task cycle start.
+*
+* @param[in]  DryRun      warm-up cycle, SVI writes and parameter sets are not
+*                         taken over, they would be lost by the restore
 *******************************************************************************/
-MLOCAL void Control_CycleStart(void)
+MLOCAL void Control_CycleStart(UINT32 DryRun)
 {
 
     /* TODO: add what is necessary at each cycle start */
     git_test_pi_read();
 
+    /* Read variables of other software modules */
+    git_test_sviclnt_read();
+
+    if (DryRun)
+    {
+        return;
+    }
+
+    /* Take over all SVI writes which have been committed until now */
+    git_test_wrq_apply();
+
+    /* Take over a new parameter set, e.g. from RpcNewCfg or a recipe */
+    git_test_param_cycleStart();
+
 }
 
 /**
@@ -162,7 +364,23 @@ MLOCAL void Control_CycleStart(void)
 *******************************************************************************/
 MLOCAL void Control_Cycle(TASK_PROPERTIES *pTaskData)
 {
+    UINT32  Dt_us = pTaskData->Period_us;
 
+    /* Time base of the time-discrete blocks, see git_test_AppCycleDt() */
+    if ((pTaskData->TimeBase != TIME_BASE_CYCLIC) && (pTaskData->TimeBase != TIME_BASE_SYNC)
+        && pTaskData->PrevCycleStartTime)
+    {
+        Dt_us = pTaskData->CycleStartTime - pTaskData->PrevCycleStartTime;
+        if (pTaskData->Period_us && (Dt_us > APP_CYCLEDT_MAXRATIO * pTaskData->Period_us))
+        {
+            Dt_us = APP_CYCLEDT_MAXRATIO * pTaskData->Period_us;
+        }
+    }
+    pTaskData->PrevCycleStartTime = pTaskData->CycleStartTime;
+    AppCycleDt_s = Dt_us / 1000000.0f;
+
+    /* Function blocks of git_test_FbList[], in the order of their data flow */
+    git_test_fb_cycle(&pTaskData->inVars, &pTaskData->outVars, AppCycleDt_s);
 
     //TODO: add parameters
     git_test_control_cycle(&pTaskData->inVars, &pTaskData->outVars);
@@ -170,6 +388,38 @@ MLOCAL void Control_Cycle(TASK_PROPERTIES *pTaskData)
 
 }
 
+/**
+********************************************************************************
+* @brief Returns the time base for time-discrete blocks of the control task,
+*        e.g. git_test_pid_cycle().
+*        Cyclic and sync tasks use their period, the configured cycle time
+*        rounded to ticks or syncs, so jitter does not enter the controllers.
+*        Event tasks use the measured time since the last cycle, limited to
+*        APP_CYCLEDT_MAXRATIO periods, and the period in the first cycle
+*        after the start or RUN.
+*        To be called in git_test_control_cycle() only.
+*
+* @retval     time since the last cycle in s
+*******************************************************************************/
+REAL32 git_test_AppCycleDt(void)
+{
+    return (AppCycleDt_s);
+}
+
+/**
+********************************************************************************
+* @brief Returns whether the control task runs its warm-up cycles, see
+*        Control_Warmup(). Outputs must not be written then, e.g. by
+*        git_test_write_*.
+*        To be called in git_test_control_cycle() only.
+*
+* @retval     TRUE .. warm-up cycle, FALSE .. real cycle
+*******************************************************************************/
+UINT32 git_test_AppDryRun(void)
+{
+    return (AppDryRun);
+}
+
 /**
 ********************************************************************************
 * @brief Administration code to be called at each task cycle end
@@ -182,6 +432,20 @@ MLOCAL void Control_CycleEnd(TASK_PROPERTIES *pTaskData)
     /* TODO: add what is to be called at each cycle end */
     git_test_pi_write(&pTaskData->outVars);
 
+    /* Publish the values of this cycle for SVI clients */
+    git_test_Retain.CycleCnt++;
+    git_test_sm_save(&git_test_Retain.Sm);
+    git_test_SnapWork.CycleCnt = git_test_Retain.CycleCnt;
+    git_test_SnapWork.InVars = pTaskData->inVars;
+    git_test_SnapWork.OutVars = pTaskData->outVars;
+    git_test_snap_publish();
+
+    /* Checkpoint of the state to be kept on a warm restart */
+    git_test_retain_save();
+
+    /* Trace of the execution times for SVI clients */
+    Control_Record(pTaskData);
+
     /*
      * This is the very end of the cycle
      * Delay task in order to match desired cycle time
@@ -189,6 +453,27 @@ MLOCAL void Control_CycleEnd(TASK_PROPERTIES *pTaskData)
     Task_WaitCycle(pTaskData);
 }
 
+/**
+********************************************************************************
+* @brief Records the execution time of the cycle into the block Blk/Wave.
+*        A full buffer of GIT_TEST_BLK_WAVE_LEN samples is published and
+*        recording continues in the next buffer.
+*
+* @param[in]  pTaskData  pointer to task properties data structure
+*******************************************************************************/
+MLOCAL void Control_Record(TASK_PROPERTIES *pTaskData)
+{
+    REAL32  *pWave = git_test_blk_writeBuf(GIT_TEST_BLK_WAVE);
+
+    pWave[AppWaveIdx] = (REAL32)(m_GetProcTime() - pTaskData->CycleStartTime);
+
+    if (++AppWaveIdx >= GIT_TEST_BLK_WAVE_LEN)
+    {
+        git_test_blk_swap(GIT_TEST_BLK_WAVE);
+        AppWaveIdx = 0;
+    }
+}
+
 /**
 ********************************************************************************
 * @brief Performs the second phase of the module initialization.
@@ -212,18 +497,31 @@ SINT32 git_test_AppEOI(void)
         }
 
         /* Initialize SVI access to variables of other software modules */
-        if (SviClnt_Init() < 0)
+        if (git_test_sviclnt_init() < 0)
+        {
+            break;
+        }
+
+        /* Characteristic curves and maps of the control task */
+        if (git_test_lut_load() < 0)
         {
             break;
         }
 
+        /* Continue with the retained state of the last run, if valid */
+        (void)git_test_retain_restore();
+
         /* Start all application tasks listed in TaskList */
         if (Task_CreateAll() < 0)
         {
             break;
         }
 
+        /* RUN is set after the tasks are warmed up */
+        Task_WaitWarmup();
+
         /* At this point, all init actions are done successfully */
+        AppRunning = TRUE;
         return (OK);
     }
     while (0);
@@ -244,19 +542,52 @@ SINT32 git_test_AppEOI(void)
 *******************************************************************************/
 void git_test_AppDeinit(void)
 {
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    UINT32  idx;
 
     /* TODO: Free all resources which have been allocated by the application */
+    AppRunning = FALSE;
 
     git_test_direct_deinit();
 
     git_test_pi_deinit();
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        TaskList[idx]->PiInit = FALSE;
+    }
 
     /* Delete all application tasks listed in TaskList */
     Task_DeleteAll();
 
     /* Delete all SVI client access data */
-    SviClnt_Deinit();
+    git_test_sviclnt_deinit();
+
+    /* Messages of the deleted tasks */
+    git_test_log_drain();
+
+}
+
+/**
+********************************************************************************
+* @brief Drops all blocks of the application which are carved from the arena.
+*        Called at BaseDeinit by the bTask, before the arena is freed.
+*        The blocks are carved again at the next configuration read.
+*******************************************************************************/
+void git_test_AppArenaRelease(void)
+{
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    UINT32  idx;
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (TaskList[idx])
+        {
+            TaskList[idx]->pCyclicCfg = NULL;
+        }
+    }
 
+    pAppCfgBuf[0] = NULL;
+    pAppCfgBuf[1] = NULL;
 }
 
 /**
@@ -269,275 +600,1299 @@ void git_test_AppDeinit(void)
 *******************************************************************************/
 SINT32 git_test_CfgRead(void)
 {
+    APP_CFG *pCfg;
     SINT32  ret;
 
-    /* Read component specific configuration */
-    ret = git_test_config_read();
-    if (ret < 0)
+    pCfg = App_CfgBuf(0);
+    if (!pCfg)
     {
-        return (ret);
+        return (ERROR);
     }
 
-    /* Read task configuration settings from configuration file (BaseParam.CfgFileName) */
-    ret = Task_CfgRead();
-    if (ret < 0)
+    /* Known before the first load, so the image can be used at a cold start */
+    git_test_cfgimg_setConfig(&AppConfig, &AppConfigStaged, sizeof(AppConfig));
+
+    do
     {
-        return (ret);
+        /* Configuration file unchanged since the last parse: take the binary image */
+        if (App_CfgImgLoad(pCfg) < 0)
+        {
+            ret = App_CfgParse(pCfg);
+            if (ret < 0)
+            {
+                break;
+            }
+
+            /* Store the parsed settings for the next start */
+            App_CfgImgSave(pCfg);
+        }
+
+        /* No application task is running, settings can be applied directly */
+        ret = App_CfgApply(pCfg);
     }
+    while (FALSE);
 
-    return (OK);
+    return (ret);
 }
 
 /**
 ********************************************************************************
-* @brief Reads the settings from configuration file mconfig
-*        for all tasks registered in TaskList[].
-*        The task name in TaskList[] is being used as configuration group name.
-*        The initialization values in TaskList[] are being used as default values.
-*        For general configuration data, git_test_CfgParams is being used.
-*        Being called by git_test_CfgRead.
-*        All parameters are stored in the task properties data structure.
-*        All parameters are being treated as optional.
-*        There is no limitation checking of the parameters, the limits are being
-*        specified in the cru and checked by the configurator.
+* @brief Takes over a changed configuration file (RpcNewCfg).
+*        The new configuration is parsed into a staging copy and compared
+*        with the one in use. Only what has changed is applied:
+*        - changed time base, cycle time, remote variables, curves or maps:
+*          the application is restarted with the staged settings
+*        - changed task priority: the priority of the running task is set
+*        - changed CONFIG: published as new parameter set, which the control
+*          task takes over at its next cycle start without interruption
+*        Being called by the bTask.
 *
 * @retval     = 0 .. OK
 * @retval     < 0 .. ERROR
 *******************************************************************************/
-MLOCAL SINT32 Task_CfgRead(void)
+SINT32 git_test_AppNewCfg(void)
 {
     static const CHAR *pFunc = __func__;
-    UINT32  idx;
     UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
-    SINT32  ret;
-    CHAR    *section;
-    CHAR    *group;
-    CHAR    key[PF_KEYLEN_A];
-    CHAR    TmpStrg[32] = {0};
-    UINT32  Error = FALSE;
-    SINT32  TmpVal;
+    APP_CFG *pNew;
+    APP_CFG *pOld;
+    CONFIG  *pConfig;
+    UINT32  ConfigSize;
+    UINT32  Restart = FALSE;
+    UINT32  idx;
+    SINT32  ret = ERROR;
 
-    /* section name is the application name; same for all tasks */
-    section = git_test_BaseParams.AppName;
+    pNew = App_CfgBuf(0);
+    pOld = App_CfgBuf(1);
 
-    /* For all application tasks listed in TaskList */
-    for (idx = 0; idx < NbOfTasks; idx++)
+    do
     {
-        if (!TaskList[idx])
+        if (!pNew || !pOld)
         {
-            LOG_E(0, pFunc, "Invalid task properties pointer in task list entry #%d!", idx);
-            Error = TRUE;
-            continue;
+            break;
         }
 
-        /* group name is specified in the task properties */
-        group = TaskList[idx]->CfgGroup;
+        /* Settings in use; CONFIG of the module is replaced by a valid new configuration */
+        Task_CfgGet(pOld->Task);
+        git_test_sviclnt_cfgGet(pOld->SviClntNames);
 
-        /* if no group name has been specified: skip configuration reading for this task */
-        if (strlen(group) < 1)
+        ret = App_CfgParse(pNew);
+        if (ret < 0)
         {
-            LOG_I(0, pFunc, "Could not find task configuration for task '%s' in mconfig ",
-                  TaskList[idx]->Name);
-            continue;
+            /* The control task keeps its parameter set */
+            break;
         }
+        App_CfgImgSave(pNew);
 
-        /* First of all, get TaskMode.
-         * TaskMode can be TIME_BASE_CYCLIC, TIME_BASE_SYNC, TIME_BASE_EVENT, TIME_BASE_ERROR
-         */
-        sprintf(key, "TaskMode");
-        ret = pf_GetStrg(section, group, key, "", TmpStrg, sizeof(TmpStrg),
-                git_test_BaseParams.CfgLineNbr, git_test_BaseParams.CfgFileName);
+        pConfig = git_test_cfgimg_getConfig(&ConfigSize);
 
-        /* Using strcmp is safe because string literals are guaranteed null terminated. */
-        if(strcmp(TmpStrg, "Cyclic") == 0)
+        /* Application not running: no need to keep anything */
+        if (!AppRunning || !pConfig)
         {
-            TaskList[idx]->TimeBase = TIME_BASE_CYCLIC;
+            LOG_I(1, pFunc, "Application not running, full restart");
+            Restart = TRUE;
         }
-        else if(strcmp(TmpStrg, "Sync") == 0)
+
+        /* Settings which need new tasks or a new SVI client */
+        for (idx = 0; (idx < NbOfTasks) && !Restart; idx++)
         {
-            TaskList[idx]->TimeBase = TIME_BASE_SYNC;
+            if ((pNew->Task[idx].TimeBase != pOld->Task[idx].TimeBase) ||
+                (pNew->Task[idx].CycleTime_ms != pOld->Task[idx].CycleTime_ms))
+            {
+                LOG_I(1, pFunc, "Timing of task '%s' changed, full restart", TaskList[idx]->Name);
+                Restart = TRUE;
+            }
+            else if (pNew->Task[idx].StackSize != pOld->Task[idx].StackSize)
+            {
+                LOG_I(1, pFunc, "Stack size of task '%s' changed, full restart", TaskList[idx]->Name);
+                Restart = TRUE;
+            }
         }
-        else
+
+        if (!Restart && memcmp(pNew->SviClntNames, pOld->SviClntNames, sizeof(pNew->SviClntNames)))
         {
-            LOG_E(0, pFunc, "Bad task-configuration: %s not allowed for '%s'", TmpStrg, key);
-            return MIO_ER_BADCONF;
+            LOG_I(1, pFunc, "Remote variables changed, full restart");
+            Restart = TRUE;
         }
 
-        if(TaskList[idx]->TimeBase == TIME_BASE_CYCLIC)
+        /* Tables are rebuilt at EOI, the control task must not be running */
+        if (!Restart && git_test_lut_cfgChanged())
         {
-            /* Alloc memory for cyclic configuration */
-            TaskList[idx]->pCyclicCfg = sys_MemXAlloc(sizeof(CYCLIC_CFG));
-            memset(TaskList[idx]->pCyclicCfg, 0, sizeof(CYCLIC_CFG));
+            LOG_I(1, pFunc, "Curves or maps changed, full restart");
+            Restart = TRUE;
+        }
 
-            sprintf(key, "CycleTime");
-            ret = pf_GetStrg(section, group, key, "", TmpStrg, sizeof(TmpStrg),
-                    git_test_BaseParams.CfgLineNbr, git_test_BaseParams.CfgFileName);
-            /* keyword has been found */
-            if (ret >= 0 && strlen(TmpStrg) > 0)
+        if (!Restart && memcmp(pConfig, &git_test_param_getLatest()->Config, sizeof(CONFIG)))
+        {
+            /* No free parameter block, e.g. in STOP: full restart */
+            if (git_test_param_publish(pConfig, GIT_TEST_PARAM_FROMCFG) < 0)
             {
-                *((REAL32 *) & TaskList[idx]->pCyclicCfg->CycleTime_ms) = atof(TmpStrg);
+                Restart = TRUE;
             }
-            /* keyword has not been found */
-            else
+        }
+
+        if (Restart)
+        {
+            git_test_AppDeinit();
+
+            ret = App_CfgApply(pNew);
+            if (ret < 0)
             {
-                LOG_W(0, pFunc, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-                return MIO_ER_BADCONF;
+                break;
             }
 
-        }
-        else
-        {
-            LOG_E(0, pFunc, "Bad task-configuration: TimeBase unknown");
-            return MIO_ER_BADCONF;
+            ret = git_test_AppEOI();
+            break;
         }
 
-        /*
-         * Read the desired value for the task priority.
-         * If the keyword has not been found, the initialization value remains
-         * in the task properties.
-         * As an additional fall back, the priority in the base parms will be used.
-         */
-        sprintf(key, "Priority");
-        ret = pf_GetInt(section, group, key, TaskList[idx]->Priority, &TmpVal,
-                git_test_BaseParams.CfgLineNbr, git_test_BaseParams.CfgFileName);
-        /* keyword has been found */
-        if (ret >= 0 && TmpVal > 0)
-        {
-            TaskList[idx]->Priority = TmpVal;
-        }
-        /* keyword has not been found */
-        else
+        /* Only the priority has changed: keep the tasks running */
+        for (idx = 0; idx < NbOfTasks; idx++)
         {
-            LOG_W(0, pFunc, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-            return MIO_ER_BADCONF;
+            if (pNew->Task[idx].Priority != TaskList[idx]->Priority)
+            {
+                /* Task not spawned: the priority is taken at the next spawn */
+                if ((TaskList[idx]->TaskId != 0) && (TaskList[idx]->TaskId != ERROR) &&
+                    (taskPrioritySet(TaskList[idx]->TaskId, pNew->Task[idx].Priority) < 0))
+                {
+                    LOG_E(0, pFunc, "Could not set priority of task '%s'!", TaskList[idx]->Name);
+                    ret = ERROR;
+                    break;
+                }
+                LOG_I(1, pFunc, "Priority of task '%s' set to %d", TaskList[idx]->Name,
+                      pNew->Task[idx].Priority);
+                TaskList[idx]->Priority = pNew->Task[idx].Priority;
+            }
+
+            /* Only used for the analysis and at the next resume */
+            TaskList[idx]->Wcet_us = pNew->Task[idx].Wcet_us;
+            TaskList[idx]->ResumeAlign = pNew->Task[idx].ResumeAlign;
+            TaskList[idx]->WarmupCycles = pNew->Task[idx].WarmupCycles;
         }
     }
+    while (FALSE);
 
-    /* Evaluate overall error flag */
-    if (Error)
-    {
-        return (ERROR);
-    }
-    else
-    {
-        return (OK);
-    }
+    return (ret);
 }
 
 /**
 ********************************************************************************
-* @brief Starts all tasks which are registered in the global task list
-*        - task watchdog is being created if specified
-*        - priority is being checked and corrected if necessary
-*        - semaphore for cycle timing is being created
-*        - sync session is being started if necessary
-*        - sync ISR is being attached if necessary
-*        If there is an error creating a task, no further tasks will be started.
+* @brief Response time analysis of all tasks in TaskList[].
+*        Called by the validate callback of the configuration, i.e. before
+*        any task is spawned with the new settings.
+*        For each task the worst case response time R is calculated from
+*        - the declared execution time C (key "Wcet")
+*        - the period T: cycle time rounded to ticks or syncs as done
+*          by Task_InitTiming_Tick()/Task_InitTiming_Sync()
+*        - the preemption by all tasks with a higher priority and the
+*          blocking by one task with the same priority
+*        R = C + B + sum(ceil(R / Tj) * Cj) is iterated until it is stable
+*        or exceeds T. Other tasks of the system are not considered.
+*        A task set which is infeasible is rejected.
+*        The measured cycle time (Task_WaitCycle()) is a response time, it
+*        already contains the preemption by all tasks of the system. It is
+*        not used as C but compared with T directly; exceeding T only gives
+*        a warning.
 *
 * @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
+* @retval     < 0 .. ERROR, task set is infeasible
 *******************************************************************************/
-MLOCAL SINT32 Task_CreateAll(void)
+SINT32 git_test_AppSchedCheck(void)
 {
-    UINT32  idx;
-    UINT8   TaskName[M_TSKNAMELEN_A];
+    static const CHAR *pFunc = __func__;
     UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
-    UINT32  TaskOptions;
-    UINT32  wdogtime_us;
-    static const CHAR *pFunc = __FUNCTION__;
+    TASK_CFG TaskCfg[sizeof(TaskList) / sizeof(TASK_PROPERTIES *)];
+    const TASK_CFG *pTaskCfg = TaskCfg;
+    UINT32  Period_us[sizeof(TaskList) / sizeof(TASK_PROPERTIES *)];
+    UINT32  Exec_us[sizeof(TaskList) / sizeof(TASK_PROPERTIES *)];
+    UINT32  Util_ppm = 0;
+    UINT32  Resp_us;
+    UINT32  Next_us;
+    UINT32  Block_us;
+    UINT32  idx;
+    UINT32  j;
+    SINT32  ret = OK;
+
+    /* Settings being validated, otherwise the ones in use */
+    if (pAppCfgStaged)
+    {
+        pTaskCfg = pAppCfgStaged->Task;
+    }
+    else
+    {
+        Task_CfgGet(TaskCfg);
+    }
 
-    /* For all application tasks listed in TaskList */
     for (idx = 0; idx < NbOfTasks; idx++)
     {
-        if (!TaskList[idx])
+        Exec_us[idx] = 0;
+        if (!TaskList[idx] || (Task_Period(&pTaskCfg[idx], &Period_us[idx]) < 0))
         {
-            LOG_E(0, pFunc, "Invalid task properties pointer!");
-            return (ERROR);
+            continue;
         }
 
-        /* Initialize process image */
-        if (git_test_pi_init(&TaskList[idx]->inVars, &TaskList[idx]->outVars) < 0)
+        /* Measured response time of the tasks in use */
+        if (TaskList[idx]->MaxRespTime_us > Period_us[idx])
         {
-            return (ERROR);
+            LOG_W(0, pFunc, "Task '%s' has missed its cycle time: measured response time %d us > %d us",
+                  TaskList[idx]->Name, TaskList[idx]->MaxRespTime_us, Period_us[idx]);
         }
 
-        /* Initialize what is necessary */
-        //TaskList[idx]->SyncSessionId = ERROR;
-        TaskList[idx]->TaskId = ERROR;
-        TaskList[idx]->WdogId = 0;
-        TaskList[idx]->Quit = FALSE;
-
-        /* Create software watchdog if required */
-        if (TaskList[idx]->WDogRatio > 0)
+        Exec_us[idx] = pTaskCfg[idx].Wcet_us;
+        if (!Exec_us[idx])
         {
-            /* check watchdog ratio, minimum useful value is 2 */
-            if (TaskList[idx]->WDogRatio < 3)
-            {
-                TaskList[idx]->WDogRatio = 3;
-                LOG_W(0, pFunc, "Watchdog ratio increased to 3!");
-            }
-
-            wdogtime_us = (UINT32)((TaskList[idx]->pCyclicCfg->CycleTime_ms * 1000) * TaskList[idx]->WDogRatio);
-            TaskList[idx]->WdogId = sys_WdogCreate(git_test_BaseParams.AppName, wdogtime_us);
-            if (TaskList[idx]->WdogId == 0)
-            {
-                LOG_E(0, pFunc, "Could not create watchdog!");
-                return (ERROR);
-            }
+            LOG_I(1, pFunc, "Task '%s': no declared execution time, not analyzed", TaskList[idx]->Name);
+            continue;
         }
 
-        /* Create binary semaphore for cycle timing */
-        TaskList[idx]->CycleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
-        if (!TaskList[idx]->CycleSema)
-        {
-            LOG_E(0, pFunc, "Could not create cycle timing semaphore for task '%s'!",
-                  TaskList[idx]->Name);
-            return (ERROR);
-        }
+        Util_ppm += (UINT32)(((UINT64)Exec_us[idx] * 1000000) / Period_us[idx]);
+    }
+
+    if (Util_ppm > 1000000)
+    {
+        LOG_W(0, pFunc, "Tasks of the module need %d.%d%% of the CPU",
+              Util_ppm / 10000, (Util_ppm / 1000) % 10);
+    }
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!Exec_us[idx])
+        {
+            continue;
+        }
+
+        /* Blocking: a task with the same priority is not preempted */
+        Block_us = 0;
+        for (j = 0; j < NbOfTasks; j++)
+        {
+            if ((j != idx) && Exec_us[j] && (pTaskCfg[j].Priority == pTaskCfg[idx].Priority) &&
+                (Exec_us[j] > Block_us))
+            {
+                Block_us = Exec_us[j];
+            }
+        }
+
+        /* Preemption: lower priority number is higher priority */
+        Resp_us = Exec_us[idx] + Block_us;
+        for (;;)
+        {
+            Next_us = Exec_us[idx] + Block_us;
+            for (j = 0; j < NbOfTasks; j++)
+            {
+                if (Exec_us[j] && (pTaskCfg[j].Priority < pTaskCfg[idx].Priority))
+                {
+                    Next_us += ((Resp_us + Period_us[j] - 1) / Period_us[j]) * Exec_us[j];
+                }
+            }
+
+            if ((Next_us == Resp_us) || (Next_us > Period_us[idx]))
+            {
+                break;
+            }
+            Resp_us = Next_us;
+        }
+        Resp_us = Next_us;
+
+        LOG_I(1, pFunc, "Task '%s': C = %d us, T = %d us, R = %d us", TaskList[idx]->Name,
+              Exec_us[idx], Period_us[idx], Resp_us);
+
+        if (Resp_us <= Period_us[idx])
+        {
+            continue;
+        }
+
+        LOG_E(0, pFunc, "Task '%s' cannot meet its cycle time: response time %d us > %d us",
+              TaskList[idx]->Name, Resp_us, Period_us[idx]);
+        ret = MIO_ER_BADCONF;
+    }
+
+    return (ret);
+}
+
+/**
+********************************************************************************
+* @brief Effective period of a task, rounded to ticks or syncs.
+*
+* @param[in]  pTaskCfg    task settings
+* @param[out] pPeriod_us  period in us
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, task is not cyclic or the CPU has no sync settings
+*******************************************************************************/
+MLOCAL SINT32 Task_Period(const TASK_CFG *pTaskCfg, UINT32 *pPeriod_us)
+{
+    SYS_CPUINFO CpuInfo;
+    UINT32  Unit_us;
+    UINT32  Units;
+
+    if (pTaskCfg->TimeBase == TIME_BASE_CYCLIC)
+    {
+        Unit_us = 1000000 / sysClkRateGet();
+    }
+    else if (pTaskCfg->TimeBase == TIME_BASE_SYNC)
+    {
+        (void)sys_GetCpuInfo(&CpuInfo);
+        if (!CpuInfo.pExtCpuInfo)
+        {
+            /* Not analysed, spawning the task reports the sync configuration */
+            return (ERROR);
+        }
+        Unit_us = CpuInfo.pExtCpuInfo->SyncHigh + CpuInfo.pExtCpuInfo->SyncLow;
+    }
+    else
+    {
+        return (ERROR);
+    }
+
+    if (!Unit_us)
+    {
+        return (ERROR);
+    }
+
+    /* Same rounding as in Task_InitTiming_Tick()/Task_InitTiming_Sync() */
+    Units = (UINT32)(((pTaskCfg->CycleTime_ms * 1000) / Unit_us) + 0.5);
+    if (Units < 1)
+    {
+        Units = 1;
+    }
+
+    *pPeriod_us = Units * Unit_us;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns a staging copy of the settings.
+*        The copies are carved from the arena at the first call and kept,
+*        so reading a new configuration does not allocate.
+*
+* @param[in]  Idx       0 .. new settings, 1 .. settings in use
+*
+* @retval     staging copy, NULL if the arena is exhausted
+*******************************************************************************/
+MLOCAL APP_CFG *App_CfgBuf(UINT32 Idx)
+{
+    if (!pAppCfgBuf[Idx])
+    {
+        pAppCfgBuf[Idx] = git_test_arena_alloc(sizeof(APP_CFG), "configuration");
+    }
+
+    return (pAppCfgBuf[Idx]);
+}
+
+/**
+********************************************************************************
+* @brief Parses the configuration file into a staging copy.
+*        Apart from the CONFIG of the generated code, which is replaced only
+*        if the whole configuration is valid, nothing in use is changed.
+*
+* @param[out] pCfg      parsed settings
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 App_CfgParse(APP_CFG *pCfg)
+{
+    SINT32  ret;
+
+    /* Read the section of the module once, all task settings are taken from it */
+    ret = git_test_cfgidx_load();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /*
+     * Read task configuration settings from configuration file (BaseParam.CfgFileName)
+     * before the component specific configuration, so that they can be
+     * checked by the validate callback.
+     */
+    ret = Task_CfgParse(pCfg->Task);
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Read component specific configuration */
+    pAppCfgStaged = pCfg;
+    ret = git_test_config_read();
+    pAppCfgStaged = NULL;
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Read names of variables of other software modules */
+    ret = git_test_sviclnt_cfgParse(pCfg->SviClntNames);
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Everything is valid: CONFIG of the module can be replaced */
+    git_test_cfgimg_commitConfig();
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Applies parsed settings while no application task is running.
+*
+* @param[in]  pCfg      parsed settings
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 App_CfgApply(APP_CFG *pCfg)
+{
+    CONFIG  *pConfig;
+    UINT32  ConfigSize;
+
+    if (Task_CfgApply(pCfg->Task) < 0)
+    {
+        return (ERROR);
+    }
+
+    pConfig = git_test_cfgimg_getConfig(&ConfigSize);
+    git_test_param_reset(pConfig);
+
+    return (git_test_sviclnt_cfgSet(pCfg->SviClntNames));
+}
+
+/**
+********************************************************************************
+* @brief Takes all settings from the binary configuration image.
+*        Only used if the image matches the configuration file, otherwise
+*        the configuration file has to be parsed.
+*
+* @param[out] pCfg      settings of the image
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, configuration file must be parsed
+*******************************************************************************/
+MLOCAL SINT32 App_CfgImgLoad(APP_CFG *pCfg)
+{
+    CONFIG  *pConfig;
+    CONFIG  NewConfig;
+    UINT32  ConfigSize;
+    SINT32  ret = ERROR;
+
+    pConfig = git_test_cfgimg_getConfig(&ConfigSize);
+    if (!pConfig || (ConfigSize != sizeof(CONFIG)))
+    {
+        return (ERROR);
+    }
+
+    if (git_test_cfgimg_open() < 0)
+    {
+        return (ERROR);
+    }
+
+    /* All sections must be present before anything is taken over */
+    if ((git_test_cfgimg_get(GIT_TEST_CFGIMG_CONFIG, &NewConfig, sizeof(NewConfig)) == OK) &&
+        (git_test_cfgimg_get(GIT_TEST_CFGIMG_TASKS, pCfg->Task, sizeof(pCfg->Task)) == OK) &&
+        (git_test_cfgimg_get(GIT_TEST_CFGIMG_SVICLNT, pCfg->SviClntNames,
+                             sizeof(pCfg->SviClntNames)) == OK))
+    {
+        pAppCfgStaged = pCfg;
+        ret = git_test_config_cbf_validate(&NewConfig);
+        pAppCfgStaged = NULL;
+    }
+
+    git_test_cfgimg_close();
+
+    if (ret == OK)
+    {
+        LOG_I(1, __func__, "Configuration taken from binary image");
+
+        /* Curves and maps are not in the image, they are read from the index at EOI */
+        ret = git_test_cfgidx_load();
+    }
+
+    if (ret == OK)
+    {
+        git_test_cfgimg_commitConfig();
+    }
+
+    return (ret);
+}
+
+/**
+********************************************************************************
+* @brief Writes all parsed settings into the binary configuration image.
+*        An error only costs the fast start, it is not reported to the caller.
+*
+* @param[in]  pCfg      parsed settings
+*******************************************************************************/
+MLOCAL void App_CfgImgSave(const APP_CFG *pCfg)
+{
+    void    *pConfig;
+    UINT32  ConfigSize;
+
+    pConfig = git_test_cfgimg_getConfig(&ConfigSize);
+    if (!pConfig || (ConfigSize != sizeof(CONFIG)))
+    {
+        return;
+    }
+
+    if ((git_test_cfgimg_create() == OK) &&
+        (git_test_cfgimg_add(GIT_TEST_CFGIMG_CONFIG, pConfig, ConfigSize) == OK) &&
+        (git_test_cfgimg_add(GIT_TEST_CFGIMG_TASKS, pCfg->Task, sizeof(pCfg->Task)) == OK) &&
+        (git_test_cfgimg_add(GIT_TEST_CFGIMG_SVICLNT, pCfg->SviClntNames,
+                             sizeof(pCfg->SviClntNames)) == OK))
+    {
+        (void)git_test_cfgimg_write();
+    }
+}
+
+/**
+********************************************************************************
+* @brief Background work of the application.
+*        Called periodically by the bTask, also if no SMI call is received.
+*        Must not block.
+*******************************************************************************/
+void git_test_AppIdle(void)
+{
+    /* Reconnect to restarted software modules */
+    git_test_sviclnt_idle();
+
+    /* Write the messages of the real-time tasks to the system log */
+    git_test_log_drain();
+
+    /* Restart of tasks which have been stopped by an exception */
+    Task_Supervise();
+
+    /* Stack high-water marks */
+    git_test_stack_idle();
+
+    /* Dirty blocks of the retained state to non-volatile memory */
+    git_test_persist_idle();
+}
+
+/**
+********************************************************************************
+* @brief Puts all tasks of TaskList[] and the bTask under stack supervision
+*        and registers their high-water marks at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 App_StackInit(void)
+{
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    CHAR    Name[PF_KEYLEN_A];
+    UINT32  idx;
+
+    git_test_stack_clear();
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            continue;
+        }
+
+        App_TaskVarName(idx, Name, sizeof(Name));
+        (void)git_test_stack_add(Name, &TaskList[idx]->TaskId, &TaskList[idx]->StackSize);
+    }
+
+    (void)git_test_stack_add("bTask", &git_test_bTaskId, &git_test_bTaskStackSize);
+
+    return (git_test_stack_sviServerInit());
+}
+
+/**
+********************************************************************************
+* @brief Name of a task of TaskList[] in SVI variable names.
+*        The task name is not known before the first start, so the
+*        configuration group is used.
+*
+* @param[in]  idx         index in TaskList[]
+* @param[out] pName       name
+* @param[in]  Len         size of pName
+*******************************************************************************/
+MLOCAL void App_TaskVarName(UINT32 idx, CHAR *pName, UINT32 Len)
+{
+    if (strlen(TaskList[idx]->CfgGroup) > 0)
+    {
+        snprintf(pName, Len, "%s", TaskList[idx]->CfgGroup);
+    }
+    else
+    {
+        snprintf(pName, Len, "Task%d", idx + 1);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Registers the restart counters of all tasks of TaskList[]:
+*        "Task/<name>/Restarts", "Task/<name>/LastSignal",
+*        "Task/<name>/RestartTime_us" and "Task/<name>/RestartFails".
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 App_TaskSviInit(void)
+{
+    static const CHAR *pSuffix[APP_TASK_NBOFVARS] = {"Restarts", "LastSignal", "RestartTime_us",
+                                                     "RestartFails"};
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    CHAR    Name[PF_KEYLEN_A];
+    UINT32  NbOfVars = 0;
+    UINT32  idx;
+    UINT32  var;
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            continue;
+        }
+
+        App_TaskVarName(idx, Name, sizeof(Name));
+        for (var = 0; var < APP_TASK_NBOFVARS; var++)
+        {
+            snprintf(AppTaskVarName[NbOfVars], SVI_ADDRLEN, "Task/%s/%s", Name, pSuffix[var]);
+            memset(&AppTaskVarList[NbOfVars], 0, sizeof(SVI_GLOBVAR));
+            AppTaskVarList[NbOfVars].VarName = AppTaskVarName[NbOfVars];
+            AppTaskVarList[NbOfVars].Format = SVI_F_OUT | SVI_F_UINT32;
+            AppTaskVarList[NbOfVars].Size = sizeof(UINT32);
+            AppTaskVarList[NbOfVars].pVar = (var == 0) ? &TaskList[idx]->NbOfRestarts :
+                                            (var == 1) ? &TaskList[idx]->LastExcSignal :
+                                            (var == 2) ? &TaskList[idx]->RestartTime_us :
+                                                         &TaskList[idx]->NbOfRestartFails;
+            NbOfVars++;
+        }
+    }
+
+    return (git_test_AppSviAddGlobVars(AppTaskVarList, NbOfVars));
+}
+
+/**
+********************************************************************************
+* @brief Registers all application specific SVI variables.
+*        Being called at module init by the bTask,
+*        after the SVI server of the module has been initialized.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_AppSviInit(void)
+{
+    SINT32  ret;
+
+    /* All variables are entered into the name index while being registered */
+    git_test_svidx_clear();
+
+    /* Cycle consistent snapshot of the exported values */
+    ret = git_test_snap_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Set values, written by SVI clients via the write queue */
+    ret = git_test_wrq_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Version and recipe of the parameter set in use */
+    ret = git_test_param_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Large blocks, read directly from the published buffer */
+    ret = git_test_blk_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Stack high-water marks of all tasks of the module */
+    ret = App_StackInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Restarts of tasks after exceptions */
+    ret = App_TaskSviInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Replies sent from the pool of reply buffers */
+    ret = git_test_smirpl_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Size and high-water mark of the arena */
+    ret = git_test_arena_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Messages dropped by the deferred logging */
+    ret = git_test_log_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Loaded curves and maps */
+    ret = git_test_lut_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Schedule of the function blocks, enable and timing per block */
+    ret = git_test_fb_sviServerInit(git_test_FbList);
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Transition tables of the state machines, state and time per instance */
+    ret = git_test_sm_sviServerInit(git_test_SmList);
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Warm starts with the retained state */
+    ret = git_test_retain_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Dirty blocks and write times of the retained state */
+    ret = git_test_persist_sviServerInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    LOG_I(1, __func__, "%d SVI variables registered, max. index probe length %d",
+          git_test_svidx_getNbOfVars(), git_test_svidx_getMaxProbe());
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Frees the resources of the application specific SVI variables.
+*        Being called at module deinit by the bTask,
+*        after the SVI server of the module has been deleted.
+*******************************************************************************/
+void git_test_AppSviDeinit(void)
+{
+    git_test_svidx_clear();
+    git_test_wrq_deinit();
+}
+
+/**
+********************************************************************************
+* @brief Registers a list of global variables at the SVI server of the module.
+*        Each variable is registered and entered into the name index
+*        in one single pass. The returned handles are stored in the list.
+*
+* @param[in]  pVarList   list of variables to be registered
+* @param[in]  NbOfVars   number of entries in the list
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_AppSviAddGlobVars(SVI_GLOBVAR *pVarList, UINT32 NbOfVars)
+{
+    UINT32  idx;
+    SINT32  ret;
+    static const CHAR *pFunc = __FUNCTION__;
+
+    for (idx = 0; idx < NbOfVars; idx++)
+    {
+        ret = svi_AddGlobVar(git_test_SviHandle, pVarList[idx].VarName,
+                             pVarList[idx].Format, pVarList[idx].Size,
+                             pVarList[idx].pVar, pVarList[idx].Mode,
+                             pVarList[idx].UserParam, pVarList[idx].pSviStart,
+                             pVarList[idx].pSviEnd);
+        if (ret < 0)
+        {
+            LOG_E(0, pFunc, "Could not add SVI variable '%s'!", pVarList[idx].VarName);
+            return (ERROR);
+        }
+
+        pVarList[idx].VarHandle = ret;
+
+        /* Only registered variables are indexed */
+        if (git_test_svidx_addGlobVar(&pVarList[idx]) < 0)
+        {
+            return (ERROR);
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Registers a list of virtual variables at the SVI server of the module.
+*        Each variable is registered and entered into the name index
+*        in one single pass. The returned handles are stored in the list.
+*
+* @param[in]  pVarList   list of variables to be registered
+* @param[in]  NbOfVars   number of entries in the list
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_AppSviAddVirtVars(SVI_VIRTVAR *pVarList, UINT32 NbOfVars)
+{
+    UINT32  idx;
+    SINT32  ret;
+    static const CHAR *pFunc = __FUNCTION__;
+
+    for (idx = 0; idx < NbOfVars; idx++)
+    {
+        ret = svi_AddVirtVar(git_test_SviHandle, pVarList[idx].VarName,
+                             pVarList[idx].Format, pVarList[idx].Size,
+                             pVarList[idx].ReadFunction, pVarList[idx].Rpar1,
+                             pVarList[idx].Rpar2, pVarList[idx].WriteFunction,
+                             pVarList[idx].Wpar1, pVarList[idx].Wpar2);
+        if (ret < 0)
+        {
+            LOG_E(0, pFunc, "Could not add SVI variable '%s'!", pVarList[idx].VarName);
+            return (ERROR);
+        }
+
+        pVarList[idx].VarHandle = ret;
+
+        /* Only registered variables are indexed */
+        if (git_test_svidx_addVirtVar(&pVarList[idx]) < 0)
+        {
+            return (ERROR);
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads the settings from configuration file mconfig
+*        for all tasks registered in TaskList[].
+*        The task name in TaskList[] is being used as configuration group name.
+*        The initialization values in TaskList[] are being used as default values.
+*        For general configuration data, git_test_CfgParams is being used.
+*        Being called by App_CfgParse.
+*        All parameters are stored in pTaskCfg, the task properties are not
+*        changed, see Task_CfgApply().
+*        All parameters are being treated as optional.
+*        There is no limitation checking of the parameters, the limits are being
+*        specified in the cru and checked by the configurator.
+*
+* @param[out] pTaskCfg  settings, one per entry in TaskList[]
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_CfgParse(TASK_CFG *pTaskCfg)
+{
+    static const CHAR *pFunc = __func__;
+    UINT32  idx;
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    SINT32  ret;
+    CHAR    *group;
+    CHAR    key[PF_KEYLEN_A];
+    CHAR    TmpStrg[32] = {0};
+    UINT32  Error = FALSE;
+    SINT32  TmpVal;
+
+    /* Defaults: initialization values of the task properties */
+    Task_CfgGet(pTaskCfg);
+
+    /* For all application tasks listed in TaskList */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            LOG_E(0, pFunc, "Invalid task properties pointer in task list entry #%d!", idx);
+            Error = TRUE;
+            continue;
+        }
+
+        /* group name is specified in the task properties */
+        group = TaskList[idx]->CfgGroup;
+
+        /* if no group name has been specified: skip configuration reading for this task */
+        if (strlen(group) < 1)
+        {
+            LOG_I(0, pFunc, "Could not find task configuration for task '%s' in mconfig ",
+                  TaskList[idx]->Name);
+            continue;
+        }
+
+        /* First of all, get TaskMode.
+         * TaskMode can be TIME_BASE_CYCLIC, TIME_BASE_SYNC, TIME_BASE_EVENT, TIME_BASE_ERROR
+         */
+        sprintf(key, "TaskMode");
+        (void)git_test_cfgidx_getStrg(group, key, "", TmpStrg, sizeof(TmpStrg));
+
+        /* Using strcmp is safe because string literals are guaranteed null terminated. */
+        if(strcmp(TmpStrg, "Cyclic") == 0)
+        {
+            pTaskCfg[idx].TimeBase = TIME_BASE_CYCLIC;
+        }
+        else if(strcmp(TmpStrg, "Sync") == 0)
+        {
+            pTaskCfg[idx].TimeBase = TIME_BASE_SYNC;
+        }
+        else
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: %s not allowed for '%s'", TmpStrg, key);
+            return MIO_ER_BADCONF;
+        }
+
+        if(pTaskCfg[idx].TimeBase == TIME_BASE_CYCLIC)
+        {
+            sprintf(key, "CycleTime");
+            ret = git_test_cfgidx_getReal(group, key, 0, &pTaskCfg[idx].CycleTime_ms);
+            /* keyword has not been found or is malformed */
+            if (ret < 0)
+            {
+                LOG_W(0, pFunc, "Missing configuration parameter '[%s](%s)%s'",
+                      git_test_BaseParams.AppName, group, key);
+                return MIO_ER_BADCONF;
+            }
+
+        }
+        else
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: TimeBase unknown");
+            return MIO_ER_BADCONF;
+        }
+
+        /*
+         * Declared worst case execution time in us, optional.
+         * Used for the response time analysis, see git_test_AppSchedCheck().
+         */
+        sprintf(key, "Wcet");
+        ret = git_test_cfgidx_getInt(group, key, 0, &TmpVal);
+        if ((ret == MIO_ER_BADCONF) || (TmpVal < 0))
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: %d not allowed for '%s'", TmpVal, key);
+            return MIO_ER_BADCONF;
+        }
+        pTaskCfg[idx].Wcet_us = (UINT32)TmpVal;
+
+        /*
+         * Stack size in bytes, optional.
+         * See "Stack/<group>/Recommended" for a measured value.
+         */
+        sprintf(key, "StackSize");
+        ret = git_test_cfgidx_getInt(group, key, pTaskCfg[idx].StackSize, &TmpVal);
+        if ((ret == MIO_ER_BADCONF) || (TmpVal < GIT_TEST_STACK_MINSIZE))
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: %d not allowed for '%s'", TmpVal, key);
+            return MIO_ER_BADCONF;
+        }
+        pTaskCfg[idx].StackSize = (UINT32)TmpVal;
+
+        /*
+         * Resume from STOP in the common phase of all tasks, optional.
+         * The first cycle after RUN starts at a multiple of the cycle time,
+         * so tasks with harmonic cycle times start together.
+         */
+        sprintf(key, "ResumeAlign");
+        ret = git_test_cfgidx_getInt(group, key, FALSE, &TmpVal);
+        if ((ret == MIO_ER_BADCONF) || (TmpVal < 0) || (TmpVal > 1))
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: %d not allowed for '%s'", TmpVal, key);
+            return MIO_ER_BADCONF;
+        }
+        pTaskCfg[idx].ResumeAlign = (UINT32)TmpVal;
+
+        /*
+         * Dry-run cycles after the task start, optional.
+         * Caches, process image and first calls are warmed up with outputs
+         * suppressed, the first real cycle runs at RUN.
+         */
+        sprintf(key, "WarmupCycles");
+        ret = git_test_cfgidx_getInt(group, key, 0, &TmpVal);
+        if ((ret == MIO_ER_BADCONF) || (TmpVal < 0) || (TmpVal > APP_WARMUP_MAXCYCLES))
+        {
+            LOG_E(0, pFunc, "Bad task-configuration: %d not allowed for '%s'", TmpVal, key);
+            return MIO_ER_BADCONF;
+        }
+        pTaskCfg[idx].WarmupCycles = (UINT32)TmpVal;
+
+        /*
+         * Read the desired value for the task priority.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         * As an additional fall back, the priority in the base parms will be used.
+         */
+        sprintf(key, "Priority");
+        ret = git_test_cfgidx_getInt(group, key, pTaskCfg[idx].Priority, &TmpVal);
+        /* keyword has been found */
+        if (ret >= 0 && TmpVal > 0)
+        {
+            pTaskCfg[idx].Priority = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, pFunc, "Missing configuration parameter '[%s](%s)%s'",
+                  git_test_BaseParams.AppName, group, key);
+            return MIO_ER_BADCONF;
+        }
+    }
+
+    /* Evaluate overall error flag */
+    if (Error)
+    {
+        return (ERROR);
+    }
+    else
+    {
+        return (OK);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the settings of all tasks as currently in use.
+*
+* @param[out] pTaskCfg  settings, one per entry in TaskList[]
+*******************************************************************************/
+MLOCAL void Task_CfgGet(TASK_CFG *pTaskCfg)
+{
+    UINT32  idx;
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+
+    memset(pTaskCfg, 0, NbOfTasks * sizeof(TASK_CFG));
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            continue;
+        }
+
+        pTaskCfg[idx].TimeBase = TaskList[idx]->TimeBase;
+        pTaskCfg[idx].Priority = TaskList[idx]->Priority;
+        pTaskCfg[idx].Wcet_us = TaskList[idx]->Wcet_us;
+        pTaskCfg[idx].StackSize = TaskList[idx]->StackSize;
+        pTaskCfg[idx].ResumeAlign = TaskList[idx]->ResumeAlign;
+        pTaskCfg[idx].WarmupCycles = TaskList[idx]->WarmupCycles;
+        if (TaskList[idx]->pCyclicCfg)
+        {
+            pTaskCfg[idx].CycleTime_ms = TaskList[idx]->pCyclicCfg->CycleTime_ms;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Stores parsed settings in the task properties.
+*        Must only be called while the tasks are not running.
+*
+* @param[in]  pTaskCfg  settings, one per entry in TaskList[]
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_CfgApply(const TASK_CFG *pTaskCfg)
+{
+    UINT32  idx;
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx] || (strlen(TaskList[idx]->CfgGroup) < 1))
+        {
+            continue;
+        }
+
+        TaskList[idx]->TimeBase = pTaskCfg[idx].TimeBase;
+        TaskList[idx]->Priority = pTaskCfg[idx].Priority;
+        TaskList[idx]->Wcet_us = pTaskCfg[idx].Wcet_us;
+        TaskList[idx]->StackSize = pTaskCfg[idx].StackSize;
+        TaskList[idx]->ResumeAlign = pTaskCfg[idx].ResumeAlign;
+        TaskList[idx]->WarmupCycles = pTaskCfg[idx].WarmupCycles;
+        TaskList[idx]->PrevCycleStartTime = 0;
+
+        /* Time base of the control cycle, an event task has the cycle time as estimate */
+        if (Task_Period(&pTaskCfg[idx], &TaskList[idx]->Period_us) < 0)
+        {
+            TaskList[idx]->Period_us = (UINT32)(pTaskCfg[idx].CycleTime_ms * 1000);
+        }
+
+        if (TaskList[idx]->TimeBase == TIME_BASE_CYCLIC)
+        {
+            /* Alloc memory for cyclic configuration, kept until the module is unloaded */
+            if (!TaskList[idx]->pCyclicCfg)
+            {
+                TaskList[idx]->pCyclicCfg = git_test_arena_alloc(sizeof(CYCLIC_CFG), TaskList[idx]->Name);
+                if (!TaskList[idx]->pCyclicCfg)
+                {
+                    return (ERROR);
+                }
+            }
+            memset(TaskList[idx]->pCyclicCfg, 0, sizeof(CYCLIC_CFG));
+            TaskList[idx]->pCyclicCfg->CycleTime_ms = pTaskCfg[idx].CycleTime_ms;
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Starts all tasks which are registered in the global task list
+*        - task watchdog is being created if specified
+*        - priority is being checked and corrected if necessary
+*        - semaphore for cycle timing is being created
+*        - sync session is being started if necessary
+*        - sync ISR is being attached if necessary
+*        If there is an error creating a task, no further tasks will be started.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_CreateAll(void)
+{
+    UINT32  idx;
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    static const CHAR *pFunc = __FUNCTION__;
+
+    /* For all application tasks listed in TaskList */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            LOG_E(0, pFunc, "Invalid task properties pointer!");
+            return (ERROR);
+        }
+
+        if (Task_Create(TaskList[idx], idx) < 0)
+        {
+            return (ERROR);
+        }
+    }
+
+    /* At this point, all tasks have been started successfully */
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Creates one task of the global task list
+*        - process image is being initialized
+*        - watchdog and cycle semaphore are being created
+*        - cycle timing is being initialized
+*        Also used to restart a task after an exception.
+*
+* @param[in]  pTaskData   task properties
+* @param[in]  idx         index in TaskList[]
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_Create(TASK_PROPERTIES *pTaskData, UINT32 idx)
+{
+    UINT8   TaskName[M_TSKNAMELEN_A];
+    UINT32  TaskOptions;
+    static const CHAR *pFunc = __FUNCTION__;
+
+    /* Initialize process image, kept on the restart of the task after an exception */
+    if (!pTaskData->PiInit)
+    {
+        if (git_test_pi_init(&pTaskData->inVars, &pTaskData->outVars) < 0)
+        {
+            return (ERROR);
+        }
+        pTaskData->PiInit = TRUE;
+    }
+
+    /*
+     * Initialize what is necessary
+     * ExcSignal is kept until the task has been spawned, so that
+     * Task_Supervise() retries a restart which has failed.
+     */
+    //pTaskData->SyncSessionId = ERROR;
+    pTaskData->TaskId = ERROR;
+    pTaskData->WdogId = 0;
+    pTaskData->Quit = FALSE;
+    pTaskData->CycleStartTime = 0;
+    pTaskData->WarmupDone = FALSE;
+
+    /* Create software watchdog if required */
+    if (Task_WdogCreate(pTaskData) < 0)
+    {
+        return (ERROR);
+    }
 
-        /* Initialize task cycle timing infrastructure */
-        (void)Task_InitTiming(TaskList[idx]);
+    /* Create binary semaphore for cycle timing */
+    pTaskData->CycleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+    if (!pTaskData->CycleSema)
+    {
+        LOG_E(0, pFunc, "Could not create cycle timing semaphore for task '%s'!",
+              pTaskData->Name);
+        return (ERROR);
+    }
 
-        /* In case the priority has not been properly set */
-        if (TaskList[idx]->Priority == 0)
-        {
-            LOG_E(0, pFunc, "Invalid priority for task '%s'", TaskList[idx]->Name);
-            return (ERROR);
-        }
+    /* Initialize task cycle timing infrastructure */
+    (void)Task_InitTiming(pTaskData);
 
-        /* make sure task name string is terminated */
-        TaskList[idx]->Name[M_TSKNAMELEN] = 0;
+    /* In case the priority has not been properly set */
+    if (pTaskData->Priority == 0)
+    {
+        LOG_E(0, pFunc, "Invalid priority for task '%s'", pTaskData->Name);
+        return (ERROR);
+    }
 
-        /* If no task name has been set: use application name and index */
-        if (strlen(TaskList[idx]->Name) < 1)
-        {
-            sprintf(TaskList[idx]->Name, "a%s_%d", git_test_BaseParams.AppName, idx + 1);
-        }
+    /* make sure task name string is terminated */
+    pTaskData->Name[M_TSKNAMELEN] = 0;
 
-        sprintf(TaskName, "%s", TaskList[idx]->Name);
+    /* If no task name has been set: use application name and index */
+    if (strlen(pTaskData->Name) < 1)
+    {
+        sprintf(pTaskData->Name, "a%s_%d", git_test_BaseParams.AppName, idx + 1);
+    }
 
-        /* Task options */
-        TaskOptions = 0;
-        if (TaskList[idx]->UseFPU)
-        {
-            TaskOptions |= VX_FP_TASK;
-        }
+    sprintf(TaskName, "%s", pTaskData->Name);
 
-        /* Spawn task with properties set in task list */
-        TaskList[idx]->TaskId = sys_TaskSpawn(git_test_BaseParams.AppName, TaskName,
-                                              TaskList[idx]->Priority, TaskOptions,
-                                              TaskList[idx]->StackSize,
-                                              (FUNCPTR)TaskList[idx]->pMainFunc, TaskList[idx]);
+    /* Task options */
+    TaskOptions = 0;
+    if (pTaskData->UseFPU)
+    {
+        TaskOptions |= VX_FP_TASK;
+    }
 
-        /* Check if task has been created successfully */
-        if (TaskList[idx]->TaskId == ERROR)
-        {
-            LOG_E(0, pFunc, "Error in sys_TaskSpawn for task '%s'!", TaskName);
-            return (ERROR);
-        }
+    /* Spawn task with properties set in task list, exceptions are caught by Task_Entry() */
+    pTaskData->TaskId = sys_TaskSpawn(git_test_BaseParams.AppName, TaskName,
+                                      pTaskData->Priority, TaskOptions,
+                                      pTaskData->StackSize,
+                                      (FUNCPTR)Task_Entry, pTaskData);
+
+    /* Check if task has been created successfully */
+    if (pTaskData->TaskId == ERROR)
+    {
+        LOG_E(0, pFunc, "Error in sys_TaskSpawn for task '%s'!", TaskName);
+        return (ERROR);
     }
+    pTaskData->ExcSignal = 0;
 
-    /* At this point, all tasks have been started successfully */
     return (OK);
 }
 
@@ -564,6 +1919,7 @@ MLOCAL void Task_DeleteAll(void)
         if (TaskList[idx]->WdogId)
         {
             sys_WdogDelete(TaskList[idx]->WdogId);
+            TaskList[idx]->WdogId = 0;
         }
     }
 
@@ -606,7 +1962,8 @@ MLOCAL void Task_DeleteAll(void)
         /* Check if all tasks have terminated their cycles */
         for (idx = 0; idx < NbOfTasks; idx++)
         {
-            AllTasksQuitted = AllTasksQuitted && (taskIdVerify(TaskList[idx]->TaskId) == ERROR);
+            AllTasksQuitted = AllTasksQuitted && ((taskIdVerify(TaskList[idx]->TaskId) == ERROR) ||
+                                                  TaskList[idx]->ExcSignal);
         }
 
         /* If all tasks have terminated themselves */
@@ -633,47 +1990,196 @@ MLOCAL void Task_DeleteAll(void)
     /* Cleanup resources and delete all remaining tasks */
     for (idx = 0; idx < NbOfTasks; idx++)
     {
-        if(TaskList[idx]->TimeBase == TIME_BASE_CYCLIC)
+        Task_Release(TaskList[idx]);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Frees the resources of one task and deletes it if it still exists.
+*        Undo for Task_Create(), also used to restart a task after an exception.
+*        The function will not be left upon an error.
+*
+* @param[in]  pTaskData   task properties
+*******************************************************************************/
+MLOCAL void Task_Release(TASK_PROPERTIES *pTaskData)
+{
+    static const CHAR *pFunc = __FUNCTION__;
+
+    /* The task does not trigger its watchdog any more */
+    if (pTaskData->WdogId)
+    {
+        sys_WdogDelete(pTaskData->WdogId);
+        pTaskData->WdogId = 0;
+    }
+
+    if(pTaskData->TimeBase == TIME_BASE_CYCLIC)
+    {
+        /* pCyclicCfg is carved from the arena and reused at the next start */
+    }
+    else if(pTaskData->TimeBase == TIME_BASE_SYNC)
+    {
+//        /* Stop sync session if present and detach ISR */
+//        if (pTaskData->SyncSessionId >= 0)
+//        {
+//            LOG_I(0, pFunc, "Stopping sync session for task %s", pTaskData->Name);
+//            (void)mio_StopSyncSession(pTaskData->SyncSessionId);
+//        }
+    }
+
+    /* Delete semaphore for cycle timing */
+    if (pTaskData->CycleSema)
+    {
+        if (semDelete(pTaskData->CycleSema) < 0)
         {
-            sys_MemXFree(TaskList[idx]->pCyclicCfg);
+            LOG_W(0, pFunc, "Could not delete cycle semaphore of task %s!", pTaskData->Name);
         }
-        else if(TaskList[idx]->TimeBase == TIME_BASE_SYNC)
+        else
         {
-//            /* Stop sync session if present and detach ISR */
-//            if (TaskList[idx]->SyncSessionId >= 0)
-//            {
-//                LOG_I(0, pFunc, "Stopping sync session for task %s", TaskList[idx]->Name);
-//                (void)mio_StopSyncSession(TaskList[idx]->SyncSessionId);
-//            }
+        	pTaskData->CycleSema = 0;
         }
+    }
 
-        /* Delete semaphore for cycle timing */
-        if (TaskList[idx]->CycleSema)
+    /* Remove application task which still exists */
+    if (taskIdVerify(pTaskData->TaskId) == OK)
+    {
+        if (taskDelete(pTaskData->TaskId) == ERROR)
         {
-            if (semDelete(TaskList[idx]->CycleSema) < 0)
-            {
-                LOG_W(0, pFunc, "Could not delete cycle semaphore of task %s!", TaskList[idx]->Name);
-            }
-            else
-            {
-            	TaskList[idx]->CycleSema = 0;
-            }
+            LOG_E(0, pFunc, "Could not delete task %s!", pTaskData->Name);
+        }
+        else if (!pTaskData->ExcSignal)
+        {
+            LOG_W(0, pFunc, "Task %s had to be deleted!", pTaskData->Name);
+        }
+
+        pTaskData->TaskId = ERROR;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Entry function of all tasks of TaskList[].
+*        Installs the exception handler and calls the main function.
+*
+* @param[in]  pTaskData   task properties
+*******************************************************************************/
+MLOCAL void Task_Entry(TASK_PROPERTIES *pTaskData)
+{
+    static const int ExcSignals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE};
+    struct sigaction Action;
+    UINT32  idx;
+
+    memset(&Action, 0, sizeof(Action));
+    Action.sa_handler = Task_ExcHandler;
+    (void)sigemptyset(&Action.sa_mask);
+
+    for (idx = 0; idx < sizeof(ExcSignals) / sizeof(ExcSignals[0]); idx++)
+    {
+        if (sigaction(ExcSignals[idx], &Action, NULL) < 0)
+        {
+            LOG_W(0, __func__, "Exception handler for signal %d not installed in task '%s'",
+                  ExcSignals[idx], pTaskData->Name);
         }
+    }
+
+    pTaskData->pMainFunc(pTaskData);
+}
+
+/**
+********************************************************************************
+* @brief Exception handler of the tasks of TaskList[].
+*        Runs in the context of the faulting task. The task is marked and
+*        suspends itself, it is restarted by the bTask in Task_Supervise().
+*        Nothing else of the module is affected.
+*
+* @param[in]  Signal      signal of the exception
+*******************************************************************************/
+MLOCAL void Task_ExcHandler(int Signal)
+{
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    SINT32  TaskId = taskIdSelf();
+    UINT32  idx;
 
-        /* Remove application tasks which still exist */
-        if (taskIdVerify(TaskList[idx]->TaskId) == OK)
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (TaskList[idx] && (TaskList[idx]->TaskId == TaskId))
         {
-            if (taskDelete(TaskList[idx]->TaskId) == ERROR)
-            {
-                LOG_E(0, pFunc, "Could not delete task %s!", TaskList[idx]->Name);
-            }
-            else
-            {
-                LOG_W(0, pFunc, "Task %s had to be deleted!", TaskList[idx]->Name);
-            }
+            TaskList[idx]->FaultTime = m_GetProcTime();
+            GIT_TEST_MEMBARRIER();
+            TaskList[idx]->ExcSignal = Signal;
+            break;
+        }
+    }
+
+    /* Returning would repeat the faulting instruction */
+    for (;;)
+    {
+        (void)taskSuspend(0);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Restarts the tasks which have been stopped by an exception.
+*        Called periodically by the bTask in the idle hook.
+*        Only the faulting task is deleted and created again, with new
+*        watchdog, cycle semaphore and cycle timing. The process image is
+*        shared by all tasks, it is kept.
+*        A task is restarted at most every APP_RESTART_HOLDOFF ms. A failed
+*        restart is counted separately and tried again after the same time.
+*******************************************************************************/
+MLOCAL void Task_Supervise(void)
+{
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    UINT32  HoldOff = (APP_RESTART_HOLDOFF * sysClkRateGet()) / 1000;
+    TASK_PROPERTIES *pTaskData;
+    UINT32  idx;
+    static const CHAR *pFunc = __FUNCTION__;
+
+    if (!AppRunning)
+    {
+        return;
+    }
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        pTaskData = TaskList[idx];
+        if (!pTaskData || !pTaskData->ExcSignal)
+        {
+            continue;
+        }
+
+        if ((pTaskData->NbOfRestarts || pTaskData->NbOfRestartFails) &&
+            ((tickGet() - pTaskData->AttemptTick) < HoldOff))
+        {
+            continue;
+        }
+        pTaskData->AttemptTick = tickGet();
+
+        LOG_E(0, pFunc, "Task '%s' stopped on signal %d, restarting",
+              pTaskData->Name, pTaskData->ExcSignal);
+        pTaskData->LastExcSignal = pTaskData->ExcSignal;
 
-            TaskList[idx]->TaskId = ERROR;
+        Task_Release(pTaskData);
+
+        /* The control task continues with its last complete cycle */
+        if (pTaskData->pMainFunc == (VOIDFUNCPTR)Control_Main)
+        {
+            (void)git_test_retain_restore();
+            git_test_snap_reset();
+        }
+
+        if (Task_Create(pTaskData, idx) < 0)
+        {
+            pTaskData->NbOfRestartFails++;
+            LOG_E(0, pFunc, "Restart of task '%s' failed (%d times), retrying",
+                  pTaskData->Name, pTaskData->NbOfRestartFails);
+            continue;
         }
+
+        pTaskData->NbOfRestarts++;
+        pTaskData->RestartTime_us = m_GetProcTime() - pTaskData->FaultTime;
+        pTaskData->RestartTick = tickGet();
     }
 }
 
@@ -796,7 +2302,8 @@ MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES *pTaskData)
     (void)sys_GetCpuInfo(&CpuInfo);
 
     /* Calculate and check period time of sync timer */
-    SyncCycle_us = CpuInfo.pExtCpuInfo->SyncHigh + CpuInfo.pExtCpuInfo->SyncLow;
+    SyncCycle_us = CpuInfo.pExtCpuInfo ?
+        CpuInfo.pExtCpuInfo->SyncHigh + CpuInfo.pExtCpuInfo->SyncLow : 0;
     if ((SyncCycle_us == 0) || (CpuInfo.pExtCpuInfo->SyncHigh == 0)
         || (CpuInfo.pExtCpuInfo->SyncLow == 0))
     {
@@ -876,6 +2383,7 @@ MLOCAL void Task_WaitCycle(TASK_PROPERTIES *pTaskData)
     SINT32  TimeToWait = 0;
     UINT32  SkipNow = 0;
     UINT32  TimeNow = 0;
+    UINT32  RespTime;
     UINT32  Backlog = 0;
     UINT32  MaxBacklog = 0;
     UINT32  CyclesSkipped = 0;
@@ -888,6 +2396,16 @@ MLOCAL void Task_WaitCycle(TASK_PROPERTIES *pTaskData)
         return;
     }
 
+    /* Response time of the cycle which has just been completed, incl. preemption */
+    if (pTaskData->CycleStartTime)
+    {
+        RespTime = m_GetProcTime() - pTaskData->CycleStartTime;
+        if (RespTime > pTaskData->MaxRespTime_us)
+        {
+            pTaskData->MaxRespTime_us = RespTime;
+        }
+    }
+
     /* Trigger software watchdog if existing */
     if (pTaskData->WdogId)
     {
@@ -1016,6 +2534,20 @@ MLOCAL void Task_WaitCycle(TASK_PROPERTIES *pTaskData)
      * If the software module receives the RpcStart call,
      * it will give the state semaphore, and all tasks will continue.
      */
+    Task_WaitRun(pTaskData);
+
+    /* Start of the next cycle, a stop is not part of the execution time */
+    pTaskData->CycleStartTime = m_GetProcTime();
+}
+
+/**
+********************************************************************************
+* @brief Stops a task as long as the module is not in RUN state.
+*
+* @param[in]  pTaskData   task properties
+*******************************************************************************/
+MLOCAL void Task_WaitRun(TASK_PROPERTIES *pTaskData)
+{
     if ((git_test_ModState != RES_S_RUN) && !pTaskData->Quit)
     {
         /* Disable software watchdog if present */
@@ -1029,6 +2561,162 @@ MLOCAL void Task_WaitCycle(TASK_PROPERTIES *pTaskData)
          * RpcStart or RpcEndOfInit
          */
         (void)semTake(git_test_StateSema, WAIT_FOREVER);
+
+        /* New cycle grid, the stop is no backlog */
+        Task_Resume(pTaskData);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Waits until all tasks have finished their warm-up cycles.
+*        Called by the bTask at EOI, so RUN is not set during the warm-up.
+*        Tasks without "WarmupCycles" are done immediately.
+*******************************************************************************/
+MLOCAL void Task_WaitWarmup(void)
+{
+    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
+    UINT32  RequestTime = m_GetProcTime();
+    UINT32  AllDone;
+    UINT32  idx;
+
+    for (;;)
+    {
+        AllDone = TRUE;
+        for (idx = 0; idx < NbOfTasks; idx++)
+        {
+            AllDone = AllDone && (TaskList[idx]->WarmupDone || TaskList[idx]->ExcSignal);
+        }
+
+        if (AllDone)
+        {
+            break;
+        }
+        if ((m_GetProcTime() - RequestTime) > (APP_WARMUP_TIMEOUT * 1000))
+        {
+            LOG_W(0, __func__, "Timeout at waiting for the warm-up of the tasks");
+            break;
+        }
+
+        (void)taskDelay(1);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Creates the software watchdog of a task, if required.
+*
+* @param[in]  pTaskData   task properties
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_WdogCreate(TASK_PROPERTIES *pTaskData)
+{
+    UINT32  wdogtime_us;
+    static const CHAR *pFunc = __FUNCTION__;
+
+    if (pTaskData->WDogRatio == 0)
+    {
+        return (OK);
+    }
+
+    /* check watchdog ratio, minimum useful value is 2 */
+    if (pTaskData->WDogRatio < 3)
+    {
+        pTaskData->WDogRatio = 3;
+        LOG_W(0, pFunc, "Watchdog ratio increased to 3!");
+    }
+
+    wdogtime_us = (UINT32)((pTaskData->pCyclicCfg->CycleTime_ms * 1000) * pTaskData->WDogRatio);
+    pTaskData->WdogId = sys_WdogCreate(git_test_BaseParams.AppName, wdogtime_us);
+    if (pTaskData->WdogId == 0)
+    {
+        LOG_E(0, pFunc, "Could not create watchdog!");
+        return (ERROR);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Sets the time of the first cycle after the module has been set to RUN.
+*        Called by the bTask in RpcRun and RpcEndOfInit, before the stopped
+*        tasks are released. All tasks re-anchor their cycle grid to it.
+*******************************************************************************/
+void git_test_AppResume(void)
+{
+    AppResumeTick = tickGet() + 1;
+}
+
+/**
+********************************************************************************
+* @brief Resumes a task which has been stopped in Task_WaitCycle().
+*        The cycle grid of before the stop would be far in the past, the
+*        task would catch up or skip many cycles. So the grid is re-anchored
+*        at the time set by git_test_AppResume(), with "ResumeAlign" to the
+*        next multiple of the cycle time (common phase of all tasks).
+*        The watchdog, disabled while stopped, is kept and re-armed by the
+*        task itself when it is released.
+*
+* @param[in]  pTaskData   task properties
+*******************************************************************************/
+MLOCAL void Task_Resume(TASK_PROPERTIES *pTaskData)
+{
+    UINT32  Anchor = AppResumeTick;
+    UINT32  CycleTime;
+    UINT32  Phase;
+    SINT32  TimeToWait;
+
+    /* The stop is no cycle, the time base starts again */
+    pTaskData->PrevCycleStartTime = 0;
+
+    if (pTaskData->Quit)
+    {
+        return;
+    }
+
+    if (pTaskData->TimeBase == TIME_BASE_CYCLIC)
+    {
+        CycleTime = pTaskData->pCyclicCfg->CycleTime;
+
+        /* Woken up after the common start, e.g. by a higher priority task */
+        if ((SINT32)(Anchor - tickGet()) <= 0)
+        {
+            Anchor = tickGet() + 1;
+        }
+        /* Unsigned arithmetic, also correct across the wrap-around of tickGet() */
+        Phase = Anchor % CycleTime;
+        if (pTaskData->ResumeAlign && Phase)
+        {
+            Anchor += CycleTime - Phase;
+        }
+
+        TimeToWait = (SINT32)(Anchor - tickGet());
+        if (TimeToWait > 0)
+        {
+            (void)semTake(pTaskData->CycleSema, TimeToWait);
+        }
+
+        pTaskData->pCyclicCfg->PrevCycleStart = Anchor;
+        pTaskData->pCyclicCfg->NextCycleStart = Anchor;
+    }
+    else if (pTaskData->TimeBase == TIME_BASE_SYNC)
+    {
+        /* Discard a sync given while stopped, start with the next one */
+        (void)semTake(pTaskData->CycleSema, NO_WAIT);
+        (void)semTake(pTaskData->CycleSema, WAIT_FOREVER);
+    }
+    else
+    {
+        /* No change */
+    }
+
+    /* Re-arms the watchdog disabled in Task_WaitRun() */
+    if (pTaskData->WdogId)
+    {
+        (void)sys_WdogTrigg(pTaskData->WdogId);
     }
 }
 
@@ -1062,6 +2750,13 @@ SINT32 git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId)
      */
     switch (pMsg->ProcRetCode)
     {
+        case GIT_TEST_PROC_RECIPESET:
+            SmiReplyFunc = Smi_RecipeSet;
+            break;
+
+        case GIT_TEST_PROC_RECIPESELECT:
+            SmiReplyFunc = Smi_RecipeSelect;
+            break;
 
         default:
             /* Unknown message */
@@ -1085,7 +2780,7 @@ SINT32 git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId)
     CallDataOk = (SmiReplyFunc(&SmiSrvReply) == OK);
 
     /* Init SMI reply data and send immediate reply in case of error */
-    pReply = smi_MemAlloc(SmiSrvReply.ReplySize);
+    pReply = git_test_smirpl_get(SmiSrvReply.ReplySize);
     if (pReply)
     {
         /* Copy content set by individual reply function to final reply data */
@@ -1097,12 +2792,8 @@ SINT32 git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId)
     else
     {
         /* Serious error, unconditional log message and according reply */
-        LOG_E(0, "git_test_AppSmiSvr", "Not enough memory for SMI reply!");
+        git_test_smirpl_sendNoMem(pMsg, "git_test_AppSmiSvr");
 
-        if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_ARGS, 0, 0) == ERROR)
-        {
-            LOG_E(0, "git_test_AppSmiSvr", "smi_SendReply failed!");
-        }
         /* Message has been processed even though there was an error */
         return (OK);
     }
@@ -1123,7 +2814,7 @@ SINT32 git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId)
     smi_FreeData(pMsg);
 
     /* Send SMI reply */
-    RetVal = smi_SendReply(git_test_pSmiId, pMsg, SMI_E_OK, pReply, SmiSrvReply.ReplySize);
+    RetVal = git_test_smirpl_send(pMsg, SMI_E_OK, pReply, SmiSrvReply.ReplySize);
 
     if (RetVal == ERROR)
     {
@@ -1138,51 +2829,63 @@ SINT32 git_test_AppSmiSvr(SMI_MSG *pMsg, UINT32 SessionId)
     return (OK);
 }
 
-
-
-
 /**
 ********************************************************************************
-* @brief This function demonstrates the implementation of an SVI client.
-*        It will connect to the server of another software module (RES)
-*        and will get the address of one SVI variable. The variable is
-*        accessed in AppMain(void)
+* @brief Reply function of the SMI call GIT_TEST_PROC_RECIPESET.
+*        Stores a recipe, the parameter set in use is not changed.
+*
+* @param[in,out]  pSmiSrvReply  call and reply data
 *
 * @retval     = 0 .. OK
 * @retval     < 0 .. ERROR
 *******************************************************************************/
-MLOCAL SINT32 SviClnt_Init(void)
+MLOCAL SINT32 Smi_RecipeSet(APP_SMI_R *pSmiSrvReply)
 {
-    /* Get library pointer to access SVI server of other software module. */
-    pSviLib = svi_GetLib("RES");
-    if (!pSviLib)
+    GIT_TEST_RECIPESET_C *pCall = (GIT_TEST_RECIPESET_C *)pSmiSrvReply->pMsg->Data;
+
+    pSmiSrvReply->ReplySize = sizeof(GIT_TEST_RECIPESET_R);
+
+    /* Header and all Len data bytes must have been received */
+    if ((pSmiSrvReply->pMsg->DataLen < offsetof(GIT_TEST_RECIPESET_C, Data)) ||
+        (pCall->Len > sizeof(pCall->Data)) ||
+        (pSmiSrvReply->pMsg->DataLen < offsetof(GIT_TEST_RECIPESET_C, Data) + pCall->Len))
     {
-        LOG_W(0, __func__, "Could not get SVI of module 'RES'!");
         return (ERROR);
     }
 
-
-    return (OK);
+    return (git_test_param_recipeSet(pCall->Recipe, pCall->Data, pCall->Len));
 }
 
 /**
 ********************************************************************************
-* @brief This function informs the RES that the function library of
-*        the server (in this example the server is also RES) is no
-*        longer required
+* @brief Reply function of the SMI call GIT_TEST_PROC_RECIPESELECT.
+*        Publishes a stored recipe, the control task uses all of its values
+*        from the next cycle on.
+*
+* @param[in,out]  pSmiSrvReply  call and reply data
 *
 * @retval     = 0 .. OK
 * @retval     < 0 .. ERROR
 *******************************************************************************/
-MLOCAL void SviClnt_Deinit(void)
+MLOCAL SINT32 Smi_RecipeSelect(APP_SMI_R *pSmiSrvReply)
 {
-    if (pSviLib)
+    GIT_TEST_RECIPESELECT_C *pCall = (GIT_TEST_RECIPESELECT_C *)pSmiSrvReply->pMsg->Data;
+    GIT_TEST_RECIPESELECT_R *pReply = (GIT_TEST_RECIPESELECT_R *)pSmiSrvReply->SmiReplyData;
+    SINT32  Version;
+
+    pSmiSrvReply->ReplySize = sizeof(GIT_TEST_RECIPESELECT_R);
+
+    if (pSmiSrvReply->pMsg->DataLen < sizeof(*pCall))
     {
-        if (svi_UngetLib(pSviLib) < 0)
-        {
-            LOG_E(0, "__func__", "svi_UngetLib Error!");
-        }
-        pSviLib = NULL;
+        return (ERROR);
+    }
+
+    Version = git_test_param_recipeSelect(pCall->Recipe);
+    if (Version < 0)
+    {
+        return (ERROR);
     }
 
+    pReply->Version = (UINT32)Version;
+    return (OK);
 }
@@ -0,0 +1,295 @@
+/**
+********************************************************************************
+* @file     git_test_arena.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the memory arena of the module.
+*
+*           The arena is allocated once at BaseInit with the size of the
+*           key "ArenaSize" in group "Memory" of the module section.
+*           All later allocations of the module are carved from it:
+*           - git_test_arena_alloc() for blocks which are kept until the
+*             module is unloaded (bump allocator)
+*           - git_test_arena_poolCreate() for pools of fixed size blocks
+*             which are taken and returned at runtime
+*           So the memory use of the module is fixed after init and there
+*           are no heap calls in steady state.
+*           Exception: the names and states of the channels returned by the
+*           generated git_test_pi_getMapInfo()/git_test_direct_getMapInfo()
+*           are allocated by the generated code and freed by
+*           RpcGetMapInfoLst(). This only happens on a request of a tool,
+*           not in the cycle.
+*           The used size and its high-water mark are exported via SVI.
+*           For the high-water mark, pools only count with the maximum
+*           number of blocks used at the same time, so it shows how far
+*           "ArenaSize" and the pool sizes can be reduced.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+#include <mio_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_cfgidx.h"
+#include "git_test_arena.h"
+
+/* Global variables: arena */
+MLOCAL UINT8 *pArenaBase = NULL;
+MLOCAL UINT32 ArenaSize = 0;            /* size of the arena in bytes */
+MLOCAL UINT32 ArenaUsed = 0;            /* bytes carved by git_test_arena_alloc() */
+MLOCAL UINT32 ArenaHighWater = 0;       /* ArenaUsed with pools counted by their peak use */
+MLOCAL UINT32 ArenaPoolSize = 0;        /* bytes carved for pools */
+MLOCAL UINT32 ArenaPoolPeak = 0;        /* bytes of pool blocks at their peak use */
+MLOCAL UINT32 ArenaFailed = 0;          /* number of failed allocations */
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR ArenaVarList[] = {
+    {"Arena/Size", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &ArenaSize, 0, 0, NULL, NULL, 0, NULL},
+    {"Arena/Used", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &ArenaUsed, 0, 0, NULL, NULL, 0, NULL},
+    {"Arena/HighWater", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &ArenaHighWater, 0, 0, NULL, NULL, 0, NULL},
+    {"Arena/Failed", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &ArenaFailed, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Allocates the arena.
+*        Being called at BaseInit by the bTask, before the configuration
+*        is read.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_arena_init(void)
+{
+    static const CHAR *pFunc = __func__;
+    SINT32  Size;
+
+    if (git_test_cfgidx_getInt("Memory", "ArenaSize", GIT_TEST_ARENA_DEFSIZE, &Size)
+        == MIO_ER_BADCONF)
+    {
+        return (MIO_ER_BADCONF);
+    }
+
+    if (Size < GIT_TEST_ARENA_ALIGN)
+    {
+        LOG_E(0, pFunc, "Bad configuration: ArenaSize %d too small", Size);
+        return (MIO_ER_BADCONF);
+    }
+
+    pArenaBase = sys_MemXAlloc((UINT32)Size);
+    if (!pArenaBase)
+    {
+        LOG_E(0, pFunc, "Could not allocate arena of %d bytes!", Size);
+        return (ERROR);
+    }
+
+    ArenaSize = (UINT32)Size;
+    ArenaUsed = 0;
+    ArenaPoolSize = 0;
+    ArenaPoolPeak = 0;
+    ArenaHighWater = 0;
+    LOG_I(1, pFunc, "Arena of %d bytes allocated", Size);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Frees the arena.
+*        Being called at BaseDeinit by the bTask, after all users are gone.
+*******************************************************************************/
+void git_test_arena_deinit(void)
+{
+    if (pArenaBase)
+    {
+        sys_MemXFree(pArenaBase);
+        pArenaBase = NULL;
+    }
+
+    ArenaSize = 0;
+    ArenaUsed = 0;
+    ArenaPoolSize = 0;
+    ArenaPoolPeak = 0;
+}
+
+/**
+********************************************************************************
+* @brief Carves a block from the arena, which is never freed.
+*        Only to be called by the bTask.
+*
+* @param[in]  Size        size in bytes
+* @param[in]  pName       usage of the block for messages
+*
+* @retval     block, filled with 0, NULL if the arena is exhausted
+*******************************************************************************/
+void *git_test_arena_alloc(UINT32 Size, const CHAR *pName)
+{
+    UINT8  *pBlk;
+
+    Size = (Size + GIT_TEST_ARENA_ALIGN - 1) & ~(GIT_TEST_ARENA_ALIGN - 1);
+    if (!pArenaBase || (Size > (ArenaSize - ArenaUsed)))
+    {
+        ArenaFailed++;
+        LOG_E(0, __func__, "Arena exhausted: %d bytes for %s, %d of %d bytes used",
+              Size, pName, ArenaUsed, ArenaSize);
+        return (NULL);
+    }
+
+    pBlk = pArenaBase + ArenaUsed;
+    ArenaUsed += Size;
+    ArenaHighWater = ArenaUsed - ArenaPoolSize + ArenaPoolPeak;
+
+    memset(pBlk, 0, Size);
+    return (pBlk);
+}
+
+/**
+********************************************************************************
+* @brief Carves a pool of fixed size blocks from the arena.
+*        Only to be called by the bTask.
+*
+* @param[out] pPool       pool administration
+* @param[in]  pName       usage of the pool for messages
+* @param[in]  BlkSize     size of one block in bytes
+* @param[in]  NbOfBlks    number of blocks
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, arena exhausted
+*******************************************************************************/
+SINT32 git_test_arena_poolCreate(GIT_TEST_ARENA_POOL *pPool, const CHAR *pName,
+                                 UINT32 BlkSize, UINT32 NbOfBlks)
+{
+    UINT8  *pBlks;
+    UINT32  idx;
+
+    memset(pPool, 0, sizeof(*pPool));
+    pPool->pName = pName;
+
+    /* Each free block holds the pointer to the next one */
+    if (BlkSize < sizeof(void *))
+    {
+        BlkSize = sizeof(void *);
+    }
+    BlkSize = (BlkSize + GIT_TEST_ARENA_ALIGN - 1) & ~(GIT_TEST_ARENA_ALIGN - 1);
+
+    pBlks = git_test_arena_alloc(BlkSize * NbOfBlks, pName);
+    if (!pBlks)
+    {
+        return (ERROR);
+    }
+
+    /* Only the blocks in use count for the high-water mark */
+    ArenaPoolSize += BlkSize * NbOfBlks;
+    ArenaHighWater = ArenaUsed - ArenaPoolSize + ArenaPoolPeak;
+
+    pPool->BlkSize = BlkSize;
+    pPool->NbOfBlks = NbOfBlks;
+    for (idx = NbOfBlks; idx > 0; idx--)
+    {
+        *(void **)(pBlks + (idx - 1) * BlkSize) = pPool->pFree;
+        pPool->pFree = pBlks + (idx - 1) * BlkSize;
+    }
+    pPool->pBase = pBlks;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Takes a block from a pool.
+*
+* @param[in]  pPool       pool
+*
+* @retval     block, NULL if all blocks are in use
+*******************************************************************************/
+void *git_test_arena_poolGet(GIT_TEST_ARENA_POOL *pPool)
+{
+    void   *pBlk = pPool->pFree;
+
+    if (!pBlk)
+    {
+        return (NULL);
+    }
+
+    pPool->pFree = *(void **)pBlk;
+    pPool->NbUsed++;
+    if (pPool->NbUsed > pPool->MaxUsed)
+    {
+        pPool->MaxUsed = pPool->NbUsed;
+        ArenaPoolPeak += pPool->BlkSize;
+        ArenaHighWater = ArenaUsed - ArenaPoolSize + ArenaPoolPeak;
+    }
+
+    return (pBlk);
+}
+
+/**
+********************************************************************************
+* @brief Returns a block to its pool.
+*
+* @param[in]  pPool       pool the block has been taken from
+* @param[in]  pBlk        block, NULL is ignored
+*******************************************************************************/
+void git_test_arena_poolPut(GIT_TEST_ARENA_POOL *pPool, void *pBlk)
+{
+    if (!pBlk)
+    {
+        return;
+    }
+
+    *(void **)pBlk = pPool->pFree;
+    pPool->pFree = pBlk;
+    pPool->NbUsed--;
+}
+
+/**
+********************************************************************************
+* @brief Checks if a block belongs to a pool.
+*
+* @param[in]  pPool       pool
+* @param[in]  pBlk        block
+*
+* @retval     TRUE .. block has been taken from the pool
+* @retval     FALSE .. block is from somewhere else
+*******************************************************************************/
+UINT32 git_test_arena_poolOwns(const GIT_TEST_ARENA_POOL *pPool, const void *pBlk)
+{
+    const UINT8 *p = pBlk;
+
+    if (!pPool->pBase || (p < pPool->pBase) ||
+        (p >= (pPool->pBase + (pPool->BlkSize * pPool->NbOfBlks))))
+    {
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_arena_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(ArenaVarList,
+                                       sizeof(ArenaVarList) / sizeof(SVI_GLOBVAR)));
+}
@@ -0,0 +1,52 @@
+/**
+********************************************************************************
+* @file     git_test_arena.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the memory arena of the
+*           module.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_ARENA__H
+#define GIT_TEST_ARENA__H
+
+/* Defines: arena */
+#define GIT_TEST_ARENA_DEFSIZE  (64 * 1024) /* size if not configured ("Memory", "ArenaSize") */
+#define GIT_TEST_ARENA_ALIGN    8       /* alignment of all blocks */
+
+/* Pool of fixed size blocks, carved from the arena */
+typedef struct GIT_TEST_ARENA_POOL
+{
+    const CHAR *pName;                  /* name for messages */
+    UINT32  BlkSize;                    /* size of one block in bytes */
+    UINT32  NbOfBlks;                   /* number of blocks */
+    UINT8   *pBase;                     /* first block */
+    void    *pFree;                     /* list of free blocks */
+    UINT32  NbUsed;                     /* blocks in use */
+    UINT32  MaxUsed;                    /* high-water mark of NbUsed */
+} GIT_TEST_ARENA_POOL;
+
+/*--- Functions ---*/
+
+/* bTask: allocate the arena at BaseInit, size from mconfig; free it at BaseDeinit */
+extern SINT32 git_test_arena_init(void);
+extern void git_test_arena_deinit(void);
+
+/* bTask: block which is never freed, NULL if the arena is exhausted */
+extern void *git_test_arena_alloc(UINT32 Size, const CHAR *pName);
+
+/* bTask: pool of fixed size blocks, get and put are not task safe */
+extern SINT32 git_test_arena_poolCreate(GIT_TEST_ARENA_POOL *pPool, const CHAR *pName,
+                                        UINT32 BlkSize, UINT32 NbOfBlks);
+extern void *git_test_arena_poolGet(GIT_TEST_ARENA_POOL *pPool);
+extern void git_test_arena_poolPut(GIT_TEST_ARENA_POOL *pPool, void *pBlk);
+extern UINT32 git_test_arena_poolOwns(const GIT_TEST_ARENA_POOL *pPool, const void *pBlk);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_arena_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
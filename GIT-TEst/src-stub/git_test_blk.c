@@ -0,0 +1,338 @@
+/**
+********************************************************************************
+* @file     git_test_blk.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the export of large data blocks via SVI.
+*
+*           Each block has three buffers:
+*           - the published buffer, which is read by SVI clients
+*           - the pinned buffer, which is held by a running SVI call
+*             (normally the same as the published buffer)
+*           - the write buffer, which is filled by the writer
+*           The writer fills the write buffer and publishes it with
+*           git_test_blk_swap(). The next write buffer is one which is
+*           neither published nor pinned, so the writer never has to wait
+*           for a transfer.
+*
+*           Each block is exported as one virtual variable with the full
+*           length and as page variables "<name>/P<n>" of
+*           GIT_TEST_BLK_PAGESIZE bytes, so that clients can read any range
+*           of the block with GETBLK/GETMULTIBLK on the pages.
+*           The bTask pins all blocks for the duration of an SVI read call,
+*           so all pages of one GETMULTIBLK belong to the same buffer.
+*           The read function copies directly from the pinned buffer into
+*           the reply buffer of the SVI server, there is no intermediate
+*           copy in the module.
+*           Additionally "<name>/Seq" counts the published buffers.
+*           The control task writes Blk/Wave at each cycle end, see
+*           Control_Record() in git_test_app.c.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_blk.h"
+#include "git_test_retain.h"
+
+/* Defines: buffer administration */
+#define BLK_NBOFBUFS    3               /* published, pinned and write buffer */
+#define BLK_NONE        BLK_NBOFBUFS    /* no buffer pinned */
+#define BLK_MAXPAGES    64              /* total number of page variables */
+#define BLK_NAMELEN     SVI_ADDRLEN     /* maximum length of a variable name */
+
+/* Settings and state of an exported block */
+typedef struct BLK_DESC
+{
+    CHAR    *VarName;                   /* visible name of the block variable */
+    UINT32  Format;                     /* SVI format of one element */
+    UINT32  Size;                       /* size of one buffer in bytes */
+    UINT8   *pBufs;                     /* BLK_NBOFBUFS buffers of Size bytes */
+    volatile UINT32 Pub;                /* index of published buffer */
+    volatile UINT32 Pin;                /* index of pinned buffer or BLK_NONE */
+    UINT32  Write;                      /* index of write buffer */
+    UINT32  Seq;                        /* number of published buffers */
+} BLK_DESC;
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 Blk_SviRead(UINT32 Handle, UINT32 Offset, void *pBuff, UINT32 *pBuffLen);
+MLOCAL UINT32 Blk_PinOne(BLK_DESC *pBlk);
+
+/* Global variables: buffers of the blocks */
+MLOCAL REAL32 BlkWaveBufs[BLK_NBOFBUFS][GIT_TEST_BLK_WAVE_LEN];
+
+/*
+ * Global variables: List of all exported blocks
+ * The order must match the handles GIT_TEST_BLK_... in git_test_blk.h
+ */
+MLOCAL BLK_DESC BlkList[GIT_TEST_BLK_NB] = {
+    {"Blk/Wave", SVI_F_REAL32, sizeof(BlkWaveBufs[0]), (UINT8 *)BlkWaveBufs}
+};
+
+/* Global variables: SVI variables of the blocks */
+MLOCAL SVI_VIRTVAR BlkVarList[GIT_TEST_BLK_NB + BLK_MAXPAGES];
+MLOCAL SVI_GLOBVAR BlkSeqList[GIT_TEST_BLK_NB];
+MLOCAL CHAR BlkNames[GIT_TEST_BLK_NB + BLK_MAXPAGES][BLK_NAMELEN];
+MLOCAL UINT32 BlkPinnedByCall = FALSE;  /* blocks are pinned by the bTask */
+MLOCAL UINT32 BlkInitDone = FALSE;      /* buffers have been initialized after module load */
+
+/**
+********************************************************************************
+* @brief Returns the buffer which is to be filled by the writer.
+*        The content is not visible for SVI clients until
+*        git_test_blk_swap() is called.
+*        There must only be one writer per block.
+*
+* @param[in]  Handle   handle of the block, GIT_TEST_BLK_...
+*
+* @retval     pointer to the write buffer
+*******************************************************************************/
+void *git_test_blk_writeBuf(UINT32 Handle)
+{
+    BLK_DESC *pBlk = &BlkList[Handle];
+
+    return (pBlk->pBufs + (pBlk->Write * pBlk->Size));
+}
+
+/**
+********************************************************************************
+* @brief Publishes the write buffer and selects a new write buffer.
+*        Does never block.
+*
+* @param[in]  Handle   handle of the block, GIT_TEST_BLK_...
+*******************************************************************************/
+void git_test_blk_swap(UINT32 Handle)
+{
+    BLK_DESC *pBlk = &BlkList[Handle];
+    UINT32  idx;
+
+    /* Buffer content must be complete before it is published */
+    GIT_TEST_MEMBARRIER();
+    pBlk->Pub = pBlk->Write;
+    pBlk->Seq++;
+
+    /* Publish must be visible before the pinned buffer is checked */
+    GIT_TEST_MEMBARRIER();
+
+    for (idx = 0; idx < BLK_NBOFBUFS; idx++)
+    {
+        if ((idx != pBlk->Pub) && (idx != pBlk->Pin))
+        {
+            pBlk->Write = idx;
+            break;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Pins the published buffers of all blocks.
+*        Called by the bTask before an SVI read call is handled.
+*******************************************************************************/
+void git_test_blk_pin(void)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_BLK_NB; idx++)
+    {
+        (void)Blk_PinOne(&BlkList[idx]);
+    }
+
+    BlkPinnedByCall = TRUE;
+}
+
+/**
+********************************************************************************
+* @brief Releases the buffers pinned by git_test_blk_pin().
+*******************************************************************************/
+void git_test_blk_unpin(void)
+{
+    UINT32  idx;
+
+    BlkPinnedByCall = FALSE;
+
+    for (idx = 0; idx < GIT_TEST_BLK_NB; idx++)
+    {
+        BlkList[idx].Pin = BLK_NONE;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Pins the published buffer of one block.
+*        If the writer publishes while pinning, the new buffer is pinned.
+*
+* @param[in]  pBlk   block
+*
+* @retval     index of the pinned buffer
+*******************************************************************************/
+MLOCAL UINT32 Blk_PinOne(BLK_DESC *pBlk)
+{
+    UINT32  Pub;
+
+    do
+    {
+        Pub = pBlk->Pub;
+        pBlk->Pin = Pub;
+
+        /* Pin must be visible before the published buffer is checked again */
+        GIT_TEST_MEMBARRIER();
+    }
+    while (pBlk->Pub != Pub);
+
+    return (Pub);
+}
+
+/**
+********************************************************************************
+* @brief Read function of the block and page variables.
+*        Copies from the pinned buffer directly into the SVI reply.
+*
+* @param[in]  Handle     handle of the block
+* @param[in]  Offset     offset of the variable in the block in bytes
+* @param[out] pBuff      buffer for the value
+* @param[in,out] pBuffLen  size of buffer, returns number of bytes read
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Blk_SviRead(UINT32 Handle, UINT32 Offset, void *pBuff, UINT32 *pBuffLen)
+{
+    BLK_DESC *pBlk;
+    UINT32  Buf;
+    UINT32  Len;
+
+    if (Handle >= GIT_TEST_BLK_NB)
+    {
+        return (SVI_E_FAILED);
+    }
+
+    pBlk = &BlkList[Handle];
+    if (Offset >= pBlk->Size)
+    {
+        return (SVI_E_FAILED);
+    }
+
+    /* Access outside of an SVI call of the bTask: pin for this read only */
+    Buf = BlkPinnedByCall ? pBlk->Pin : Blk_PinOne(pBlk);
+
+    Len = pBlk->Size - Offset;
+    if (*pBuffLen < Len)
+    {
+        Len = *pBuffLen;
+    }
+
+    memcpy(pBuff, pBlk->pBufs + (Buf * pBlk->Size) + Offset, Len);
+    *pBuffLen = Len;
+
+    if (!BlkPinnedByCall)
+    {
+        pBlk->Pin = BLK_NONE;
+    }
+
+    return (SVI_E_OK);
+}
+
+/**
+********************************************************************************
+* @brief Initializes all blocks and registers the block, page and
+*        sequence variables at the SVI server of the module.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_blk_sviServerInit(void)
+{
+    BLK_DESC *pBlk;
+    SVI_VIRTVAR *pVar;
+    UINT32  idx;
+    UINT32  Offset;
+    UINT32  NbOfVars = 0;
+    SINT32  ret;
+
+    memset(BlkVarList, 0, sizeof(BlkVarList));
+    memset(BlkSeqList, 0, sizeof(BlkSeqList));
+    BlkPinnedByCall = FALSE;
+
+    for (idx = 0; idx < GIT_TEST_BLK_NB; idx++)
+    {
+        pBlk = &BlkList[idx];
+
+        /* Recorder contents are kept on a warm restart, like the retained state */
+        if (!BlkInitDone || !git_test_retain_avail())
+        {
+            memset(pBlk->pBufs, 0, pBlk->Size * BLK_NBOFBUFS);
+            pBlk->Pub = 0;
+            pBlk->Write = 1;
+            pBlk->Seq = 0;
+        }
+        pBlk->Pin = BLK_NONE;
+
+        /* Variable with the full block and one variable per page */
+        for (Offset = 0; Offset < pBlk->Size; Offset += GIT_TEST_BLK_PAGESIZE)
+        {
+            if (NbOfVars >= (sizeof(BlkVarList) / sizeof(SVI_VIRTVAR)) - 1)
+            {
+                LOG_E(0, __func__, "Too many page variables for block '%s'!", pBlk->VarName);
+                return (ERROR);
+            }
+
+            pVar = &BlkVarList[NbOfVars];
+
+            if (Offset == 0)
+            {
+                pVar->VarName = pBlk->VarName;
+                pVar->Format = SVI_F_OUT | SVI_F_BLK | pBlk->Format;
+                pVar->Size = pBlk->Size;
+                pVar->Rpar1 = idx;
+                pVar->Rpar2 = 0;
+                pVar->ReadFunction = Blk_SviRead;
+                pVar++;
+                NbOfVars++;
+            }
+
+            sprintf(BlkNames[NbOfVars], "%s/P%d", pBlk->VarName, Offset / GIT_TEST_BLK_PAGESIZE);
+            pVar->VarName = BlkNames[NbOfVars];
+            pVar->Format = SVI_F_OUT | SVI_F_BLK | pBlk->Format;
+            pVar->Size = pBlk->Size - Offset;
+            if (pVar->Size > GIT_TEST_BLK_PAGESIZE)
+            {
+                pVar->Size = GIT_TEST_BLK_PAGESIZE;
+            }
+            pVar->Rpar1 = idx;
+            pVar->Rpar2 = Offset;
+            pVar->ReadFunction = Blk_SviRead;
+            NbOfVars++;
+        }
+
+        /* Sequence counter */
+        sprintf(BlkNames[NbOfVars], "%s/Seq", pBlk->VarName);
+        BlkSeqList[idx].VarName = BlkNames[NbOfVars];
+        BlkSeqList[idx].Format = SVI_F_OUT | SVI_F_UINT32;
+        BlkSeqList[idx].Size = sizeof(UINT32);
+        BlkSeqList[idx].pVar = &pBlk->Seq;
+    }
+    BlkInitDone = TRUE;
+
+    ret = git_test_AppSviAddVirtVars(BlkVarList, NbOfVars);
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    return (git_test_AppSviAddGlobVars(BlkSeqList, GIT_TEST_BLK_NB));
+}
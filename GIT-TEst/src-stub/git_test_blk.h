@@ -0,0 +1,40 @@
+/**
+********************************************************************************
+* @file     git_test_blk.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the export of large
+*           data blocks (e.g. waveforms, tables) via SVI.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_BLK__H
+#define GIT_TEST_BLK__H
+
+/* Handles of the exported blocks, index in BlkList[] of git_test_blk.c */
+#define GIT_TEST_BLK_WAVE       0       /* execution times of the control cycles in us */
+#define GIT_TEST_BLK_NB         1       /* number of exported blocks */
+
+/* Defines: dimensions of the blocks */
+#define GIT_TEST_BLK_WAVE_LEN   4096    /* number of REAL32 samples in GIT_TEST_BLK_WAVE */
+#define GIT_TEST_BLK_PAGESIZE   1024    /* size of a single page variable in bytes */
+
+/*--- Functions ---*/
+
+/* Writer: buffer to be filled, not visible for SVI clients until swap */
+extern void *git_test_blk_writeBuf(UINT32 Handle);
+
+/* Writer: publish the filled buffer, does never block */
+extern void git_test_blk_swap(UINT32 Handle);
+
+/* bTask: keep the published buffers for the duration of an SVI read call */
+extern void git_test_blk_pin(void);
+extern void git_test_blk_unpin(void);
+
+/* bTask: register all blocks at the SVI server */
+extern SINT32 git_test_blk_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,569 @@
+/**
+********************************************************************************
+* @file     git_test_cfgidx.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the in-memory index of the module section
+*           of the configuration file.
+*
+*           pf_GetStrg()/pf_GetInt() open and scan the configuration file
+*           for every single key. git_test_cfgidx_load() instead reads the
+*           section of the module once, starting at the line number passed
+*           by the module handler, and enters every key into a hash table.
+*           The typed getters only access the table and report malformed
+*           values together with group, key and line number.
+*           If the module has no configuration file of its own, its
+*           section in MCONFIG.INI is indexed.
+*           If the configuration file cannot be opened directly, the
+*           getters fall back to pf_GetStrg().
+*
+*           Section, group and key names are compared case insensitive.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <mio.h>
+#include <mio_e.h>
+#include <prof_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_cfgidx.h"
+
+/* Defines: hash function (FNV-1a, 32 bit) and table */
+#define CFGIDX_FNV_OFFSET   2166136261u
+#define CFGIDX_FNV_PRIME    16777619u
+#define CFGIDX_SIZE         (2 * GIT_TEST_CFGIDX_MAXKEYS)   /* power of 2 */
+#define CFGIDX_MASK         (CFGIDX_SIZE - 1)
+#define CFGIDX_LINELEN      256         /* maximum length of a line in the file */
+
+/* Single key of the section */
+typedef struct CFGIDX_KEY
+{
+    UINT32  Hash;                       /* hash value of group and key */
+    CHAR    *pGroup;                    /* group name, "" if outside of a group */
+    CHAR    *pKey;                      /* key name */
+    CHAR    *pValue;                    /* value without quotes */
+    UINT32  LineNbr;                    /* line in the configuration file */
+} CFGIDX_KEY;
+
+/* Functions: being called only within this file */
+MLOCAL UINT32 CfgIdx_Hash(const CHAR *pGroup, const CHAR *pKey);
+MLOCAL UINT32 CfgIdx_StrEq(const CHAR *pStrg1, const CHAR *pStrg2);
+MLOCAL CHAR *CfgIdx_Trim(CHAR *pStrg);
+MLOCAL CHAR *CfgIdx_PoolAdd(const CHAR *pStrg);
+MLOCAL SINT32 CfgIdx_Add(const CHAR *pGroup, const CHAR *pKey, const CHAR *pValue, UINT32 LineNbr);
+MLOCAL const CHAR *CfgIdx_Find(const CHAR *pGroup, const CHAR *pKey, UINT32 *pLineNbr);
+
+/* Global variables: index */
+MLOCAL CFGIDX_KEY CfgIdxKeys[GIT_TEST_CFGIDX_MAXKEYS];
+MLOCAL UINT16 CfgIdxTable[CFGIDX_SIZE]; /* index+1 in CfgIdxKeys[], 0 = empty */
+MLOCAL CHAR CfgIdxPool[GIT_TEST_CFGIDX_POOLSIZE];
+MLOCAL UINT32 CfgIdxPoolUsed = 0;
+MLOCAL UINT32 CfgIdxNbOfKeys = 0;
+MLOCAL UINT32 CfgIdxLoaded = FALSE;      /* FALSE: getters use pf_GetStrg() */
+
+/**
+********************************************************************************
+* @brief Removes all keys from the index.
+*        The getters fall back to pf_GetStrg() until the next load.
+*******************************************************************************/
+void git_test_cfgidx_clear(void)
+{
+    memset(CfgIdxTable, 0, sizeof(CfgIdxTable));
+    CfgIdxPoolUsed = 0;
+    CfgIdxNbOfKeys = 0;
+    CfgIdxLoaded = FALSE;
+}
+
+/**
+********************************************************************************
+* @brief Name of the configuration file holding the section of the module:
+*        the file passed by the module handler or MCONFIG.INI if none.
+*
+* @retval     file name
+*******************************************************************************/
+const CHAR *git_test_cfgidx_fileName(void)
+{
+    if (strlen(git_test_BaseParams.CfgFileName) < 1)
+    {
+        return (GIT_TEST_CFGIDX_MCONFIG);
+    }
+
+    return (git_test_BaseParams.CfgFileName);
+}
+
+/**
+********************************************************************************
+* @brief Reads the section of the module from the configuration file
+*        in a single pass and enters all keys into the index.
+*        Reading starts at the line number passed by the module handler
+*        and ends at the next section.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_cfgidx_load(void)
+{
+    static const CHAR *pFunc = __func__;
+    FILE    *pFile;
+    CHAR    Line[CFGIDX_LINELEN];
+    CHAR    Group[PF_KEYLEN_A] = "";
+    CHAR    *pLine;
+    CHAR    *pEnd;
+    CHAR    *pValue;
+    UINT32  LineNbr = 0;
+    UINT32  InSection = FALSE;
+    const CHAR *pFileName = git_test_cfgidx_fileName();
+    SINT32  ret = OK;
+
+    /* Old contents must not be used during or after a failed load */
+    git_test_cfgidx_clear();
+
+    pFile = fopen(pFileName, "r");
+    if (!pFile)
+    {
+        LOG_W(0, pFunc, "Could not open '%s', using profile functions", pFileName);
+        return (OK);
+    }
+
+    while (fgets(Line, sizeof(Line), pFile))
+    {
+        LineNbr++;
+
+        /* Section of the module starts at or after the line passed by the module handler */
+        if ((SINT32)LineNbr < git_test_BaseParams.CfgLineNbr)
+        {
+            continue;
+        }
+
+        if (!strchr(Line, '\n') && !feof(pFile))
+        {
+            LOG_E(0, pFunc, "Line %d of '%s' too long, maximum is %d",
+                  LineNbr, pFileName, CFGIDX_LINELEN - 2);
+            ret = MIO_ER_BADCONF;
+            break;
+        }
+
+        pLine = CfgIdx_Trim(Line);
+        if ((*pLine == 0) || (*pLine == ';') || (*pLine == '#'))
+        {
+            continue;
+        }
+
+        /* [Section] */
+        if (*pLine == '[')
+        {
+            if (InSection)
+            {
+                break;
+            }
+            pEnd = strchr(pLine, ']');
+            if (pEnd)
+            {
+                *pEnd = 0;
+                InSection = CfgIdx_StrEq(CfgIdx_Trim(pLine + 1), git_test_BaseParams.AppName);
+            }
+            continue;
+        }
+
+        if (!InSection)
+        {
+            continue;
+        }
+
+        /* (Group) */
+        if (*pLine == '(')
+        {
+            pEnd = strchr(pLine, ')');
+            if (!pEnd || ((UINT32)(pEnd - pLine) > PF_KEYLEN_A - 1))
+            {
+                LOG_E(0, pFunc, "Bad group name in line %d", LineNbr);
+                ret = MIO_ER_BADCONF;
+                break;
+            }
+            *pEnd = 0;
+            strcpy(Group, CfgIdx_Trim(pLine + 1));
+            continue;
+        }
+
+        /* Key = Value */
+        pValue = strchr(pLine, '=');
+        if (!pValue)
+        {
+            LOG_W(0, pFunc, "Line %d ignored: missing '='", LineNbr);
+            continue;
+        }
+        *pValue++ = 0;
+        pValue = CfgIdx_Trim(pValue);
+
+        /* Remove quotes of string values */
+        if ((*pValue == '"') && (strlen(pValue) > 1) && (pValue[strlen(pValue) - 1] == '"'))
+        {
+            pValue[strlen(pValue) - 1] = 0;
+            pValue++;
+        }
+
+        ret = CfgIdx_Add(Group, CfgIdx_Trim(pLine), pValue, LineNbr);
+        if (ret < 0)
+        {
+            break;
+        }
+    }
+
+    fclose(pFile);
+
+    if (ret < 0)
+    {
+        git_test_cfgidx_clear();
+        return (ret);
+    }
+
+    if (!InSection)
+    {
+        LOG_W(0, pFunc, "Section [%s] not found in '%s', using profile functions",
+              git_test_BaseParams.AppName, pFileName);
+        return (OK);
+    }
+
+    CfgIdxLoaded = TRUE;
+    LOG_I(1, pFunc, "%d keys read from section [%s]", CfgIdxNbOfKeys,
+          git_test_BaseParams.AppName);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns a string value.
+*
+* @param[in]  pGroup    group name
+* @param[in]  pKey      key name
+* @param[in]  pDefault  value returned if the key is missing
+* @param[out] pBuff     buffer for the value
+* @param[in]  BuffLen   size of the buffer
+*
+* @retval     = 0 .. OK, key found
+* @retval     < 0 .. ERROR, key missing or value too long
+*******************************************************************************/
+SINT32 git_test_cfgidx_getStrg(const CHAR *pGroup, const CHAR *pKey, const CHAR *pDefault,
+                               CHAR *pBuff, UINT32 BuffLen)
+{
+    const CHAR *pValue;
+    UINT32  LineNbr;
+
+    pValue = CfgIdx_Find(pGroup, pKey, &LineNbr);
+    if (!pValue)
+    {
+        strncpy(pBuff, pDefault, BuffLen - 1);
+        pBuff[BuffLen - 1] = 0;
+        return (ERROR);
+    }
+
+    if (strlen(pValue) >= BuffLen)
+    {
+        LOG_E(0, __func__, "Line %d: value of '(%s)%s' too long, maximum is %d",
+              LineNbr, pGroup, pKey, BuffLen - 1);
+        strncpy(pBuff, pDefault, BuffLen - 1);
+        pBuff[BuffLen - 1] = 0;
+        return (MIO_ER_BADCONF);
+    }
+
+    strcpy(pBuff, pValue);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns an integer value. Decimal and hexadecimal (0x) are accepted.
+*
+* @param[in]  pGroup    group name
+* @param[in]  pKey      key name
+* @param[in]  Default   value returned if the key is missing or malformed
+* @param[out] pVal      value
+*
+* @retval     = 0 .. OK, key found
+* @retval     < 0 .. ERROR, key missing; MIO_ER_BADCONF, value malformed
+*******************************************************************************/
+SINT32 git_test_cfgidx_getInt(const CHAR *pGroup, const CHAR *pKey, SINT32 Default,
+                              SINT32 *pVal)
+{
+    const CHAR *pValue;
+    CHAR    *pEnd;
+    UINT32  LineNbr;
+    SINT32  Val;
+
+    *pVal = Default;
+
+    pValue = CfgIdx_Find(pGroup, pKey, &LineNbr);
+    if (!pValue)
+    {
+        return (ERROR);
+    }
+
+    Val = strtol(pValue, &pEnd, 0);
+    if ((pEnd == pValue) || (*CfgIdx_Trim(pEnd) != 0))
+    {
+        LOG_E(0, __func__, "Line %d: '(%s)%s = %s' is not an integer",
+              LineNbr, pGroup, pKey, pValue);
+        return (MIO_ER_BADCONF);
+    }
+
+    *pVal = Val;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns a floating point value.
+*
+* @param[in]  pGroup    group name
+* @param[in]  pKey      key name
+* @param[in]  Default   value returned if the key is missing or malformed
+* @param[out] pVal      value
+*
+* @retval     = 0 .. OK, key found
+* @retval     < 0 .. ERROR, key missing; MIO_ER_BADCONF, value malformed
+*******************************************************************************/
+SINT32 git_test_cfgidx_getReal(const CHAR *pGroup, const CHAR *pKey, REAL32 Default,
+                               REAL32 *pVal)
+{
+    const CHAR *pValue;
+    CHAR    *pEnd;
+    UINT32  LineNbr;
+    REAL64  Val;
+
+    *pVal = Default;
+
+    pValue = CfgIdx_Find(pGroup, pKey, &LineNbr);
+    if (!pValue)
+    {
+        return (ERROR);
+    }
+
+    Val = strtod(pValue, &pEnd);
+    if ((pEnd == pValue) || (*CfgIdx_Trim(pEnd) != 0))
+    {
+        LOG_E(0, __func__, "Line %d: '(%s)%s = %s' is not a number",
+              LineNbr, pGroup, pKey, pValue);
+        return (MIO_ER_BADCONF);
+    }
+
+    *pVal = (REAL32)Val;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Looks up a key in the index.
+*        If the section has not been loaded, the key is read with pf_GetStrg().
+*
+* @param[in]  pGroup    group name
+* @param[in]  pKey      key name
+* @param[out] pLineNbr  line of the key, 0 if unknown
+*
+* @retval     value of the key, NULL if missing
+*******************************************************************************/
+MLOCAL const CHAR *CfgIdx_Find(const CHAR *pGroup, const CHAR *pKey, UINT32 *pLineNbr)
+{
+    static CHAR Value[CFGIDX_LINELEN];
+    CFGIDX_KEY *pEntry;
+    UINT32  Hash;
+    UINT32  Slot;
+    SINT32  ret;
+
+    *pLineNbr = 0;
+
+    if (!CfgIdxLoaded)
+    {
+        ret = pf_GetStrg(git_test_BaseParams.AppName, (CHAR *)pGroup, (CHAR *)pKey, "",
+                         Value, sizeof(Value),
+                         git_test_BaseParams.CfgLineNbr, git_test_BaseParams.CfgFileName);
+        if ((ret < 0) || (strlen(Value) < 1))
+        {
+            return (NULL);
+        }
+        return (Value);
+    }
+
+    Hash = CfgIdx_Hash(pGroup, pKey);
+    for (Slot = Hash & CFGIDX_MASK; CfgIdxTable[Slot]; Slot = (Slot + 1) & CFGIDX_MASK)
+    {
+        pEntry = &CfgIdxKeys[CfgIdxTable[Slot] - 1];
+        if ((pEntry->Hash == Hash) &&
+            CfgIdx_StrEq(pEntry->pKey, pKey) && CfgIdx_StrEq(pEntry->pGroup, pGroup))
+        {
+            /* empty value counts as missing, as with the profile functions */
+            *pLineNbr = pEntry->LineNbr;
+            return ((*pEntry->pValue) ? pEntry->pValue : NULL);
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Enters a key into the index.
+*        If a key is specified twice, the first one is used, as with
+*        the profile functions.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 CfgIdx_Add(const CHAR *pGroup, const CHAR *pKey, const CHAR *pValue, UINT32 LineNbr)
+{
+    CFGIDX_KEY *pEntry;
+    UINT32  Hash;
+    UINT32  Slot;
+
+    if (CfgIdxNbOfKeys >= GIT_TEST_CFGIDX_MAXKEYS)
+    {
+        LOG_E(0, __func__, "Too many keys in section [%s], maximum is %d",
+              git_test_BaseParams.AppName, GIT_TEST_CFGIDX_MAXKEYS);
+        return (MIO_ER_BADCONF);
+    }
+
+    Hash = CfgIdx_Hash(pGroup, pKey);
+    for (Slot = Hash & CFGIDX_MASK; CfgIdxTable[Slot]; Slot = (Slot + 1) & CFGIDX_MASK)
+    {
+        pEntry = &CfgIdxKeys[CfgIdxTable[Slot] - 1];
+        if ((pEntry->Hash == Hash) &&
+            CfgIdx_StrEq(pEntry->pKey, pKey) && CfgIdx_StrEq(pEntry->pGroup, pGroup))
+        {
+            LOG_W(0, __func__, "Line %d: '(%s)%s' ignored, already defined in line %d",
+                  LineNbr, pGroup, pKey, pEntry->LineNbr);
+            return (OK);
+        }
+    }
+
+    pEntry = &CfgIdxKeys[CfgIdxNbOfKeys];
+    pEntry->Hash = Hash;
+    pEntry->LineNbr = LineNbr;
+
+    /* Consecutive keys of a group share the group name in the pool */
+    if ((CfgIdxNbOfKeys > 0) && (strcmp(CfgIdxKeys[CfgIdxNbOfKeys - 1].pGroup, pGroup) == 0))
+    {
+        pEntry->pGroup = CfgIdxKeys[CfgIdxNbOfKeys - 1].pGroup;
+    }
+    else
+    {
+        pEntry->pGroup = CfgIdx_PoolAdd(pGroup);
+    }
+    pEntry->pKey = CfgIdx_PoolAdd(pKey);
+    pEntry->pValue = CfgIdx_PoolAdd(pValue);
+
+    if (!pEntry->pGroup || !pEntry->pKey || !pEntry->pValue)
+    {
+        LOG_E(0, __func__, "Section [%s] too large, string pool size is %d",
+              git_test_BaseParams.AppName, GIT_TEST_CFGIDX_POOLSIZE);
+        return (MIO_ER_BADCONF);
+    }
+
+    CfgIdxNbOfKeys++;
+    CfgIdxTable[Slot] = (UINT16)CfgIdxNbOfKeys;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Copies a string into the string pool.
+*
+* @retval     pointer to the copy, NULL if the pool is full
+*******************************************************************************/
+MLOCAL CHAR *CfgIdx_PoolAdd(const CHAR *pStrg)
+{
+    UINT32  Len = strlen(pStrg) + 1;
+    CHAR    *pCopy;
+
+    if (CfgIdxPoolUsed + Len > sizeof(CfgIdxPool))
+    {
+        return (NULL);
+    }
+
+    pCopy = &CfgIdxPool[CfgIdxPoolUsed];
+    memcpy(pCopy, pStrg, Len);
+    CfgIdxPoolUsed += Len;
+
+    return (pCopy);
+}
+
+/**
+********************************************************************************
+* @brief Hash value of group and key name, independent of upper/lower case.
+*******************************************************************************/
+MLOCAL UINT32 CfgIdx_Hash(const CHAR *pGroup, const CHAR *pKey)
+{
+    UINT32  Hash = CFGIDX_FNV_OFFSET;
+
+    while (*pGroup)
+    {
+        Hash = (Hash ^ (UINT8)tolower((UINT8)*pGroup++)) * CFGIDX_FNV_PRIME;
+    }
+
+    /* separator, "(ab)c" differs from "(a)bc" */
+    Hash = (Hash ^ (UINT8)')') * CFGIDX_FNV_PRIME;
+
+    while (*pKey)
+    {
+        Hash = (Hash ^ (UINT8)tolower((UINT8)*pKey++)) * CFGIDX_FNV_PRIME;
+    }
+
+    return (Hash);
+}
+
+/**
+********************************************************************************
+* @brief Compares two strings independent of upper/lower case.
+*
+* @retval     TRUE if equal
+*******************************************************************************/
+MLOCAL UINT32 CfgIdx_StrEq(const CHAR *pStrg1, const CHAR *pStrg2)
+{
+    while (*pStrg1 && (tolower((UINT8)*pStrg1) == tolower((UINT8)*pStrg2)))
+    {
+        pStrg1++;
+        pStrg2++;
+    }
+
+    return (*pStrg1 == *pStrg2);
+}
+
+/**
+********************************************************************************
+* @brief Removes leading and trailing white space in place.
+*
+* @retval     pointer to the first non white space character
+*******************************************************************************/
+MLOCAL CHAR *CfgIdx_Trim(CHAR *pStrg)
+{
+    CHAR    *pEnd;
+
+    while (isspace((UINT8)*pStrg))
+    {
+        pStrg++;
+    }
+
+    pEnd = pStrg + strlen(pStrg);
+    while ((pEnd > pStrg) && isspace((UINT8)pEnd[-1]))
+    {
+        *--pEnd = 0;
+    }
+
+    return (pStrg);
+}
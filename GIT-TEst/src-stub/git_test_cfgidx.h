@@ -0,0 +1,41 @@
+/**
+********************************************************************************
+* @file     git_test_cfgidx.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the in-memory index of
+*           the module section of the configuration file.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_CFGIDX__H
+#define GIT_TEST_CFGIDX__H
+
+/* Defines: dimensions of the index */
+#define GIT_TEST_CFGIDX_MAXKEYS     256     /* maximum number of keys in the section */
+#define GIT_TEST_CFGIDX_POOLSIZE    8192    /* size of the string pool in bytes */
+
+/* Configuration file of the module handler, used if the module has no file of its own */
+#define GIT_TEST_CFGIDX_MCONFIG     "/cfc0/mconfig.ini"
+
+/*--- Functions ---*/
+
+/* bTask: read the module section in one pass, before all getters */
+extern SINT32 git_test_cfgidx_load(void);
+extern void git_test_cfgidx_clear(void);
+
+/* Any task: configuration file holding the module section */
+extern const CHAR *git_test_cfgidx_fileName(void);
+
+/* Typed getters: OK if found, ERROR if missing (default returned), MIO_ER_BADCONF if malformed */
+extern SINT32 git_test_cfgidx_getStrg(const CHAR *pGroup, const CHAR *pKey, const CHAR *pDefault,
+                                      CHAR *pBuff, UINT32 BuffLen);
+extern SINT32 git_test_cfgidx_getInt(const CHAR *pGroup, const CHAR *pKey, SINT32 Default,
+                                     SINT32 *pVal);
+extern SINT32 git_test_cfgidx_getReal(const CHAR *pGroup, const CHAR *pKey, REAL32 Default,
+                                      REAL32 *pVal);
+
+#endif /* Avoid problems with multiple include */
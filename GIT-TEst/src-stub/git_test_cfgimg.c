@@ -0,0 +1,524 @@
+/**
+********************************************************************************
+* @file     git_test_cfgimg.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the binary image of the parsed configuration.
+*
+*           After the configuration file has been parsed successfully, the
+*           parsed settings are written as sections into the image file
+*           "<AppName>.cim" next to the configuration file, which is
+*           MCONFIG.INI if the module has no file of its own.
+*           The header of the image contains size and modification time of
+*           the configuration file, the start line of the module section,
+*           the build time of the module and a CRC32 of all sections.
+*           At the next start the image is only used if all of them match,
+*           otherwise the configuration file is parsed again.
+*
+*           The image holds the CONFIG of the module, which is registered
+*           before the first configuration load. The validate callback
+*           copies the CONFIG filled by git_test_config_read() into a
+*           staging copy, which is only taken over by
+*           git_test_cfgimg_commitConfig() once the whole configuration has
+*           been parsed. So the image can already be used at the first start
+*           after the module has been loaded, and a failed load leaves the
+*           CONFIG in use unchanged.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_cfgimg.h"
+#include "git_test_cfgidx.h"
+
+/* Defines: image file */
+#define CFGIMG_MAGIC        0x47544349  /* "GTCI" */
+#define CFGIMG_VERSION      1
+#define CFGIMG_MAXLEN       16384       /* maximum size of all sections */
+#define CFGIMG_EXT          ".cim"
+#define CFGIMG_CRC_POLY     0xEDB88320u /* CRC32, reflected */
+
+/* Header of the image file */
+typedef struct CFGIMG_HDR
+{
+    UINT32  Magic;                      /* CFGIMG_MAGIC */
+    UINT32  Version;                    /* CFGIMG_VERSION */
+    CHAR    Build[24];                  /* build time of the module */
+    UINT32  SrcSize;                    /* size of the configuration file */
+    UINT32  SrcTime;                    /* modification time of the configuration file */
+    SINT32  CfgLineNbr;                 /* start line of the module section */
+    UINT32  DataLen;                    /* size of all sections in bytes */
+    UINT32  Crc;                        /* CRC32 of all sections */
+} CFGIMG_HDR;
+
+/* Header of a section, followed by Len bytes of data */
+typedef struct CFGIMG_SECT
+{
+    UINT32  Id;                         /* GIT_TEST_CFGIMG_... */
+    UINT32  Len;                        /* size of the data in bytes */
+} CFGIMG_SECT;
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 CfgImg_SrcStat(UINT32 *pSize, UINT32 *pTime);
+
+/* Global variables: image */
+MLOCAL void *CfgImgConfig = NULL;       /* CONFIG of the generated code */
+MLOCAL void *CfgImgStaged = NULL;       /* CONFIG accepted by the validate callback */
+MLOCAL UINT32 CfgImgConfigSize = 0;
+MLOCAL CFGIMG_HDR CfgImgHdr;
+MLOCAL UINT8 *pCfgImgData = NULL;       /* sections, while open or created */
+MLOCAL UINT32 CfgImgCrcTable[256];
+MLOCAL UINT32 CfgImgCrcInit = FALSE;
+
+/**
+********************************************************************************
+* @brief Registers the CONFIG of the module, which is written into the
+*        image and restored from it, and its staging copy.
+*        Called by the bTask before the configuration is loaded.
+*
+* @param[in]  pConfig   CONFIG of the module
+* @param[in]  pStaged   staging copy of the same size
+* @param[in]  Size      size of CONFIG in bytes
+*******************************************************************************/
+void git_test_cfgimg_setConfig(void *pConfig, void *pStaged, UINT32 Size)
+{
+    CfgImgConfig = pConfig;
+    CfgImgStaged = pStaged;
+    CfgImgConfigSize = Size;
+}
+
+/**
+********************************************************************************
+* @brief Copies the CONFIG filled by git_test_config_read() into the
+*        staging copy registered by git_test_cfgimg_setConfig().
+*        Called by the validate callback of the configuration.
+*
+* @param[in]  pConfig   CONFIG of the generated code
+* @param[in]  Size      size of CONFIG in bytes
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_cfgimg_takeConfig(const void *pConfig, UINT32 Size)
+{
+    if (!CfgImgStaged || (Size != CfgImgConfigSize))
+    {
+        LOG_E(0, __func__, "No CONFIG of %d bytes registered!", Size);
+        return (ERROR);
+    }
+
+    if (pConfig != CfgImgStaged)
+    {
+        memcpy(CfgImgStaged, pConfig, Size);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Takes over the staged CONFIG into the CONFIG in use.
+*        Called by the bTask after the whole configuration has been loaded.
+*******************************************************************************/
+void git_test_cfgimg_commitConfig(void)
+{
+    if (CfgImgConfig && CfgImgStaged)
+    {
+        memcpy(CfgImgConfig, CfgImgStaged, CfgImgConfigSize);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the CONFIG registered by git_test_cfgimg_setConfig().
+*
+* @param[out] pSize     size of CONFIG in bytes
+*
+* @retval     CONFIG, NULL if not known yet
+*******************************************************************************/
+void *git_test_cfgimg_getConfig(UINT32 *pSize)
+{
+    *pSize = CfgImgConfigSize;
+    return (CfgImgConfig);
+}
+
+/**
+********************************************************************************
+* @brief Reads the image file and checks if it matches the configuration file.
+*        The sections can be read with git_test_cfgimg_get() until
+*        git_test_cfgimg_close() is called.
+*
+* @retval     = 0 .. OK, image is valid
+* @retval     < 0 .. ERROR, configuration file must be parsed
+*******************************************************************************/
+SINT32 git_test_cfgimg_open(void)
+{
+    static const CHAR *pFunc = __func__;
+    CHAR    FileName[M_PATHLEN_A];
+    FILE    *pFile;
+    UINT32  SrcSize;
+    UINT32  SrcTime;
+    SINT32  ret = ERROR;
+
+    git_test_cfgimg_close();
+
+    if ((git_test_cfgimg_fileName(FileName, sizeof(FileName), CFGIMG_EXT) < 0) ||
+        (CfgImg_SrcStat(&SrcSize, &SrcTime) < 0))
+    {
+        return (ERROR);
+    }
+
+    pFile = fopen(FileName, "rb");
+    if (!pFile)
+    {
+        LOG_I(1, pFunc, "No configuration image '%s'", FileName);
+        return (ERROR);
+    }
+
+    do
+    {
+        if ((fread(&CfgImgHdr, sizeof(CfgImgHdr), 1, pFile) != 1) ||
+            (CfgImgHdr.Magic != CFGIMG_MAGIC) ||
+            (CfgImgHdr.Version != CFGIMG_VERSION) ||
+            (CfgImgHdr.DataLen > CFGIMG_MAXLEN))
+        {
+            LOG_W(0, pFunc, "Bad configuration image '%s'", FileName);
+            break;
+        }
+
+        if ((strncmp(CfgImgHdr.Build, __DATE__ " " __TIME__, sizeof(CfgImgHdr.Build)) != 0) ||
+            (CfgImgHdr.SrcSize != SrcSize) || (CfgImgHdr.SrcTime != SrcTime) ||
+            (CfgImgHdr.CfgLineNbr != git_test_BaseParams.CfgLineNbr))
+        {
+            LOG_I(1, pFunc, "Configuration image '%s' is outdated", FileName);
+            break;
+        }
+
+        pCfgImgData = sys_MemXAlloc(CfgImgHdr.DataLen + 1);
+        if (!pCfgImgData)
+        {
+            LOG_E(0, pFunc, "Could not allocate %d bytes!", CfgImgHdr.DataLen);
+            break;
+        }
+
+        if ((fread(pCfgImgData, 1, CfgImgHdr.DataLen, pFile) != CfgImgHdr.DataLen) ||
+            (git_test_cfgimg_crc(pCfgImgData, CfgImgHdr.DataLen) != CfgImgHdr.Crc))
+        {
+            LOG_W(0, pFunc, "Checksum error in configuration image '%s'", FileName);
+            break;
+        }
+
+        ret = OK;
+    }
+    while (FALSE);
+
+    fclose(pFile);
+
+    if (ret < 0)
+    {
+        git_test_cfgimg_close();
+    }
+
+    return (ret);
+}
+
+/**
+********************************************************************************
+* @brief Copies a section of the opened image.
+*
+* @param[in]  Id        GIT_TEST_CFGIMG_...
+* @param[out] pData     buffer for the section
+* @param[in]  Len       expected size of the section
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, section missing or of different size
+*******************************************************************************/
+SINT32 git_test_cfgimg_get(UINT32 Id, void *pData, UINT32 Len)
+{
+    CFGIMG_SECT Sect;
+    UINT32  Pos = 0;
+
+    if (!pCfgImgData)
+    {
+        return (ERROR);
+    }
+
+    while (Pos + sizeof(Sect) <= CfgImgHdr.DataLen)
+    {
+        memcpy(&Sect, pCfgImgData + Pos, sizeof(Sect));
+        Pos += sizeof(Sect);
+
+        if (Sect.Len > CfgImgHdr.DataLen - Pos)
+        {
+            break;
+        }
+
+        if (Sect.Id == Id)
+        {
+            if (Sect.Len != Len)
+            {
+                LOG_W(0, __func__, "Section %d has %d bytes instead of %d", Id, Sect.Len, Len);
+                return (ERROR);
+            }
+            memcpy(pData, pCfgImgData + Pos, Len);
+            return (OK);
+        }
+
+        Pos += Sect.Len;
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Frees the image opened or created.
+*******************************************************************************/
+void git_test_cfgimg_close(void)
+{
+    if (pCfgImgData)
+    {
+        sys_MemXFree(pCfgImgData);
+        pCfgImgData = NULL;
+    }
+    memset(&CfgImgHdr, 0, sizeof(CfgImgHdr));
+}
+
+/**
+********************************************************************************
+* @brief Starts a new image, sections are added with git_test_cfgimg_add().
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_cfgimg_create(void)
+{
+    git_test_cfgimg_close();
+
+    pCfgImgData = sys_MemXAlloc(CFGIMG_MAXLEN);
+    if (!pCfgImgData)
+    {
+        LOG_E(0, __func__, "Could not allocate %d bytes!", CFGIMG_MAXLEN);
+        return (ERROR);
+    }
+
+    CfgImgHdr.Magic = CFGIMG_MAGIC;
+    CfgImgHdr.Version = CFGIMG_VERSION;
+    strncpy(CfgImgHdr.Build, __DATE__ " " __TIME__, sizeof(CfgImgHdr.Build));
+    CfgImgHdr.CfgLineNbr = git_test_BaseParams.CfgLineNbr;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Adds a section to the created image.
+*
+* @param[in]  Id        GIT_TEST_CFGIMG_...
+* @param[in]  pData     data of the section
+* @param[in]  Len       size of the section
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_cfgimg_add(UINT32 Id, const void *pData, UINT32 Len)
+{
+    CFGIMG_SECT Sect;
+
+    if (!pCfgImgData)
+    {
+        return (ERROR);
+    }
+
+    if (CfgImgHdr.DataLen + sizeof(Sect) + Len > CFGIMG_MAXLEN)
+    {
+        LOG_W(0, __func__, "Configuration image too large, maximum is %d bytes", CFGIMG_MAXLEN);
+        git_test_cfgimg_close();
+        return (ERROR);
+    }
+
+    Sect.Id = Id;
+    Sect.Len = Len;
+    memcpy(pCfgImgData + CfgImgHdr.DataLen, &Sect, sizeof(Sect));
+    CfgImgHdr.DataLen += sizeof(Sect);
+    memcpy(pCfgImgData + CfgImgHdr.DataLen, pData, Len);
+    CfgImgHdr.DataLen += Len;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Writes the created image and frees it.
+*        The file is written under a temporary name and renamed afterwards,
+*        so an interrupted write never leaves a valid image.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_cfgimg_write(void)
+{
+    static const CHAR *pFunc = __func__;
+    CHAR    FileName[M_PATHLEN_A];
+    CHAR    TmpName[M_PATHLEN_A + 4];
+    FILE    *pFile;
+    SINT32  ret = ERROR;
+
+    if (!pCfgImgData)
+    {
+        return (ERROR);
+    }
+
+    do
+    {
+        if ((git_test_cfgimg_fileName(FileName, sizeof(FileName), CFGIMG_EXT) < 0) ||
+            (CfgImg_SrcStat(&CfgImgHdr.SrcSize, &CfgImgHdr.SrcTime) < 0))
+        {
+            break;
+        }
+
+        CfgImgHdr.Crc = git_test_cfgimg_crc(pCfgImgData, CfgImgHdr.DataLen);
+
+        sprintf(TmpName, "%s.tmp", FileName);
+        pFile = fopen(TmpName, "wb");
+        if (!pFile)
+        {
+            LOG_W(0, pFunc, "Could not create '%s'", TmpName);
+            break;
+        }
+
+        if ((fwrite(&CfgImgHdr, sizeof(CfgImgHdr), 1, pFile) != 1) ||
+            (fwrite(pCfgImgData, 1, CfgImgHdr.DataLen, pFile) != CfgImgHdr.DataLen))
+        {
+            LOG_W(0, pFunc, "Could not write '%s'", TmpName);
+            fclose(pFile);
+            (void)remove(TmpName);
+            break;
+        }
+        fclose(pFile);
+
+        (void)remove(FileName);
+        if (rename(TmpName, FileName) < 0)
+        {
+            LOG_W(0, pFunc, "Could not rename '%s'", TmpName);
+            break;
+        }
+
+        LOG_I(1, pFunc, "Configuration image '%s' written, %d bytes", FileName,
+              sizeof(CfgImgHdr) + CfgImgHdr.DataLen);
+        ret = OK;
+    }
+    while (FALSE);
+
+    git_test_cfgimg_close();
+    return (ret);
+}
+
+/**
+********************************************************************************
+* @brief Name of a file of the module, in the directory of the configuration
+*        file: <AppName><Ext>.
+*
+* @param[out] pName     file name
+* @param[in]  Len       size of pName
+* @param[in]  pExt      extension, e.g. ".cim"
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, name too long
+*******************************************************************************/
+SINT32 git_test_cfgimg_fileName(CHAR *pName, UINT32 Len, const CHAR *pExt)
+{
+    const CHAR *pCfgFile = git_test_cfgidx_fileName();
+    const CHAR *pSlash;
+    UINT32  DirLen;
+
+    pSlash = strrchr(pCfgFile, '/');
+    DirLen = pSlash ? (UINT32)(pSlash - pCfgFile) + 1 : 0;
+
+    if (DirLen + strlen(git_test_BaseParams.AppName) + strlen(pExt) + 1 > Len)
+    {
+        return (ERROR);
+    }
+
+    memcpy(pName, pCfgFile, DirLen);
+    sprintf(pName + DirLen, "%s%s", git_test_BaseParams.AppName, pExt);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Size and modification time of the configuration file.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 CfgImg_SrcStat(UINT32 *pSize, UINT32 *pTime)
+{
+    struct stat Stat;
+
+    if (stat(git_test_cfgidx_fileName(), &Stat) < 0)
+    {
+        return (ERROR);
+    }
+
+    *pSize = (UINT32)Stat.st_size;
+    *pTime = (UINT32)Stat.st_mtime;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief CRC32 of a memory range.
+*        Also used for the retained state, see git_test_retain.c.
+*
+* @param[in]  pData     start of the range
+* @param[in]  Len       length in bytes
+*
+* @retval     CRC32
+*******************************************************************************/
+UINT32 git_test_cfgimg_crc(const void *pData, UINT32 Len)
+{
+    const UINT8 *p = pData;
+    UINT32  Crc;
+    UINT32  idx;
+    UINT32  bit;
+
+    if (!CfgImgCrcInit)
+    {
+        for (idx = 0; idx < 256; idx++)
+        {
+            Crc = idx;
+            for (bit = 0; bit < 8; bit++)
+            {
+                Crc = (Crc & 1) ? (Crc >> 1) ^ CFGIMG_CRC_POLY : (Crc >> 1);
+            }
+            CfgImgCrcTable[idx] = Crc;
+        }
+        CfgImgCrcInit = TRUE;
+    }
+
+    Crc = 0xFFFFFFFFu;
+    while (Len--)
+    {
+        Crc = CfgImgCrcTable[(Crc ^ *p++) & 0xFF] ^ (Crc >> 8);
+    }
+
+    return (Crc ^ 0xFFFFFFFFu);
+}
@@ -0,0 +1,50 @@
+/**
+********************************************************************************
+* @file     git_test_cfgimg.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the binary image of the
+*           parsed configuration.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_CFGIMG__H
+#define GIT_TEST_CFGIMG__H
+
+/* Sections of the image */
+#define GIT_TEST_CFGIMG_CONFIG      1   /* CONFIG of the generated code */
+#define GIT_TEST_CFGIMG_TASKS       2   /* task settings */
+#define GIT_TEST_CFGIMG_SVICLNT     3   /* names of the remote variables */
+
+/*--- Functions ---*/
+
+/* bTask: CONFIG of the module, registered before the first configuration load */
+extern void git_test_cfgimg_setConfig(void *pConfig, void *pStaged, UINT32 Size);
+extern void *git_test_cfgimg_getConfig(UINT32 *pSize);
+
+/* bTask: stage the CONFIG filled by git_test_config_read(), from the validate callback */
+extern SINT32 git_test_cfgimg_takeConfig(const void *pConfig, UINT32 Size);
+
+/* bTask: take over the staged CONFIG once the whole configuration has been loaded */
+extern void git_test_cfgimg_commitConfig(void);
+
+/* bTask: read an image, valid only if the configuration file is unchanged */
+extern SINT32 git_test_cfgimg_open(void);
+extern SINT32 git_test_cfgimg_get(UINT32 Id, void *pData, UINT32 Len);
+extern void git_test_cfgimg_close(void);
+
+/* bTask: write an image after the configuration file has been parsed */
+extern SINT32 git_test_cfgimg_create(void);
+extern SINT32 git_test_cfgimg_add(UINT32 Id, const void *pData, UINT32 Len);
+extern SINT32 git_test_cfgimg_write(void);
+
+/* Any task: CRC32 as used in the image */
+extern UINT32 git_test_cfgimg_crc(const void *pData, UINT32 Len);
+
+/* Any task: name of a file next to the configuration file */
+extern SINT32 git_test_cfgimg_fileName(CHAR *pName, UINT32 Len, const CHAR *pExt);
+
+#endif /* Avoid problems with multiple include */
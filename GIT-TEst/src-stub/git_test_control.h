@@ -15,7 +15,56 @@
 
 #include "../src-gen/git_test_direct.h"
 #include "../src-gen/git_test_config.h"
+#include "git_test_param.h"
+#include "git_test_pid.h"
+#include "git_test_filt.h"
+#include "git_test_lut.h"
+#include "git_test_fb.h"
+#include "git_test_sm.h"
 
+/*
+ * Configuration values to be used in git_test_control_cycle().
+ * A changed configuration (RpcNewCfg) or a selected recipe is taken over
+ * at cycle start, so the values never change within a cycle.
+ */
+#define GIT_TEST_CYCLE_CONFIG   (&git_test_pParam->Config)
+
+/*
+ * Process state which is kept on a reset of the module (RpcReset) and on
+ * the restart of the bTask after an exception, e.g. controller states and
+ * totalizers. It is checkpointed at each cycle end and restored before the
+ * control task is started again.
+ * Settings are not part of it, they are set up again at each start.
+ * It is cleared on a cold start: a changed size of the structure or a new
+ * build of the module.
+ */
+typedef struct GIT_TEST_RETAIN_DATA
+{
+    UINT32  CycleCnt;                   /* number of executed control cycles */
+    GIT_TEST_SM_SAVE Sm;                /* states of the state machines, see git_test_sm_save() */
+    GIT_TEST_PID_SAVE Pid;              /* controller states, see git_test_pid_save() */
+    REAL64  Energy_kWh;                 /* totalizer of git_test_control_cycle() */
+
+} GIT_TEST_RETAIN_DATA;
+
+extern GIT_TEST_RETAIN_DATA git_test_Retain;
+
+/*
+ * Function blocks run at each cycle before git_test_control_cycle(),
+ * see git_test_fb.h. The list is terminated by an entry with pType = NULL.
+ */
+extern const GIT_TEST_FB_BLOCK git_test_FbList[];
+
+/*
+ * State machine instances, stepped by git_test_sm_step() in
+ * git_test_control_cycle(), see git_test_sm.h. The list is terminated by
+ * an entry with pMachine = NULL.
+ */
+extern const GIT_TEST_SM_INST git_test_SmList[];
+
+void git_test_control_start(void);
+void git_test_control_stateSave(void);
+void git_test_control_stateRestore(void);
 void git_test_control_cycle(const IN_VARS *pInVars, OUT_VARS *pOutVars);
 void git_test_pi_cbf_errorStateChangeIn(void);
 void git_test_pi_cbf_errorStateChangeOut(void);
@@ -23,4 +72,13 @@ SINT32 git_test_config_cbf_validate(CONFIG *pConfig);
 void git_test_direct_getErrorOutChans(SINT32 ErrorIndex);
 void git_test_direct_getErrorInChan(SINT32 ErrorIndex);
 
+/* Response time analysis of the task settings being validated */
+SINT32 git_test_AppSchedCheck(void);
+
+/* Time since the last control cycle in s, time base of the controller blocks */
+REAL32 git_test_AppCycleDt(void);
+
+/* Warm-up cycle of the control task, outputs must not be written, e.g. git_test_write_* */
+UINT32 git_test_AppDryRun(void);
+
 #endif
@@ -0,0 +1,536 @@
+/**
+********************************************************************************
+* @file     git_test_fb.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the function block runtime of the control
+*           task.
+*
+*           The blocks of git_test_FbList[] (git_test_control.c) declare
+*           their inputs and outputs as signal names. At BaseInit the
+*           runtime
+*           - resolves the names to indices into one signal array
+*           - sorts the blocks topologically (Kahn), so each block runs
+*             after the blocks which write its inputs; blocks without
+*             dependencies keep the order of the list
+*           - lays out the states contiguously in execution order and
+*             initializes them
+*           git_test_fb_cycle() then runs the flattened schedule: one call
+*           per block with a precomputed context, no lookups.
+*           Per block, SVI variables "Fb/<name>/Enable" (writable),
+*           "Fb/<name>/Time_us" and "Fb/<name>/MaxTime_us" are exported.
+*           The timing is measured as long as "Fb/Profile" is set.
+*           The states are kept on a warm restart, they are initialized
+*           again at the next BaseInit.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_fb.h"
+
+/* Defines: SVI variables */
+#define FB_NBOFVARS     3               /* SVI variables per block */
+#define FB_ALIGN        8               /* alignment of the block states */
+#define FB_NOBLOCK      0xFFFF          /* signal is external */
+
+/* Entry of the flattened schedule */
+typedef struct FB_ENTRY
+{
+    void    (*pCycle)(const GIT_TEST_FB_CTX *pCtx);
+    GIT_TEST_FB_CTX Ctx;
+} FB_ENTRY;
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 Fb_Resolve(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, UINT16 *pProducer);
+MLOCAL SINT32 Fb_Sort(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, const UINT16 *pProducer,
+                      UINT16 *pOrder);
+MLOCAL SINT32 Fb_Layout(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, const UINT16 *pOrder);
+MLOCAL SINT32 Fb_SignalIdx(const CHAR *pName, UINT32 Add);
+
+/* Global variables: schedule */
+MLOCAL FB_ENTRY FbSched[GIT_TEST_FB_MAXBLOCKS];
+MLOCAL UINT32 FbNbOfBlocks = 0;
+MLOCAL GIT_TEST_FB_ENV FbEnv;
+
+/* Global variables: signals and states */
+MLOCAL const CHAR *FbSigName[GIT_TEST_FB_MAXSIGNALS];
+MLOCAL REAL32 FbSig[GIT_TEST_FB_MAXSIGNALS];
+MLOCAL REAL32 FbSigSave[GIT_TEST_FB_MAXSIGNALS];
+MLOCAL UINT32 FbNbOfSignals = 0;
+MLOCAL UINT8 FbPool[GIT_TEST_FB_POOLSIZE] __attribute__ ((aligned(FB_ALIGN)));
+MLOCAL UINT8 FbPoolSave[GIT_TEST_FB_POOLSIZE] __attribute__ ((aligned(FB_ALIGN)));
+MLOCAL UINT32 FbPoolUsed = 0;
+
+/* Global variables: per block in execution order, exported via SVI */
+MLOCAL UINT32 FbEnable[GIT_TEST_FB_MAXBLOCKS];
+MLOCAL UINT32 FbTime_us[GIT_TEST_FB_MAXBLOCKS];
+MLOCAL UINT32 FbMaxTime_us[GIT_TEST_FB_MAXBLOCKS];
+MLOCAL UINT32 FbProfile = TRUE;
+MLOCAL UINT32 FbCycle_us = 0;
+MLOCAL CHAR FbVarName[GIT_TEST_FB_MAXBLOCKS * FB_NBOFVARS][SVI_ADDRLEN];
+MLOCAL SVI_GLOBVAR FbBlockVarList[GIT_TEST_FB_MAXBLOCKS * FB_NBOFVARS];
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR FbVarList[] = {
+    {"Fb/NbOfBlocks", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &FbNbOfBlocks, 0, 0, NULL, NULL, 0, NULL},
+    {"Fb/Profile", SVI_F_INOUT | SVI_F_UINT32, sizeof(UINT32),
+     &FbProfile, 0, 0, NULL, NULL, 0, NULL},
+    {"Fb/Cycle_us", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &FbCycle_us, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Builds the schedule of the blocks and registers the SVI variables.
+*        Called by the bTask at BaseInit, the control task is not running.
+*
+* @param[in]  pList       blocks, terminated by an entry with pType = NULL
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, e.g. a feedback loop
+*******************************************************************************/
+SINT32 git_test_fb_sviServerInit(const GIT_TEST_FB_BLOCK *pList)
+{
+    static const CHAR *pFunc = __func__;
+    static const CHAR *pSuffix[FB_NBOFVARS] = {"Enable", "Time_us", "MaxTime_us"};
+    static UINT32 *const pVars[FB_NBOFVARS] = {FbEnable, FbTime_us, FbMaxTime_us};
+    UINT16  Producer[GIT_TEST_FB_MAXSIGNALS];
+    UINT16  Order[GIT_TEST_FB_MAXBLOCKS];
+    UINT32  NbOfBlocks = 0;
+    SVI_GLOBVAR *pVar;
+    UINT32  idx;
+    UINT32  var;
+    SINT32  ret;
+
+    memset(FbSched, 0, sizeof(FbSched));
+    memset(FbBlockVarList, 0, sizeof(FbBlockVarList));
+    FbNbOfBlocks = 0;
+    FbNbOfSignals = 0;
+    FbPoolUsed = 0;
+
+    while (pList[NbOfBlocks].pType)
+    {
+        if (++NbOfBlocks > GIT_TEST_FB_MAXBLOCKS)
+        {
+            LOG_E(0, pFunc, "Too many blocks, maximum is %d", GIT_TEST_FB_MAXBLOCKS);
+            return (ERROR);
+        }
+    }
+
+    if ((Fb_Resolve(pList, NbOfBlocks, Producer) < 0) ||
+        (Fb_Sort(pList, NbOfBlocks, Producer, Order) < 0) ||
+        (Fb_Layout(pList, NbOfBlocks, Order) < 0))
+    {
+        return (ERROR);
+    }
+    FbNbOfBlocks = NbOfBlocks;
+
+    /* Per block, in execution order */
+    for (idx = 0; idx < NbOfBlocks; idx++)
+    {
+        FbEnable[idx] = TRUE;
+        FbTime_us[idx] = 0;
+        FbMaxTime_us[idx] = 0;
+
+        for (var = 0; var < FB_NBOFVARS; var++)
+        {
+            pVar = &FbBlockVarList[(idx * FB_NBOFVARS) + var];
+            snprintf(FbVarName[(idx * FB_NBOFVARS) + var], SVI_ADDRLEN, "Fb/%s/%s",
+                     pList[Order[idx]].pName, pSuffix[var]);
+            pVar->VarName = FbVarName[(idx * FB_NBOFVARS) + var];
+            pVar->Format = ((var == 0) ? SVI_F_INOUT : SVI_F_OUT) | SVI_F_UINT32;
+            pVar->Size = sizeof(UINT32);
+            pVar->pVar = &pVars[var][idx];
+        }
+    }
+
+    if (NbOfBlocks)
+    {
+        LOG_I(1, pFunc, "%d blocks, %d signals, %d bytes of state",
+              NbOfBlocks, FbNbOfSignals, FbPoolUsed);
+    }
+
+    ret = git_test_AppSviAddGlobVars(FbVarList, sizeof(FbVarList) / sizeof(SVI_GLOBVAR));
+    if ((ret < 0) || !NbOfBlocks)
+    {
+        return (ret);
+    }
+
+    return (git_test_AppSviAddGlobVars(FbBlockVarList, NbOfBlocks * FB_NBOFVARS));
+}
+
+/**
+********************************************************************************
+* @brief Runs all enabled blocks in the order of their data flow.
+*        Called by the control task once per cycle.
+*
+* @param[in]  pInVars     process image input data
+* @param[in,out] pOutVars  process image output data
+* @param[in]  Dt_s        time since the last cycle
+*******************************************************************************/
+void git_test_fb_cycle(const IN_VARS *pInVars, OUT_VARS *pOutVars, REAL32 Dt_s)
+{
+    FB_ENTRY *pEntry = FbSched;
+    UINT32  Start;
+    UINT32  CycleStart;
+    UINT32  Time;
+    UINT32  idx;
+
+    FbEnv.pInVars = pInVars;
+    FbEnv.pOutVars = pOutVars;
+    FbEnv.Dt_s = Dt_s;
+
+    if (!FbProfile)
+    {
+        for (idx = 0; idx < FbNbOfBlocks; idx++, pEntry++)
+        {
+            if (FbEnable[idx])
+            {
+                pEntry->pCycle(&pEntry->Ctx);
+            }
+        }
+        return;
+    }
+
+    CycleStart = m_GetProcTime();
+    for (idx = 0; idx < FbNbOfBlocks; idx++, pEntry++)
+    {
+        if (FbEnable[idx])
+        {
+            Start = m_GetProcTime();
+            pEntry->pCycle(&pEntry->Ctx);
+            Time = m_GetProcTime() - Start;
+
+            FbTime_us[idx] = Time;
+            if (Time > FbMaxTime_us[idx])
+            {
+                FbMaxTime_us[idx] = Time;
+            }
+        }
+    }
+    FbCycle_us = m_GetProcTime() - CycleStart;
+}
+
+/**
+********************************************************************************
+* @brief Searches a signal by its name.
+*
+* @param[in]  pName       signal name, case sensitive
+*
+* @retval     >= 0 .. index of the signal
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+SINT32 git_test_fb_findSignal(const CHAR *pName)
+{
+    return (Fb_SignalIdx(pName, FALSE));
+}
+
+/**
+********************************************************************************
+* @brief Returns a signal, e.g. to set an external input before
+*        git_test_fb_cycle() or to read a result after it.
+*
+* @param[in]  Idx         index of the signal
+*
+* @retval     signal, NULL for an unknown index
+*******************************************************************************/
+REAL32 *git_test_fb_signal(UINT32 Idx)
+{
+    return ((Idx < FbNbOfSignals) ? &FbSig[Idx] : NULL);
+}
+
+/**
+********************************************************************************
+* @brief Keeps a copy of all block states and signals.
+*******************************************************************************/
+void git_test_fb_stateSave(void)
+{
+    memcpy(FbPoolSave, FbPool, FbPoolUsed);
+    memcpy(FbSigSave, FbSig, FbNbOfSignals * sizeof(REAL32));
+}
+
+/**
+********************************************************************************
+* @brief Restores the copy of git_test_fb_stateSave().
+*******************************************************************************/
+void git_test_fb_stateRestore(void)
+{
+    memcpy(FbPool, FbPoolSave, FbPoolUsed);
+    memcpy(FbSig, FbSigSave, FbNbOfSignals * sizeof(REAL32));
+}
+
+/**
+********************************************************************************
+* @brief Clears the execution times of all blocks, e.g. the times of the
+*        first cycles with cold caches.
+*******************************************************************************/
+void git_test_fb_resetTimes(void)
+{
+    memset(FbTime_us, 0, sizeof(FbTime_us));
+    memset(FbMaxTime_us, 0, sizeof(FbMaxTime_us));
+    FbCycle_us = 0;
+}
+
+/**
+********************************************************************************
+* @brief Resolves the signal names of all blocks and finds the block which
+*        writes each signal.
+*
+* @param[in]  pList       blocks
+* @param[in]  NbOfBlocks  number of blocks
+* @param[out] pProducer   block which writes the signal, FB_NOBLOCK if external
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Fb_Resolve(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, UINT16 *pProducer)
+{
+    static const CHAR *pFunc = __func__;
+    const GIT_TEST_FB_BLOCK *pBlock;
+    SINT32  Sig;
+    UINT32  idx;
+    UINT32  io;
+
+    for (idx = 0; idx < GIT_TEST_FB_MAXSIGNALS; idx++)
+    {
+        pProducer[idx] = FB_NOBLOCK;
+    }
+
+    for (idx = 0; idx < NbOfBlocks; idx++)
+    {
+        pBlock = &pList[idx];
+        if ((pBlock->pType->NbOfIn > GIT_TEST_FB_MAXIO) ||
+            (pBlock->pType->NbOfOut > GIT_TEST_FB_MAXIO) || !pBlock->pType->pCycle)
+        {
+            LOG_E(0, pFunc, "Block '%s': bad type '%s'", pBlock->pName, pBlock->pType->pName);
+            return (ERROR);
+        }
+
+        for (io = 0; io < pBlock->pType->NbOfOut; io++)
+        {
+            Sig = pBlock->pOut[io] ? Fb_SignalIdx(pBlock->pOut[io], TRUE) : ERROR;
+            if (Sig < 0)
+            {
+                LOG_E(0, pFunc, "Block '%s': output %d missing or too many signals",
+                      pBlock->pName, io);
+                return (ERROR);
+            }
+            if (pProducer[Sig] != FB_NOBLOCK)
+            {
+                LOG_E(0, pFunc, "Signal '%s' is written by '%s' and '%s'", pBlock->pOut[io],
+                      pList[pProducer[Sig]].pName, pBlock->pName);
+                return (ERROR);
+            }
+            pProducer[Sig] = (UINT16)idx;
+        }
+    }
+
+    /* Inputs without a writing block are external */
+    for (idx = 0; idx < NbOfBlocks; idx++)
+    {
+        pBlock = &pList[idx];
+        for (io = 0; io < pBlock->pType->NbOfIn; io++)
+        {
+            if (!pBlock->pIn[io] || (Fb_SignalIdx(pBlock->pIn[io], TRUE) < 0))
+            {
+                LOG_E(0, pFunc, "Block '%s': input %d missing or too many signals",
+                      pBlock->pName, io);
+                return (ERROR);
+            }
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Sorts the blocks topologically (Kahn's algorithm).
+*        Of all blocks which are ready, the first one of the list is taken,
+*        so the order is deterministic.
+*
+* @param[in]  pList       blocks
+* @param[in]  NbOfBlocks  number of blocks
+* @param[in]  pProducer   block which writes each signal
+* @param[out] pOrder      indices into pList in execution order
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, feedback loop
+*******************************************************************************/
+MLOCAL SINT32 Fb_Sort(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, const UINT16 *pProducer,
+                      UINT16 *pOrder)
+{
+    static const CHAR *pFunc = __func__;
+    UINT16  NbOfDeps[GIT_TEST_FB_MAXBLOCKS];
+    UINT8   Done[GIT_TEST_FB_MAXBLOCKS];
+    UINT32  NbDone;
+    UINT32  Next;
+    UINT32  idx;
+    UINT32  io;
+    UINT16  Prod;
+
+    /* Number of inputs written by other blocks; a block reading its own output is a loop */
+    for (idx = 0; idx < NbOfBlocks; idx++)
+    {
+        NbOfDeps[idx] = 0;
+        Done[idx] = FALSE;
+        for (io = 0; io < pList[idx].pType->NbOfIn; io++)
+        {
+            if (pProducer[Fb_SignalIdx(pList[idx].pIn[io], FALSE)] != FB_NOBLOCK)
+            {
+                NbOfDeps[idx]++;
+            }
+        }
+    }
+
+    for (NbDone = 0; NbDone < NbOfBlocks; NbDone++)
+    {
+        for (Next = 0; Next < NbOfBlocks; Next++)
+        {
+            if (!Done[Next] && !NbOfDeps[Next])
+            {
+                break;
+            }
+        }
+
+        if (Next >= NbOfBlocks)
+        {
+            for (idx = 0; idx < NbOfBlocks; idx++)
+            {
+                if (!Done[idx])
+                {
+                    LOG_E(0, pFunc, "Block '%s' is part of a feedback loop", pList[idx].pName);
+                }
+            }
+            return (ERROR);
+        }
+
+        pOrder[NbDone] = (UINT16)Next;
+        Done[Next] = TRUE;
+
+        /* Inputs written by this block are satisfied */
+        for (idx = 0; idx < NbOfBlocks; idx++)
+        {
+            for (io = 0; io < pList[idx].pType->NbOfIn; io++)
+            {
+                Prod = pProducer[Fb_SignalIdx(pList[idx].pIn[io], FALSE)];
+                if (Prod == Next)
+                {
+                    NbOfDeps[idx]--;
+                }
+            }
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Creates the schedule: states in execution order and the context
+*        of each block.
+*
+* @param[in]  pList       blocks
+* @param[in]  NbOfBlocks  number of blocks
+* @param[in]  pOrder      execution order
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, state memory exhausted
+*******************************************************************************/
+MLOCAL SINT32 Fb_Layout(const GIT_TEST_FB_BLOCK *pList, UINT32 NbOfBlocks, const UINT16 *pOrder)
+{
+    const GIT_TEST_FB_BLOCK *pBlock;
+    FB_ENTRY *pEntry;
+    UINT32  Size;
+    UINT32  idx;
+    UINT32  io;
+
+    memset(FbSig, 0, sizeof(FbSig));
+
+    for (idx = 0; idx < NbOfBlocks; idx++)
+    {
+        pBlock = &pList[pOrder[idx]];
+        pEntry = &FbSched[idx];
+
+        Size = (pBlock->pType->StateSize + FB_ALIGN - 1) & ~(FB_ALIGN - 1);
+        if ((FbPoolUsed + Size) > sizeof(FbPool))
+        {
+            LOG_E(0, __func__, "Block '%s': state memory of %d bytes exhausted",
+                  pBlock->pName, sizeof(FbPool));
+            return (ERROR);
+        }
+
+        pEntry->pCycle = pBlock->pType->pCycle;
+        pEntry->Ctx.pState = Size ? &FbPool[FbPoolUsed] : NULL;
+        pEntry->Ctx.pParam = pBlock->pParam;
+        pEntry->Ctx.pSig = FbSig;
+        pEntry->Ctx.pEnv = &FbEnv;
+        for (io = 0; io < pBlock->pType->NbOfIn; io++)
+        {
+            pEntry->Ctx.In[io] = (UINT16)Fb_SignalIdx(pBlock->pIn[io], FALSE);
+        }
+        for (io = 0; io < pBlock->pType->NbOfOut; io++)
+        {
+            pEntry->Ctx.Out[io] = (UINT16)Fb_SignalIdx(pBlock->pOut[io], FALSE);
+        }
+
+        if (Size)
+        {
+            memset(pEntry->Ctx.pState, 0, Size);
+            if (pBlock->pType->pInit)
+            {
+                pBlock->pType->pInit(pEntry->Ctx.pState, pBlock->pParam);
+            }
+        }
+        FbPoolUsed += Size;
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns the index of a signal, optionally a new one is added.
+*
+* @param[in]  pName       signal name
+* @param[in]  Add         TRUE .. add if not found
+*
+* @retval     >= 0 .. index of the signal
+* @retval     < 0 .. ERROR, not found or too many signals
+*******************************************************************************/
+MLOCAL SINT32 Fb_SignalIdx(const CHAR *pName, UINT32 Add)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < FbNbOfSignals; idx++)
+    {
+        if (!strcmp(FbSigName[idx], pName))
+        {
+            return ((SINT32)idx);
+        }
+    }
+
+    if (!Add || (FbNbOfSignals >= GIT_TEST_FB_MAXSIGNALS))
+    {
+        return (ERROR);
+    }
+
+    FbSigName[FbNbOfSignals] = pName;
+    return ((SINT32)FbNbOfSignals++);
+}
@@ -0,0 +1,92 @@
+/**
+********************************************************************************
+* @file     git_test_fb.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the function block
+*           runtime of the control task.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_FB__H
+#define GIT_TEST_FB__H
+
+/* Defines: dimensions */
+#define GIT_TEST_FB_MAXBLOCKS   64      /* maximum number of blocks */
+#define GIT_TEST_FB_MAXIO       4       /* maximum number of inputs and of outputs per block */
+#define GIT_TEST_FB_MAXSIGNALS  256     /* maximum number of signals */
+#define GIT_TEST_FB_POOLSIZE    (16 * 1024) /* state memory of all blocks in bytes */
+
+/* Access to the signals of a block within its cycle function */
+#define GIT_TEST_FB_IN(pCtx, n)     ((pCtx)->pSig[(pCtx)->In[n]])
+#define GIT_TEST_FB_OUT(pCtx, n)    ((pCtx)->pSig[(pCtx)->Out[n]])
+
+/* Data of the current cycle, the same for all blocks */
+typedef struct GIT_TEST_FB_ENV
+{
+    const IN_VARS *pInVars;             /* process image input data */
+    OUT_VARS *pOutVars;                 /* process image output data */
+    REAL32  Dt_s;                       /* time since the last cycle */
+} GIT_TEST_FB_ENV;
+
+/* Context of a block, passed to its cycle function */
+typedef struct GIT_TEST_FB_CTX
+{
+    void    *pState;                    /* state of the block */
+    const void *pParam;                 /* parameters of the block */
+    REAL32  *pSig;                      /* all signals */
+    const GIT_TEST_FB_ENV *pEnv;        /* data of the current cycle */
+    UINT16  In[GIT_TEST_FB_MAXIO];      /* signal indices of the inputs */
+    UINT16  Out[GIT_TEST_FB_MAXIO];     /* signal indices of the outputs */
+} GIT_TEST_FB_CTX;
+
+/* Type of a block */
+typedef struct GIT_TEST_FB_TYPE
+{
+    const CHAR *pName;                  /* type name, for messages */
+    UINT32  StateSize;                  /* size of the state in bytes */
+    void    (*pInit)(void *pState, const void *pParam); /* NULL: state is cleared */
+    void    (*pCycle)(const GIT_TEST_FB_CTX *pCtx);
+    UINT32  NbOfIn;                     /* number of inputs */
+    UINT32  NbOfOut;                    /* number of outputs */
+} GIT_TEST_FB_TYPE;
+
+/*
+ * Instance of a block. Inputs and outputs are signal names: each signal
+ * has at most one block which writes it. Signals without such a block
+ * are external, they are set by the caller, see git_test_fb_signal().
+ * Feedback loops are not allowed; a block which needs the value of the
+ * last cycle keeps it in its state.
+ */
+typedef struct GIT_TEST_FB_BLOCK
+{
+    const CHAR *pName;                  /* unique name, SVI "Fb/<name>/..." */
+    const GIT_TEST_FB_TYPE *pType;      /* NULL terminates the list */
+    const CHAR *pIn[GIT_TEST_FB_MAXIO];
+    const CHAR *pOut[GIT_TEST_FB_MAXIO];
+    const void *pParam;                 /* parameters, e.g. a structure of the type */
+} GIT_TEST_FB_BLOCK;
+
+/*--- Functions ---*/
+
+/* bTask: sort the blocks, lay out their states and register the SVI variables */
+extern SINT32 git_test_fb_sviServerInit(const GIT_TEST_FB_BLOCK *pList);
+
+/* Control task: run all enabled blocks in the order of their data flow */
+extern void git_test_fb_cycle(const IN_VARS *pInVars, OUT_VARS *pOutVars, REAL32 Dt_s);
+
+/* Control task: external signals and results, index by git_test_fb_findSignal() */
+extern SINT32 git_test_fb_findSignal(const CHAR *pName);
+extern REAL32 *git_test_fb_signal(UINT32 Idx);
+
+/* Control task: keep and restore all states and signals, e.g. around dry-run cycles */
+extern void git_test_fb_stateSave(void);
+extern void git_test_fb_stateRestore(void);
+
+/* Control task: clear the execution times, e.g. after dry-run cycles */
+extern void git_test_fb_resetTimes(void);
+
+#endif /* Avoid problems with multiple include */
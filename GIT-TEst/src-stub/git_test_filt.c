@@ -0,0 +1,542 @@
+/**
+********************************************************************************
+* @file     git_test_filt.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the filter banks of the control task.
+*
+*           A bank runs the same filter on many channels, e.g. the analog
+*           inputs of the process image. The kernels loop over the channels
+*           in the inner loop with the coefficients as constants, so the
+*           compiler can vectorize them:
+*           - biquad: cascade of up to GIT_TEST_FILT_MAXSECT sections in
+*             transposed direct form II. The coefficients are derived from
+*             the design (low pass, high pass, notch, PT1) and the cycle
+*             time; they are derived again if the cycle time changes.
+*             The first run starts in steady state with the first value.
+*           - moving average over a window in seconds: ring of the last
+*             values with a running sum per channel in REAL64, so the sum
+*             does not drift. Until the ring is filled, the average is
+*             over the values available.
+*           The state memory is provided by the caller, there are no
+*           allocations. Use GIT_TEST_FILT_..._STATELEN() for its size.
+*           git_test_filt_bench() measures the kernels, it may be called
+*           from the shell.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_filt.h"
+
+/* Defines: design */
+#define FILT_PI         3.14159265358979
+#define FILT_QDEF       0.70710678      /* Q of a Butterworth section */
+#define FILT_FCMAX      0.45            /* maximum Fc * Dt, below Nyquist */
+
+/* Defines: benchmark */
+#define FILT_BENCHCYCLES    1000        /* cycles if not specified */
+#define FILT_BENCHDT        0.001       /* cycle time of the coefficients */
+#define FILT_BENCHWIN       16          /* window of the moving average in cycles */
+
+/* Functions: being called only within this file */
+MLOCAL void Filt_Derive(GIT_TEST_FILT_BANK *pBank, REAL32 Dt_s);
+MLOCAL void Filt_DesignSect(GIT_TEST_FILT_SECT *pSect, REAL32 Dt_s);
+MLOCAL void Filt_BiquadPrime(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn);
+MLOCAL void Filt_BiquadRun(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut);
+MLOCAL void Filt_MaRun(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut);
+
+/* Global variables: benchmark, state and signals */
+MLOCAL REAL32 FiltBenchBiquadState[GIT_TEST_FILT_BIQUAD_STATELEN(GIT_TEST_FILT_BENCHCHAN, 2)];
+MLOCAL REAL32 FiltBenchMaState[GIT_TEST_FILT_MA_STATELEN(GIT_TEST_FILT_BENCHCHAN, FILT_BENCHWIN)]
+    __attribute__ ((aligned(8)));
+MLOCAL REAL32 FiltBenchIn[GIT_TEST_FILT_BENCHCHAN];
+MLOCAL REAL32 FiltBenchOut[GIT_TEST_FILT_BENCHCHAN];
+
+/**
+********************************************************************************
+* @brief Sets up a bank of biquad cascades.
+*        The coefficients are derived at the first git_test_filt_run().
+*
+* @param[out] pBank       filter bank
+* @param[in]  NbOfChan    number of channels
+* @param[in]  pSect       design of the sections
+* @param[in]  NbOfSect    number of sections
+* @param[in]  pState      state memory, GIT_TEST_FILT_BIQUAD_STATELEN() elements
+* @param[in]  StateLen    number of elements of pState
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_filt_biquadInit(GIT_TEST_FILT_BANK *pBank, UINT32 NbOfChan,
+                                const GIT_TEST_FILT_SECT *pSect, UINT32 NbOfSect,
+                                REAL32 *pState, UINT32 StateLen)
+{
+    static const CHAR *pFunc = __func__;
+
+    if (!NbOfChan || !NbOfSect || (NbOfSect > GIT_TEST_FILT_MAXSECT) ||
+        (StateLen < GIT_TEST_FILT_BIQUAD_STATELEN(NbOfChan, NbOfSect)))
+    {
+        LOG_E(0, pFunc, "Bad biquad bank: %d channels, %d sections, state %d",
+              NbOfChan, NbOfSect, StateLen);
+        return (ERROR);
+    }
+
+    memset(pBank, 0, sizeof(*pBank));
+    pBank->Type = GIT_TEST_FILT_BIQUAD;
+    pBank->NbOfChan = NbOfChan;
+    pBank->NbOfSect = NbOfSect;
+    memcpy(pBank->Sect, pSect, NbOfSect * sizeof(GIT_TEST_FILT_SECT));
+    pBank->pState = pState;
+    pBank->StateLen = StateLen;
+    git_test_filt_reset(pBank);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Sets up a bank of moving averages.
+*        The window in cycles is derived at the first git_test_filt_run(),
+*        it is limited by the state memory.
+*
+* @param[out] pBank       filter bank
+* @param[in]  NbOfChan    number of channels
+* @param[in]  Window_s    length of the window
+* @param[in]  pState      state memory, GIT_TEST_FILT_MA_STATELEN() elements,
+*                         aligned to 8 bytes
+* @param[in]  StateLen    number of elements of pState
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_filt_maInit(GIT_TEST_FILT_BANK *pBank, UINT32 NbOfChan, REAL32 Window_s,
+                            REAL32 *pState, UINT32 StateLen)
+{
+    static const CHAR *pFunc = __func__;
+
+    if (!NbOfChan || (Window_s <= 0) || ((size_t)pState & (sizeof(REAL64) - 1)) ||
+        (StateLen < GIT_TEST_FILT_MA_STATELEN(NbOfChan, 1)))
+    {
+        LOG_E(0, pFunc, "Bad moving average bank: %d channels, state %d", NbOfChan, StateLen);
+        return (ERROR);
+    }
+
+    memset(pBank, 0, sizeof(*pBank));
+    pBank->Type = GIT_TEST_FILT_MA;
+    pBank->NbOfChan = NbOfChan;
+    pBank->Window_s = Window_s;
+    pBank->MaxWin = (StateLen / NbOfChan) - 2;
+    pBank->Win = 1;
+    pBank->pState = pState;
+    pBank->StateLen = StateLen;
+    git_test_filt_reset(pBank);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Clears the states of all channels.
+*        A biquad bank starts in steady state with the next value, a moving
+*        average with an empty ring.
+*
+* @param[in]  pBank       filter bank
+*******************************************************************************/
+void git_test_filt_reset(GIT_TEST_FILT_BANK *pBank)
+{
+    memset(pBank->pState, 0, pBank->StateLen * sizeof(REAL32));
+    pBank->Pos = 0;
+    pBank->Fill = 0;
+}
+
+/**
+********************************************************************************
+* @brief Copies an array of IN_VARS elements into REAL32 values.
+*
+* @param[in]  pSrc        array in the process image
+* @param[in]  pInVars     process image input data
+* @param[out] pDst        values, pSrc->NbOfChan elements
+*******************************************************************************/
+void git_test_filt_gather(const GIT_TEST_FILT_SRC *pSrc, const IN_VARS *pInVars, REAL32 *pDst)
+{
+    const UINT8 *pRaw = (const UINT8 *)pInVars + pSrc->Offset;
+    REAL32  Scale = pSrc->Scale ? pSrc->Scale : 1.0f;
+    UINT32  Size = (pSrc->Format == GIT_TEST_FILT_F_SINT16) ||
+                   (pSrc->Format == GIT_TEST_FILT_F_UINT16) ? sizeof(UINT16) : sizeof(UINT32);
+    UINT32  idx;
+    REAL32  Real;
+    SINT32  Sint32;
+    SINT16  Sint16;
+    UINT16  Uint16;
+
+    if (!pSrc->NbOfChan ||
+        ((pSrc->Offset + ((pSrc->NbOfChan - 1) * pSrc->Stride) + Size) > sizeof(IN_VARS)))
+    {
+        LOG_E(0, __func__, "Array exceeds the process image: offset %d, %d elements",
+              pSrc->Offset, pSrc->NbOfChan);
+        return;
+    }
+
+    /* Elements of the process image need not be aligned */
+    for (idx = 0; idx < pSrc->NbOfChan; idx++, pRaw += pSrc->Stride)
+    {
+        switch (pSrc->Format)
+        {
+            case GIT_TEST_FILT_F_SINT32:
+                memcpy(&Sint32, pRaw, sizeof(Sint32));
+                Real = (REAL32)Sint32;
+                break;
+            case GIT_TEST_FILT_F_SINT16:
+                memcpy(&Sint16, pRaw, sizeof(Sint16));
+                Real = (REAL32)Sint16;
+                break;
+            case GIT_TEST_FILT_F_UINT16:
+                memcpy(&Uint16, pRaw, sizeof(Uint16));
+                Real = (REAL32)Uint16;
+                break;
+            default:
+                memcpy(&Real, pRaw, sizeof(Real));
+                break;
+        }
+        pDst[idx] = Real * Scale;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Filters one value of each channel.
+*        Called once per cycle. If the cycle time has changed, the
+*        coefficients are derived again; a moving average then starts with
+*        an empty ring.
+*
+* @param[in]  pBank       filter bank
+* @param[in]  pIn         input values, one per channel
+* @param[out] pOut        filtered values, one per channel, may be pIn
+* @param[in]  Dt_s        cycle time, e.g. git_test_AppCycleDt()
+*******************************************************************************/
+void git_test_filt_run(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut, REAL32 Dt_s)
+{
+    if ((Dt_s != pBank->Dt_s) && (Dt_s > 0))
+    {
+        Filt_Derive(pBank, Dt_s);
+    }
+
+    if (pBank->Type == GIT_TEST_FILT_BIQUAD)
+    {
+        if (!pBank->Fill)
+        {
+            Filt_BiquadPrime(pBank, pIn);
+        }
+        Filt_BiquadRun(pBank, pIn, pOut);
+    }
+    else
+    {
+        Filt_MaRun(pBank, pIn, pOut);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Derives the coefficients or the window from the cycle time.
+*
+* @param[in]  pBank       filter bank
+* @param[in]  Dt_s        cycle time
+*******************************************************************************/
+MLOCAL void Filt_Derive(GIT_TEST_FILT_BANK *pBank, REAL32 Dt_s)
+{
+    UINT32  Win;
+    UINT32  idx;
+
+    if (pBank->Type == GIT_TEST_FILT_BIQUAD)
+    {
+        for (idx = 0; idx < pBank->NbOfSect; idx++)
+        {
+            Filt_DesignSect(&pBank->Sect[idx], Dt_s);
+        }
+    }
+    else
+    {
+        Win = (UINT32)((pBank->Window_s / Dt_s) + 0.5);
+        if (Win > pBank->MaxWin)
+        {
+            LOG_W(0, __func__, "Window of %d cycles limited to %d by the state memory",
+                  Win, pBank->MaxWin);
+            Win = pBank->MaxWin;
+        }
+        pBank->Win = Win ? Win : 1;
+        git_test_filt_reset(pBank);
+    }
+
+    pBank->Dt_s = Dt_s;
+}
+
+/**
+********************************************************************************
+* @brief Computes the coefficients of a biquad section, normalized to a0 = 1.
+*        Second order sections are from the bilinear transform with
+*        prewarping, PT1 from the exact step response.
+*
+* @param[in,out] pSect    section
+* @param[in]  Dt_s        cycle time
+*******************************************************************************/
+MLOCAL void Filt_DesignSect(GIT_TEST_FILT_SECT *pSect, REAL32 Dt_s)
+{
+    REAL64  Fc = pSect->Fc_Hz;
+    REAL64  Q = (pSect->Q > 0) ? pSect->Q : FILT_QDEF;
+    REAL64  W0, Cos, Alpha, A0, Pole;
+
+    if (pSect->Design == GIT_TEST_FILT_D_COEF)
+    {
+        return;
+    }
+
+    if ((Fc * Dt_s) > FILT_FCMAX)
+    {
+        LOG_W(0, __func__, "Frequency %d Hz limited below the Nyquist frequency", (SINT32)Fc);
+        Fc = FILT_FCMAX / Dt_s;
+    }
+    W0 = 2 * FILT_PI * Fc * Dt_s;
+    Cos = cos(W0);
+    Alpha = sin(W0) / (2 * Q);
+    A0 = 1 + Alpha;
+
+    switch (pSect->Design)
+    {
+        case GIT_TEST_FILT_D_PT1:
+            Pole = exp(-W0);
+            pSect->Coef[0] = (REAL32)(1 - Pole);
+            pSect->Coef[1] = 0;
+            pSect->Coef[2] = 0;
+            pSect->Coef[3] = (REAL32)-Pole;
+            pSect->Coef[4] = 0;
+            return;
+        case GIT_TEST_FILT_D_HIGHPASS:
+            pSect->Coef[0] = (REAL32)(((1 + Cos) / 2) / A0);
+            pSect->Coef[1] = (REAL32)(-(1 + Cos) / A0);
+            pSect->Coef[2] = pSect->Coef[0];
+            break;
+        case GIT_TEST_FILT_D_NOTCH:
+            pSect->Coef[0] = (REAL32)(1 / A0);
+            pSect->Coef[1] = (REAL32)((-2 * Cos) / A0);
+            pSect->Coef[2] = pSect->Coef[0];
+            break;
+        default:
+            pSect->Coef[0] = (REAL32)(((1 - Cos) / 2) / A0);
+            pSect->Coef[1] = (REAL32)((1 - Cos) / A0);
+            pSect->Coef[2] = pSect->Coef[0];
+            break;
+    }
+    pSect->Coef[3] = (REAL32)((-2 * Cos) / A0);
+    pSect->Coef[4] = (REAL32)((1 - Alpha) / A0);
+}
+
+/**
+********************************************************************************
+* @brief Sets the states of all sections to the steady state of the input
+*        values, so the filters do not start with a step from zero.
+*
+* @param[in]  pBank       filter bank
+* @param[in]  pIn         input values, one per channel
+*******************************************************************************/
+MLOCAL void Filt_BiquadPrime(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn)
+{
+    UINT32  Nb = pBank->NbOfChan;
+    REAL32  *pZ1, *pZ2;
+    REAL32  X, Y, Gain;
+    const REAL32 *pC;
+    UINT32  Sect;
+    UINT32  idx;
+
+    for (idx = 0; idx < Nb; idx++)
+    {
+        X = pIn[idx];
+        for (Sect = 0; Sect < pBank->NbOfSect; Sect++)
+        {
+            pC = pBank->Sect[Sect].Coef;
+            pZ1 = pBank->pState + (2 * Sect * Nb);
+            pZ2 = pZ1 + Nb;
+
+            /* DC gain of the section */
+            Gain = 1 + pC[3] + pC[4];
+            Gain = (Gain != 0) ? ((pC[0] + pC[1] + pC[2]) / Gain) : 0;
+            Y = Gain * X;
+            pZ1[idx] = Y - (pC[0] * X);
+            pZ2[idx] = (pC[2] * X) - (pC[4] * Y);
+            X = Y;
+        }
+    }
+
+    pBank->Fill = 1;
+}
+
+/**
+********************************************************************************
+* @brief Biquad kernel: one section after the other over all channels.
+*
+* @param[in]  pBank       filter bank
+* @param[in]  pIn         input values, one per channel
+* @param[out] pOut        filtered values, one per channel
+*******************************************************************************/
+MLOCAL void Filt_BiquadRun(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut)
+{
+    UINT32  Nb = pBank->NbOfChan;
+    UINT32  Sect;
+    UINT32  idx;
+
+    for (Sect = 0; Sect < pBank->NbOfSect; Sect++)
+    {
+        const REAL32 *pX = Sect ? pOut : pIn;
+        REAL32  *pZ1 = pBank->pState + (2 * Sect * Nb);
+        REAL32  *pZ2 = pZ1 + Nb;
+        REAL32  B0 = pBank->Sect[Sect].Coef[0];
+        REAL32  B1 = pBank->Sect[Sect].Coef[1];
+        REAL32  B2 = pBank->Sect[Sect].Coef[2];
+        REAL32  A1 = pBank->Sect[Sect].Coef[3];
+        REAL32  A2 = pBank->Sect[Sect].Coef[4];
+
+        for (idx = 0; idx < Nb; idx++)
+        {
+            REAL32  X = pX[idx];
+            REAL32  Y = (B0 * X) + pZ1[idx];
+
+            pZ1[idx] = (B1 * X) - (A1 * Y) + pZ2[idx];
+            pZ2[idx] = (B2 * X) - (A2 * Y);
+            pOut[idx] = Y;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Moving average kernel.
+*        State memory: REAL64 sums of all channels, then the ring with one
+*        row of all channels per position.
+*
+* @param[in]  pBank       filter bank
+* @param[in]  pIn         input values, one per channel
+* @param[out] pOut        filtered values, one per channel
+*******************************************************************************/
+MLOCAL void Filt_MaRun(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut)
+{
+    UINT32  Nb = pBank->NbOfChan;
+    REAL64  *pSum = (REAL64 *)pBank->pState;
+    REAL32  *pRow = pBank->pState + (2 * Nb) + (pBank->Pos * Nb);
+    REAL64  InvFill;
+    UINT32  idx;
+
+    /* Until the ring is filled, the oldest values are zero */
+    if (pBank->Fill < pBank->Win)
+    {
+        pBank->Fill++;
+    }
+    InvFill = 1.0 / pBank->Fill;
+
+    for (idx = 0; idx < Nb; idx++)
+    {
+        REAL32  X = pIn[idx];
+
+        pSum[idx] += (REAL64)X - pRow[idx];
+        pRow[idx] = X;
+        pOut[idx] = (REAL32)(pSum[idx] * InvFill);
+    }
+
+    pBank->Pos = (pBank->Pos + 1 < pBank->Win) ? (pBank->Pos + 1) : 0;
+}
+
+/**
+********************************************************************************
+* @brief Measures the filter kernels with a biquad bank (two low pass
+*        sections) and a moving average over FILT_BENCHWIN cycles.
+*        May be called from the shell, e.g. "git_test_filt_bench 256,1000".
+*        The result is printed and logged. Note that the calling task may
+*        be interrupted by the tasks of higher priority.
+*
+* @param[in]  NbOfChan    number of channels, 0 = GIT_TEST_FILT_BENCHCHAN
+* @param[in]  NbOfCycles  number of cycles, 0 = FILT_BENCHCYCLES
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_filt_bench(UINT32 NbOfChan, UINT32 NbOfCycles)
+{
+    static const CHAR *pFunc = __func__;
+    GIT_TEST_FILT_SECT Sect[2];
+    GIT_TEST_FILT_BANK Biquad;
+    GIT_TEST_FILT_BANK Ma;
+    UINT32  Start;
+    UINT32  Biquad_us;
+    UINT32  Ma_us;
+    REAL64  Per;
+    UINT32  Cycle;
+    UINT32  idx;
+
+    NbOfChan = NbOfChan ? NbOfChan : GIT_TEST_FILT_BENCHCHAN;
+    NbOfCycles = NbOfCycles ? NbOfCycles : FILT_BENCHCYCLES;
+    if (NbOfChan > GIT_TEST_FILT_BENCHCHAN)
+    {
+        printf("%s: maximum is %d channels\n", pFunc, GIT_TEST_FILT_BENCHCHAN);
+        return (ERROR);
+    }
+
+    memset(Sect, 0, sizeof(Sect));
+    Sect[0].Design = GIT_TEST_FILT_D_LOWPASS;
+    Sect[0].Fc_Hz = 50;
+    Sect[1] = Sect[0];
+    if ((git_test_filt_biquadInit(&Biquad, NbOfChan, Sect, 2, FiltBenchBiquadState,
+                                  sizeof(FiltBenchBiquadState) / sizeof(REAL32)) < 0) ||
+        (git_test_filt_maInit(&Ma, NbOfChan, FILT_BENCHWIN * FILT_BENCHDT, FiltBenchMaState,
+                              sizeof(FiltBenchMaState) / sizeof(REAL32)) < 0))
+    {
+        return (ERROR);
+    }
+
+    for (idx = 0; idx < NbOfChan; idx++)
+    {
+        FiltBenchIn[idx] = (REAL32)idx;
+    }
+
+    /* First run derives the coefficients, it is not measured */
+    git_test_filt_run(&Biquad, FiltBenchIn, FiltBenchOut, FILT_BENCHDT);
+    git_test_filt_run(&Ma, FiltBenchIn, FiltBenchOut, FILT_BENCHDT);
+
+    Start = m_GetProcTime();
+    for (Cycle = 0; Cycle < NbOfCycles; Cycle++)
+    {
+        FiltBenchIn[Cycle % NbOfChan] += 1.0f;
+        git_test_filt_run(&Biquad, FiltBenchIn, FiltBenchOut, FILT_BENCHDT);
+    }
+    Biquad_us = m_GetProcTime() - Start;
+
+    Start = m_GetProcTime();
+    for (Cycle = 0; Cycle < NbOfCycles; Cycle++)
+    {
+        FiltBenchIn[Cycle % NbOfChan] += 1.0f;
+        git_test_filt_run(&Ma, FiltBenchIn, FiltBenchOut, FILT_BENCHDT);
+    }
+    Ma_us = m_GetProcTime() - Start;
+
+    Per = 1000.0 / ((REAL64)NbOfChan * NbOfCycles);
+    printf("%s: %d channels, %d cycles\n", pFunc, NbOfChan, NbOfCycles);
+    printf("  biquad (2 sections): %.1f ns per channel and cycle\n", Biquad_us * Per);
+    printf("  moving average:      %.1f ns per channel and cycle\n", Ma_us * Per);
+    LOG_I(0, pFunc, "%d channels: biquad %d ns, moving average %d ns per channel and cycle",
+          NbOfChan, (SINT32)(Biquad_us * Per + 0.5), (SINT32)(Ma_us * Per + 0.5));
+
+    return (OK);
+}
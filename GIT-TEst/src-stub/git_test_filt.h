@@ -0,0 +1,114 @@
+/**
+********************************************************************************
+* @file     git_test_filt.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the filter banks of the
+*           control task.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_FILT__H
+#define GIT_TEST_FILT__H
+
+/* Defines: filter banks */
+#define GIT_TEST_FILT_MAXSECT   4       /* maximum number of biquad sections */
+#define GIT_TEST_FILT_BENCHCHAN 256     /* maximum number of channels of git_test_filt_bench() */
+
+/* Defines: topology of a bank */
+#define GIT_TEST_FILT_BIQUAD    0       /* cascade of biquad sections */
+#define GIT_TEST_FILT_MA        1       /* moving average */
+
+/* Defines: design of a biquad section */
+#define GIT_TEST_FILT_D_COEF    0       /* coefficients set directly */
+#define GIT_TEST_FILT_D_PT1     1       /* first order low pass */
+#define GIT_TEST_FILT_D_LOWPASS 2       /* second order low pass */
+#define GIT_TEST_FILT_D_HIGHPASS 3      /* second order high pass */
+#define GIT_TEST_FILT_D_NOTCH   4       /* notch */
+
+/* Defines: format of the process image elements, see git_test_filt_gather() */
+#define GIT_TEST_FILT_F_REAL32  0
+#define GIT_TEST_FILT_F_SINT32  1
+#define GIT_TEST_FILT_F_SINT16  2
+#define GIT_TEST_FILT_F_UINT16  3
+
+/*
+ * State memory to be provided by the caller, number of REAL32 elements.
+ * A moving average also holds a REAL64 sum per channel.
+ */
+#define GIT_TEST_FILT_BIQUAD_STATELEN(NbOfChan, NbOfSect)   (2 * (NbOfChan) * (NbOfSect))
+#define GIT_TEST_FILT_MA_STATELEN(NbOfChan, MaxWin)         (((MaxWin) + 2) * (NbOfChan))
+
+/*
+ * Array of equally spaced elements of IN_VARS, e.g. analog inputs.
+ * Value = raw value * Scale.
+ */
+typedef struct GIT_TEST_FILT_SRC
+{
+    UINT32  Offset;                     /* byte offset of the first element in IN_VARS */
+    UINT32  Stride;                     /* distance of the elements in bytes */
+    UINT32  Format;                     /* GIT_TEST_FILT_F_... */
+    REAL32  Scale;                      /* engineering units per raw unit, 0 = 1.0 */
+    UINT32  NbOfChan;                   /* number of elements */
+} GIT_TEST_FILT_SRC;
+
+/* Design of a biquad section, the coefficients are derived from the cycle time */
+typedef struct GIT_TEST_FILT_SECT
+{
+    UINT32  Design;                     /* GIT_TEST_FILT_D_... */
+    REAL32  Fc_Hz;                      /* corner or center frequency */
+    REAL32  Q;                          /* quality, 0 = 0.7071 (Butterworth) */
+    REAL32  Coef[5];                    /* b0, b1, b2, a1, a2 (a0 = 1) */
+} GIT_TEST_FILT_SECT;
+
+/*
+ * Bank of filters with identical topology and coefficients, one filter
+ * per channel. The state is stored channel by channel for each section
+ * (or ring position), so the kernels run over contiguous arrays.
+ */
+typedef struct GIT_TEST_FILT_BANK
+{
+    UINT32  Type;                       /* GIT_TEST_FILT_BIQUAD or _MA */
+    UINT32  NbOfChan;                   /* number of channels */
+    REAL32  Dt_s;                       /* cycle time of the coefficients, 0 = not yet derived */
+
+    /* biquad */
+    UINT32  NbOfSect;                   /* number of sections */
+    GIT_TEST_FILT_SECT Sect[GIT_TEST_FILT_MAXSECT];
+
+    /* moving average */
+    REAL32  Window_s;                   /* length of the window */
+    UINT32  MaxWin;                     /* maximum window in cycles, by the state memory */
+    UINT32  Win;                        /* window in cycles */
+    UINT32  Pos;                        /* next position in the ring */
+    UINT32  Fill;                       /* number of values in the ring */
+
+    REAL32  *pState;                    /* state memory of the caller */
+    UINT32  StateLen;                   /* number of REAL32 elements */
+} GIT_TEST_FILT_BANK;
+
+/*--- Functions ---*/
+
+/* Any task: set up a bank on state memory of the caller, not task safe with git_test_filt_run() */
+extern SINT32 git_test_filt_biquadInit(GIT_TEST_FILT_BANK *pBank, UINT32 NbOfChan,
+                                       const GIT_TEST_FILT_SECT *pSect, UINT32 NbOfSect,
+                                       REAL32 *pState, UINT32 StateLen);
+extern SINT32 git_test_filt_maInit(GIT_TEST_FILT_BANK *pBank, UINT32 NbOfChan, REAL32 Window_s,
+                                   REAL32 *pState, UINT32 StateLen);
+extern void git_test_filt_reset(GIT_TEST_FILT_BANK *pBank);
+
+/* Control task: values of an IN_VARS array as REAL32 */
+extern void git_test_filt_gather(const GIT_TEST_FILT_SRC *pSrc, const IN_VARS *pInVars,
+                                 REAL32 *pDst);
+
+/* Control task: filter one value per channel, pIn and pOut may be the same */
+extern void git_test_filt_run(GIT_TEST_FILT_BANK *pBank, const REAL32 *pIn, REAL32 *pOut,
+                              REAL32 Dt_s);
+
+/* Any task (shell): measure the filter kernels, result in ns per channel and cycle */
+extern SINT32 git_test_filt_bench(UINT32 NbOfChan, UINT32 NbOfCycles);
+
+#endif /* Avoid problems with multiple include */
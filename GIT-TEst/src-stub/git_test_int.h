@@ -15,6 +15,7 @@
 #define GIT_TEST_INT__H
 
 #include "..\src-gen\git_test_pi.h"
+#include "git_test_log.h"
 
 /* Defines: SMI server */
 #define GIT_TEST_MINVERS     2        /* min. version number */
@@ -33,11 +34,19 @@ typedef struct GIT_TEST_BASE_PARMS
 
 extern GIT_TEST_BASE_PARMS git_test_BaseParams;
 
-/* Logging macros (single line, so that it does not need parentheses in the code */
-#define LOG_I(Level, FuncName, Text, Args...) do{ if(git_test_DebugMode >= Level) { log_Info("%s: %s: " Text, "git_test", FuncName, ## Args); }}while(0)
-#define LOG_W(Level, FuncName, Text, Args...) do{ if(git_test_DebugMode >= Level) { log_Wrn ("%s: %s: " Text, "git_test", FuncName, ## Args); }}while(0)
-#define LOG_E(Level, FuncName, Text, Args...) do{ if(git_test_DebugMode >= Level) { log_Err ("%s: %s: " Text, "git_test", FuncName, ## Args); }}while(0)
-#define LOG_U(Level, FuncName, Text, Args...) do{ if(git_test_DebugMode >= Level) { log_User("%s: %s: " Text, "git_test", FuncName, ## Args); }}while(0)
+/*
+ * Logging macros (single line, so that it does not need parentheses in the code
+ * Calls above GIT_TEST_LOG_MAX_LEVEL are removed at compile time,
+ * each call site is rate limited by a token bucket of its own.
+ */
+#define LOG_X(Type, Level, FuncName, Text, Args...) do{ static GIT_TEST_LOG_LIMIT Limit_; if(((Level) <= GIT_TEST_LOG_MAX_LEVEL) && (git_test_DebugMode >= (Level)) && git_test_log_limit(&Limit_, Type, FuncName)) { git_test_log_put(Type, "%s: %s: " Text, "git_test", FuncName, ## Args); }}while(0)
+#define LOG_I(Level, FuncName, Text, Args...) LOG_X(GIT_TEST_LOG_INFO, Level, FuncName, Text, ## Args)
+#define LOG_W(Level, FuncName, Text, Args...) LOG_X(GIT_TEST_LOG_WRN,  Level, FuncName, Text, ## Args)
+#define LOG_E(Level, FuncName, Text, Args...) LOG_X(GIT_TEST_LOG_ERR,  Level, FuncName, Text, ## Args)
+#define LOG_U(Level, FuncName, Text, Args...) LOG_X(GIT_TEST_LOG_USER, Level, FuncName, Text, ## Args)
+
+/* Memory barrier for data exchange between tasks without semaphores */
+#define GIT_TEST_MEMBARRIER()   __sync_synchronize()
 
 typedef struct CYCLIC_CFG
 {
@@ -74,6 +83,23 @@ typedef struct TASK_PROPERTIES
     UINT32  NbOfCycleBacklogs;          /* total nb of cycles within a backlog */
     UINT32  NbOfSkippedCycles;          /* total nb of cycles skipped due to backlog */
     UINT32  TimeBase;                   /* selection of time base */
+    UINT32  Wcet_us;                    /* declared worst case execution time, 0 = unknown */
+    UINT32  ResumeAlign;                /* resume from STOP in the common phase */
+    UINT32  WarmupCycles;               /* dry-run cycles before the first cycle */
+    volatile UINT32 WarmupDone;         /* warm-up cycles are finished */
+    UINT32  MaxRespTime_us;             /* measured maximum response time of a cycle, incl. preemption */
+    UINT32  CycleStartTime;             /* m_GetProcTime() at start of current cycle */
+    UINT32  PrevCycleStartTime;         /* m_GetProcTime() at start of the last cycle, 0 = none since RUN */
+    UINT32  Period_us;                  /* nominal period in us, ticks or syncs, 0 = unknown */
+    volatile SINT32 ExcSignal;          /* signal of a pending exception, 0 = none */
+    UINT32  FaultTime;                  /* m_GetProcTime() at the exception */
+    UINT32  LastExcSignal;              /* signal of the last exception */
+    UINT32  NbOfRestarts;               /* successful restarts after an exception */
+    UINT32  NbOfRestartFails;           /* failed restarts after an exception */
+    UINT32  RestartTime_us;             /* time from the last exception until restart */
+    UINT32  RestartTick;                /* tickGet() of the last successful restart */
+    UINT32  AttemptTick;                /* tickGet() of the last restart, also a failed one */
+    UINT32  PiInit;                     /* git_test_pi_init() has been called for this task */
     CYCLIC_CFG *pCyclicCfg;             /* information about cyclic-configuration, NULL if not used */
     SYNC_CFG *pSyncCfg;                 /* information about interrupt-configuration, NULL if not used */
     IN_VARS inVars;                     /* process image input data */
@@ -120,6 +146,7 @@ typedef struct SVI_VIRTVAR
     UINT32  Wpar2;
     SINT32(*ReadFunction) ();           /* Pointer to read-access function */
     SINT32(*WriteFunction) ();          /* Pointer to write-access function */
+    SINT32  VarHandle;                  /* Handle of the SVI variable (returned by svi_AddVirtVar()) */
 } SVI_VIRTVAR;
 
 /* Parameters for application specific SMI reply functions */
@@ -141,6 +168,8 @@ extern SMI_ID *git_test_pSmiId;       /* Id for standard module interface */
 extern UINT32 git_test_ModState;      /* Module state */
 extern SEM_ID git_test_StateSema;     /* Semaphore for halting tasks */
 extern CHAR git_test_Version[M_VERSTRGLEN_A]; /* Module version string */
+extern SINT32 git_test_bTaskId;       /* Task id of the bTask */
+extern UINT32 git_test_bTaskStackSize; /* Stack size of the bTask in bytes */
 
 /* Function pointer to application specific smi server */
 extern  SINT32(*git_test_fpAppSmiSvr) (SMI_MSG * pMsg, UINT32 SessionId);
@@ -159,6 +188,14 @@ extern SINT32 git_test_AppSmiSvr(SMI_MSG * pMsg, UINT32 SessionId);
 extern SINT32 git_test_AppEOI(void);
 extern void git_test_AppDeinit(void);
 extern SINT32 git_test_CfgRead(void);
+extern SINT32 git_test_AppNewCfg(void);
+extern void git_test_AppIdle(void);
+extern void git_test_AppResume(void);
+extern void git_test_AppArenaRelease(void);
+extern SINT32 git_test_AppSviInit(void);
+extern void git_test_AppSviDeinit(void);
+extern SINT32 git_test_AppSviAddGlobVars(SVI_GLOBVAR *pVarList, UINT32 NbOfVars);
+extern SINT32 git_test_AppSviAddVirtVars(SVI_VIRTVAR *pVarList, UINT32 NbOfVars);
 
 
 #endif /* Avoid problems with multiple include */
@@ -0,0 +1,688 @@
+/**
+********************************************************************************
+* @file     git_test_log.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the deferred logging of the real-time tasks.
+*
+*           A task which has been attached with git_test_log_attach() does
+*           not format its messages. It only records the format string
+*           pointer, the arguments and a time stamp in a ring of its own.
+*           The bTask formats the entries in git_test_log_drain() and writes
+*           them to the system log, so the real-time task neither pays for
+*           the formatting nor waits for the lock of the system log.
+*           Each ring has exactly one writer (the attached task) and one
+*           reader (the bTask), so no lock is needed.
+*           If a ring is full, the message is dropped and counted.
+*
+*           Restrictions of deferred messages:
+*           - the format string must be a literal, only the pointer is kept
+*           - strings are copied, arguments larger than GIT_TEST_LOG_ARGLEN
+*             bytes in total are cut off
+*           - '*' for width or precision is not supported, the message is
+*             cut off at that conversion
+*           Messages of tasks which are not attached are written directly.
+*
+*           Each LOG_x call site has a token bucket, see git_test_log_limit().
+*           A call site logs GIT_TEST_LOG_BURST messages at once and then
+*           GIT_TEST_LOG_RATE messages per second, so an error reported in
+*           every cycle does not flood the log. The number of suppressed
+*           messages is logged with the next message of the call site.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <tickLib.h>
+#include <sysLib.h>
+#include <intLib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_log.h"
+
+/* Defines: formatting */
+#define LOG_LINELEN     256             /* maximum length of a formatted message */
+#define LOG_SPECLEN     16              /* maximum length of a single conversion */
+
+/* Type of the argument of a conversion */
+enum logArg {LOG_ARG_NONE, LOG_ARG_INT, LOG_ARG_LONG, LOG_ARG_LLONG,
+             LOG_ARG_DOUBLE, LOG_ARG_PTR, LOG_ARG_STR, LOG_ARG_BAD};
+
+/* Recorded message */
+typedef struct LOG_ENTRY
+{
+    const CHAR *pFmt;                   /* format string, not copied */
+    UINT32  Time;                       /* m_GetProcTime() when recorded */
+    UINT16  Type;                       /* see enum gitTestLogType */
+    UINT16  NbArgs;                     /* number of recorded arguments */
+    UINT8   Args[GIT_TEST_LOG_ARGLEN];  /* arguments, packed */
+} LOG_ENTRY;
+
+/* Ring of one attached task */
+typedef struct LOG_RING
+{
+    volatile SINT32 TaskId;             /* attached task, 0 = free */
+    volatile UINT32 Head;               /* next entry to write, attached task only */
+    volatile UINT32 Tail;               /* next entry to read, bTask only */
+    volatile UINT32 Dropped;            /* messages dropped, attached task only */
+    UINT32  DroppedReported;            /* Dropped already reported, bTask only */
+    LOG_ENTRY Entry[GIT_TEST_LOG_RINGLEN];
+} LOG_RING;
+
+/* Functions: being called only within this file */
+MLOCAL LOG_RING *Log_Ring(SINT32 TaskId);
+MLOCAL UINT32 Log_Spec(const CHAR *pSpec, UINT32 *pLen);
+MLOCAL void Log_Record(LOG_ENTRY *pEntry, va_list Args);
+MLOCAL void Log_Format(const LOG_ENTRY *pEntry, CHAR *pLine, UINT32 LineLen);
+MLOCAL void Log_Write(UINT32 Type, const CHAR *pLine);
+
+/* Global variables: log rings */
+MLOCAL LOG_RING LogRing[GIT_TEST_LOG_NBRINGS];
+MLOCAL UINT32 LogDropped = 0;           /* total number of dropped messages */
+MLOCAL UINT32 LogSuppressed = 0;        /* total number of rate limited messages */
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR LogVarList[] = {
+    {"Log/Dropped", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &LogDropped, 0, 0, NULL, NULL, 0, NULL},
+    {"Log/Suppressed", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &LogSuppressed, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Logs a message. Called by the LOG_x macros.
+*        For an attached task the message is recorded in its ring,
+*        otherwise it is formatted and written directly.
+*
+* @param[in]  Type        destination, see enum gitTestLogType
+* @param[in]  pFmt        format string as for printf
+*******************************************************************************/
+void git_test_log_put(UINT32 Type, const CHAR *pFmt, ...)
+{
+    LOG_RING *pRing = NULL;
+    LOG_ENTRY *pEntry;
+    CHAR    Line[LOG_LINELEN];
+    va_list Args;
+    UINT32  Head;
+
+    if (!intContext())
+    {
+        pRing = Log_Ring(taskIdSelf());
+    }
+
+    /* Not attached: as before */
+    if (!pRing)
+    {
+        va_start(Args, pFmt);
+        (void)vsnprintf(Line, sizeof(Line), pFmt, Args);
+        va_end(Args);
+        Log_Write(Type, Line);
+        return;
+    }
+
+    Head = pRing->Head;
+    if ((Head - pRing->Tail) >= GIT_TEST_LOG_RINGLEN)
+    {
+        pRing->Dropped++;
+        return;
+    }
+
+    pEntry = &pRing->Entry[Head & (GIT_TEST_LOG_RINGLEN - 1)];
+    pEntry->pFmt = pFmt;
+    pEntry->Time = m_GetProcTime();
+    pEntry->Type = (UINT16)Type;
+
+    va_start(Args, pFmt);
+    Log_Record(pEntry, Args);
+    va_end(Args);
+
+    /* Entry must be complete before the bTask can see it */
+    GIT_TEST_MEMBARRIER();
+    pRing->Head = Head + 1;
+}
+
+/**
+********************************************************************************
+* @brief Rate limit of a LOG_x call site.
+*        The bucket holds up to GIT_TEST_LOG_BURST messages worth of ticks,
+*        each message takes the ticks of 1 / GIT_TEST_LOG_RATE seconds.
+*        Before the first message after a suppression, the number of
+*        suppressed messages is logged.
+*        A call site used by several tasks may miscount, which is accepted.
+*
+* @param[in]  pLimit      token bucket of the call site
+* @param[in]  Type        destination, see enum gitTestLogType
+* @param[in]  pFuncName   function name of the call site
+*
+* @retval     TRUE .. log the message
+* @retval     FALSE .. message is suppressed
+*******************************************************************************/
+UINT32 git_test_log_limit(GIT_TEST_LOG_LIMIT *pLimit, UINT32 Type, const CHAR *pFuncName)
+{
+    UINT32  Now = tickGet();
+    UINT32  Cost = sysClkRateGet() / GIT_TEST_LOG_RATE;
+    UINT32  Credit;
+    UINT32  Suppressed;
+
+    if (Cost < 1)
+    {
+        Cost = 1;
+    }
+
+    /* Refill by the time elapsed, the first call starts with a full bucket */
+    Credit = pLimit->Credit + (Now - pLimit->LastTick);
+    if ((Credit > (GIT_TEST_LOG_BURST * Cost)) || (Credit < pLimit->Credit))
+    {
+        Credit = GIT_TEST_LOG_BURST * Cost;
+    }
+    pLimit->LastTick = Now;
+
+    if (Credit < Cost)
+    {
+        pLimit->Credit = Credit;
+        pLimit->Suppressed++;
+        LogSuppressed++;
+        return (FALSE);
+    }
+    pLimit->Credit = Credit - Cost;
+
+    Suppressed = pLimit->Suppressed;
+    if (Suppressed)
+    {
+        pLimit->Suppressed = 0;
+        git_test_log_put(Type, "%s: %s: %d messages suppressed", "git_test", pFuncName, Suppressed);
+    }
+
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Attaches the calling task to a free ring.
+*        From now on, all messages of the task are deferred.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no free ring, messages are written directly
+*******************************************************************************/
+SINT32 git_test_log_attach(void)
+{
+    static const CHAR *pFunc = __func__;
+    SINT32  TaskId = taskIdSelf();
+    UINT32  idx;
+
+    if (Log_Ring(TaskId))
+    {
+        return (OK);
+    }
+
+    for (idx = 0; idx < GIT_TEST_LOG_NBRINGS; idx++)
+    {
+        if (__sync_bool_compare_and_swap(&LogRing[idx].TaskId, 0, TaskId))
+        {
+            return (OK);
+        }
+    }
+
+    LOG_W(0, pFunc, "No free log ring, messages of this task are not deferred");
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Detaches the calling task from its ring.
+*        Messages which are still in the ring are written by the next drain.
+*******************************************************************************/
+void git_test_log_detach(void)
+{
+    LOG_RING *pRing = Log_Ring(taskIdSelf());
+
+    if (pRing)
+    {
+        GIT_TEST_MEMBARRIER();
+        pRing->TaskId = 0;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Formats all recorded messages and writes them to the system log.
+*        Called by the bTask in the idle hook and at deinit.
+*        Rings of tasks which have been deleted without detaching are freed.
+*******************************************************************************/
+void git_test_log_drain(void)
+{
+    static const CHAR *pFunc = __func__;
+    LOG_RING *pRing;
+    const LOG_ENTRY *pEntry;
+    CHAR    Line[LOG_LINELEN];
+    SINT32  TaskId;
+    UINT32  Type;
+    UINT32  Tail;
+    UINT32  Dropped;
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_LOG_NBRINGS; idx++)
+    {
+        pRing = &LogRing[idx];
+        TaskId = pRing->TaskId;
+
+        for (Tail = pRing->Tail; Tail != pRing->Head; Tail++)
+        {
+            /* Head has been read before the entry */
+            GIT_TEST_MEMBARRIER();
+            pEntry = &pRing->Entry[Tail & (GIT_TEST_LOG_RINGLEN - 1)];
+            Type = pEntry->Type;
+            Log_Format(pEntry, Line, sizeof(Line));
+
+            /* Entry must have been read before it is released */
+            GIT_TEST_MEMBARRIER();
+            pRing->Tail = Tail + 1;
+
+            Log_Write(Type, Line);
+        }
+
+        Dropped = pRing->Dropped;
+        if (Dropped != pRing->DroppedReported)
+        {
+            LOG_W(0, pFunc, "%d messages dropped, log ring %d was full",
+                  Dropped - pRing->DroppedReported, idx);
+            LogDropped += Dropped - pRing->DroppedReported;
+            pRing->DroppedReported = Dropped;
+        }
+
+        if (TaskId && (taskIdVerify(TaskId) != OK))
+        {
+            (void)__sync_bool_compare_and_swap(&pRing->TaskId, TaskId, 0);
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_log_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(LogVarList,
+                                       sizeof(LogVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Returns the ring of a task.
+*
+* @param[in]  TaskId      task id
+*
+* @retval     ring, NULL if the task is not attached
+*******************************************************************************/
+MLOCAL LOG_RING *Log_Ring(SINT32 TaskId)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_LOG_NBRINGS; idx++)
+    {
+        if (LogRing[idx].TaskId == TaskId)
+        {
+            return (&LogRing[idx]);
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Parses a single conversion of a format string.
+*
+* @param[in]  pSpec       conversion, starting with '%'
+* @param[out] pLen        length of the conversion in characters
+*
+* @retval     type of the argument, see enum logArg
+*******************************************************************************/
+MLOCAL UINT32 Log_Spec(const CHAR *pSpec, UINT32 *pLen)
+{
+    const CHAR *p = pSpec + 1;
+    UINT32  NbLong = 0;
+    UINT32  Arg;
+
+    while (*p && strchr("-+ #0", *p))
+    {
+        p++;
+    }
+    while (((*p >= '0') && (*p <= '9')) || (*p == '.'))
+    {
+        p++;
+    }
+    while (*p && strchr("hlLzjt", *p))
+    {
+        if ((*p == 'l') || (*p == 'z') || (*p == 'j') || (*p == 't'))
+        {
+            NbLong++;
+        }
+        else if (*p == 'L')
+        {
+            NbLong = 3;
+        }
+        p++;
+    }
+
+    switch (*p)
+    {
+    case '%':
+        Arg = LOG_ARG_NONE;
+        break;
+
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        Arg = (NbLong == 0) ? LOG_ARG_INT : (NbLong == 1) ? LOG_ARG_LONG : LOG_ARG_LLONG;
+        break;
+
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+        Arg = (NbLong == 3) ? LOG_ARG_BAD : LOG_ARG_DOUBLE;
+        break;
+
+    case 'p':
+        Arg = LOG_ARG_PTR;
+        break;
+
+    case 's':
+        Arg = LOG_ARG_STR;
+        break;
+
+    default:
+        Arg = LOG_ARG_BAD;
+        break;
+    }
+
+    if (*p)
+    {
+        p++;
+    }
+
+    *pLen = p - pSpec;
+    if (*pLen >= LOG_SPECLEN)
+    {
+        Arg = LOG_ARG_BAD;
+    }
+
+    return (Arg);
+}
+
+/**
+********************************************************************************
+* @brief Copies the arguments of a message into an entry.
+*        Only the conversions are parsed, nothing is formatted.
+*
+* @param[in]  pEntry      entry with format string
+* @param[in]  Args        arguments of the message
+*******************************************************************************/
+MLOCAL void Log_Record(LOG_ENTRY *pEntry, va_list Args)
+{
+    const CHAR *p = pEntry->pFmt;
+    UINT8  *pArg = pEntry->Args;
+    UINT8  *pEnd = pEntry->Args + GIT_TEST_LOG_ARGLEN;
+    UINT32  Len;
+    UINT32  Size;
+    SINT32  IntVal;
+    long    LongVal;
+    long long LLongVal;
+    double  DoubleVal;
+    void   *pVal;
+    const CHAR *pStrg;
+
+    pEntry->NbArgs = 0;
+
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        switch (Log_Spec(p, &Len))
+        {
+        case LOG_ARG_NONE:
+            p += Len;
+            continue;
+
+        case LOG_ARG_INT:
+            Size = sizeof(IntVal);
+            if ((UINT32)(pEnd - pArg) < Size)
+            {
+                return;
+            }
+            IntVal = va_arg(Args, int);
+            memcpy(pArg, &IntVal, Size);
+            break;
+
+        case LOG_ARG_LONG:
+            Size = sizeof(LongVal);
+            if ((UINT32)(pEnd - pArg) < Size)
+            {
+                return;
+            }
+            LongVal = va_arg(Args, long);
+            memcpy(pArg, &LongVal, Size);
+            break;
+
+        case LOG_ARG_LLONG:
+            Size = sizeof(LLongVal);
+            if ((UINT32)(pEnd - pArg) < Size)
+            {
+                return;
+            }
+            LLongVal = va_arg(Args, long long);
+            memcpy(pArg, &LLongVal, Size);
+            break;
+
+        case LOG_ARG_DOUBLE:
+            Size = sizeof(DoubleVal);
+            if ((UINT32)(pEnd - pArg) < Size)
+            {
+                return;
+            }
+            DoubleVal = va_arg(Args, double);
+            memcpy(pArg, &DoubleVal, Size);
+            break;
+
+        case LOG_ARG_PTR:
+            Size = sizeof(pVal);
+            if ((UINT32)(pEnd - pArg) < Size)
+            {
+                return;
+            }
+            pVal = va_arg(Args, void *);
+            memcpy(pArg, &pVal, Size);
+            break;
+
+        case LOG_ARG_STR:
+            if (pArg >= pEnd)
+            {
+                return;
+            }
+            pStrg = va_arg(Args, const CHAR *);
+            if (!pStrg)
+            {
+                pStrg = "(null)";
+            }
+            Size = strlen(pStrg) + 1;
+            if (Size > (UINT32)(pEnd - pArg))
+            {
+                Size = pEnd - pArg;
+            }
+            memcpy(pArg, pStrg, Size - 1);
+            pArg[Size - 1] = 0;
+            break;
+
+        default:
+            return;
+        }
+
+        pArg += Size;
+        pEntry->NbArgs++;
+        p += Len;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Formats a recorded message.
+*        A message with missing arguments is cut off and ends with "...".
+*
+* @param[in]  pEntry      recorded message
+* @param[out] pLine       formatted message
+* @param[in]  LineLen     size of pLine in bytes
+*******************************************************************************/
+MLOCAL void Log_Format(const LOG_ENTRY *pEntry, CHAR *pLine, UINT32 LineLen)
+{
+    const CHAR *p = pEntry->pFmt;
+    const UINT8 *pArg = pEntry->Args;
+    CHAR    Spec[LOG_SPECLEN];
+    UINT32  NbArgs = 0;
+    UINT32  Pos = 0;
+    UINT32  Len;
+    UINT32  Arg;
+    SINT32  IntVal;
+    long    LongVal;
+    long long LLongVal;
+    double  DoubleVal;
+    void   *pVal;
+    int     ret = 0;
+
+    while (*p && (Pos < (LineLen - 1)))
+    {
+        if (*p != '%')
+        {
+            pLine[Pos++] = *p++;
+            continue;
+        }
+
+        Arg = Log_Spec(p, &Len);
+        if (Arg == LOG_ARG_NONE)
+        {
+            pLine[Pos++] = '%';
+            p += Len;
+            continue;
+        }
+
+        if (NbArgs >= pEntry->NbArgs)
+        {
+            ret = snprintf(&pLine[Pos], LineLen - Pos, "...");
+            Pos += ret;
+            break;
+        }
+
+        memcpy(Spec, p, Len);
+        Spec[Len] = 0;
+
+        switch (Arg)
+        {
+        case LOG_ARG_INT:
+            memcpy(&IntVal, pArg, sizeof(IntVal));
+            pArg += sizeof(IntVal);
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, IntVal);
+            break;
+
+        case LOG_ARG_LONG:
+            memcpy(&LongVal, pArg, sizeof(LongVal));
+            pArg += sizeof(LongVal);
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, LongVal);
+            break;
+
+        case LOG_ARG_LLONG:
+            memcpy(&LLongVal, pArg, sizeof(LLongVal));
+            pArg += sizeof(LLongVal);
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, LLongVal);
+            break;
+
+        case LOG_ARG_DOUBLE:
+            memcpy(&DoubleVal, pArg, sizeof(DoubleVal));
+            pArg += sizeof(DoubleVal);
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, DoubleVal);
+            break;
+
+        case LOG_ARG_PTR:
+            memcpy(&pVal, pArg, sizeof(pVal));
+            pArg += sizeof(pVal);
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, pVal);
+            break;
+
+        case LOG_ARG_STR:
+            ret = snprintf(&pLine[Pos], LineLen - Pos, Spec, (const CHAR *)pArg);
+            pArg += strlen((const CHAR *)pArg) + 1;
+            break;
+
+        default:
+            break;
+        }
+
+        if (ret > 0)
+        {
+            Pos += ret;
+        }
+        NbArgs++;
+        p += Len;
+    }
+
+    if (Pos > (LineLen - 1))
+    {
+        Pos = LineLen - 1;
+    }
+    pLine[Pos] = 0;
+
+    /* Time of the message, the system log shows the time of the drain */
+    Len = strlen(pLine);
+    (void)snprintf(&pLine[Len], LineLen - Len, " (t=%u us)", pEntry->Time);
+}
+
+/**
+********************************************************************************
+* @brief Writes a formatted message to the system log.
+*
+* @param[in]  Type        destination, see enum gitTestLogType
+* @param[in]  pLine       formatted message
+*******************************************************************************/
+MLOCAL void Log_Write(UINT32 Type, const CHAR *pLine)
+{
+    switch (Type)
+    {
+    case GIT_TEST_LOG_WRN:
+        log_Wrn("%s", pLine);
+        break;
+
+    case GIT_TEST_LOG_ERR:
+        log_Err("%s", pLine);
+        break;
+
+    case GIT_TEST_LOG_USER:
+        log_User("%s", pLine);
+        break;
+
+    default:
+        log_Info("%s", pLine);
+        break;
+    }
+}
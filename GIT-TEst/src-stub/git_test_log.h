@@ -0,0 +1,64 @@
+/**
+********************************************************************************
+* @file     git_test_log.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the deferred logging of
+*           the real-time tasks.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_LOG__H
+#define GIT_TEST_LOG__H
+
+/* Defines: log rings */
+#define GIT_TEST_LOG_NBRINGS    4       /* maximum number of attached tasks */
+#define GIT_TEST_LOG_RINGLEN    64      /* entries per ring, power of 2 */
+#define GIT_TEST_LOG_ARGLEN     128     /* bytes for the arguments of an entry */
+
+/*
+ * Highest level of LOG_x calls compiled into the module.
+ * Calls with a higher level are removed by the compiler,
+ * e.g. -DGIT_TEST_LOG_MAX_LEVEL=1 for a production build.
+ */
+#ifndef GIT_TEST_LOG_MAX_LEVEL
+#define GIT_TEST_LOG_MAX_LEVEL  4
+#endif
+
+/* Defines: rate limit of each LOG_x call site */
+#define GIT_TEST_LOG_BURST      10      /* messages logged without delay */
+#define GIT_TEST_LOG_RATE       1       /* messages per second after a burst */
+
+/* Token bucket of a LOG_x call site */
+typedef struct GIT_TEST_LOG_LIMIT
+{
+    UINT32  Credit;                     /* available time in ticks */
+    UINT32  LastTick;                   /* tickGet() of the last call */
+    UINT32  Suppressed;                 /* messages suppressed since the last one logged */
+} GIT_TEST_LOG_LIMIT;
+
+/* Destination in the system log */
+enum gitTestLogType {GIT_TEST_LOG_INFO, GIT_TEST_LOG_WRN, GIT_TEST_LOG_ERR, GIT_TEST_LOG_USER};
+
+/*--- Functions ---*/
+
+/* Any task: log a message, deferred if the task is attached */
+extern void git_test_log_put(UINT32 Type, const CHAR *pFmt, ...);
+
+/* Any task: rate limit of a call site, TRUE if the message is to be logged */
+extern UINT32 git_test_log_limit(GIT_TEST_LOG_LIMIT *pLimit, UINT32 Type, const CHAR *pFuncName);
+
+/* Real-time task: use a ring of its own, called at task entry and exit */
+extern SINT32 git_test_log_attach(void);
+extern void git_test_log_detach(void);
+
+/* bTask: format the recorded messages and write them to the system log */
+extern void git_test_log_drain(void);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_log_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,825 @@
+/**
+********************************************************************************
+* @file     git_test_lut.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the characteristic curves and maps of the
+*           control task, e.g. sensor linearizations and efficiency maps.
+*
+*           The tables are built at EOI from the groups of the module
+*           section, the breakpoints are comma separated lists. A list
+*           longer than one line is continued with the keys "<key>_2",
+*           "<key>_3", ...
+*             [Curve1]               [Map1]
+*             Name = "Pt100"         Name = "Efficiency"
+*             X = "-200, 0, 850"     X = "0, 1000, 3000"      (axis 1)
+*             Y = "18.5, 100, 390"   Y = "0, 50, 100"         (axis 2)
+*             Grid = 256             Z = "0,0,0, 80,85,82, 70,90,88"
+*                                         (Z: rows of axis 1)
+*           Curves are resampled to a uniform grid with offset and slope
+*           per cell, so the evaluation is one index computation and one
+*           multiply-add. The error of the resampling at the breakpoints is
+*           logged at load.
+*           Maps keep their breakpoints and are bilinearly interpolated.
+*           Each axis has an index over a uniform grid which is finer than
+*           the smallest breakpoint distance, so the segment is found with
+*           one lookup and at most one step.
+*           Values outside of the table are held at its ends.
+*           All tables are stored in a static pool, which is rebuilt on
+*           each load; the control task must not be running.
+*           A CRC over the text of all groups is kept at load, so a new
+*           configuration can be checked for changed tables.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <mio.h>
+#include <mio_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_cfgidx.h"
+#include "git_test_cfgimg.h"
+#include "git_test_lut.h"
+
+/* Defines: configuration */
+#define LUT_LINELEN     256             /* maximum length of a list key */
+#define LUT_MAXCONT     16              /* maximum number of continuation keys */
+
+/* Curve on a uniform grid: Y = pBase[i] + pSlope[i] * X in cell i */
+typedef struct LUT_CURVE
+{
+    CHAR    Name[GIT_TEST_LUT_NAMELEN];
+    UINT32  NbOfCells;                  /* grid points - 1 */
+    REAL32  XMin;                       /* first grid point */
+    REAL32  XMax;                       /* last grid point */
+    REAL32  InvDx;                      /* 1 / grid distance */
+    REAL32  *pBase;                     /* offset per cell */
+    REAL32  *pSlope;                    /* slope per cell */
+} LUT_CURVE;
+
+/* Axis of a map with its index */
+typedef struct LUT_AXIS
+{
+    UINT32  NbOfPoints;                 /* number of breakpoints */
+    REAL32  *pBp;                       /* breakpoints, strictly increasing */
+    REAL32  *pInvSpan;                  /* 1 / distance to the next breakpoint */
+    UINT32  NbOfIdx;                    /* size of the index */
+    REAL32  InvCell;                    /* 1 / grid distance of the index */
+    UINT16  *pIdx;                      /* segment at the start of each index cell */
+} LUT_AXIS;
+
+/* Map with bilinear interpolation */
+typedef struct LUT_MAP
+{
+    CHAR    Name[GIT_TEST_LUT_NAMELEN];
+    LUT_AXIS X;                         /* axis 1, rows of Z */
+    LUT_AXIS Y;                         /* axis 2, columns of Z */
+    REAL32  *pZ;                        /* values, X.NbOfPoints * Y.NbOfPoints */
+} LUT_MAP;
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 Lut_LoadCurve(const CHAR *pGroup, LUT_CURVE *pCurve);
+MLOCAL SINT32 Lut_LoadMap(const CHAR *pGroup, LUT_MAP *pMap);
+MLOCAL SINT32 Lut_ReadList(const CHAR *pGroup, const CHAR *pKey, REAL32 *pVals, UINT32 MaxVals,
+                           UINT32 *pNbOfVals);
+MLOCAL SINT32 Lut_AxisInit(const CHAR *pGroup, LUT_AXIS *pAxis, const REAL32 *pBp, UINT32 Nb);
+MLOCAL REAL32 Lut_CurveAt(const LUT_CURVE *pCurve, REAL32 X);
+MLOCAL UINT32 Lut_AxisFind(const LUT_AXIS *pAxis, REAL32 *pX);
+MLOCAL REAL32 Lut_Linear(const REAL32 *pX, const REAL32 *pY, UINT32 Nb, REAL32 X);
+MLOCAL void *Lut_Alloc(UINT32 Size);
+MLOCAL UINT32 Lut_CfgCrc(void);
+
+/* Global variables: tables */
+MLOCAL LUT_CURVE LutCurve[GIT_TEST_LUT_MAXCURVES];
+MLOCAL LUT_MAP LutMap[GIT_TEST_LUT_MAXMAPS];
+MLOCAL UINT32 LutPool[GIT_TEST_LUT_POOLSIZE / sizeof(UINT32)];
+MLOCAL UINT32 LutPoolUsed = 0;          /* bytes of LutPool in use */
+MLOCAL UINT32 LutNbOfCurves = 0;        /* number of loaded curves */
+MLOCAL UINT32 LutNbOfMaps = 0;          /* number of loaded maps */
+MLOCAL UINT32 LutCfgCrc = 0;            /* CRC of the configuration of the loaded tables */
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR LutVarList[] = {
+    {"Lut/NbOfCurves", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &LutNbOfCurves, 0, 0, NULL, NULL, 0, NULL},
+    {"Lut/NbOfMaps", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &LutNbOfMaps, 0, 0, NULL, NULL, 0, NULL},
+    {"Lut/PoolUsed", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &LutPoolUsed, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Builds all curves and maps from the configuration.
+*        Groups "Curve<n>" and "Map<n>" are numbered from 1 without gaps,
+*        the handle is n - 1.
+*        Called by the bTask at EOI, before the tasks are started.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_lut_load(void)
+{
+    CHAR    Group[PF_KEYLEN_A];
+    SINT32  ret;
+
+    memset(LutCurve, 0, sizeof(LutCurve));
+    memset(LutMap, 0, sizeof(LutMap));
+    LutPoolUsed = 0;
+    LutNbOfCurves = 0;
+    LutNbOfMaps = 0;
+
+    for (LutNbOfCurves = 0; LutNbOfCurves < GIT_TEST_LUT_MAXCURVES; LutNbOfCurves++)
+    {
+        sprintf(Group, "Curve%d", LutNbOfCurves + 1);
+        ret = Lut_LoadCurve(Group, &LutCurve[LutNbOfCurves]);
+        if (ret == ERROR)
+        {
+            break;
+        }
+        if (ret < 0)
+        {
+            return (ret);
+        }
+    }
+
+    for (LutNbOfMaps = 0; LutNbOfMaps < GIT_TEST_LUT_MAXMAPS; LutNbOfMaps++)
+    {
+        sprintf(Group, "Map%d", LutNbOfMaps + 1);
+        ret = Lut_LoadMap(Group, &LutMap[LutNbOfMaps]);
+        if (ret == ERROR)
+        {
+            break;
+        }
+        if (ret < 0)
+        {
+            return (ret);
+        }
+    }
+
+    if (LutNbOfCurves || LutNbOfMaps)
+    {
+        LOG_I(1, __func__, "%d curves and %d maps loaded, %d bytes",
+              LutNbOfCurves, LutNbOfMaps, LutPoolUsed);
+    }
+
+    LutCfgCrc = Lut_CfgCrc();
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Checks if the curves and maps of the configuration just read differ
+*        from the loaded tables.
+*        Called by the bTask after a new configuration has been read.
+*
+* @retval     TRUE .. changed, the tables have to be loaded again
+* @retval     FALSE .. unchanged
+*******************************************************************************/
+UINT32 git_test_lut_cfgChanged(void)
+{
+    return ((Lut_CfgCrc() != LutCfgCrc) ? TRUE : FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Searches a curve by its name.
+*
+* @param[in]  pName       name, case sensitive
+*
+* @retval     >= 0 .. handle
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+SINT32 git_test_lut_findCurve(const CHAR *pName)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < LutNbOfCurves; idx++)
+    {
+        if (!strcmp(LutCurve[idx].Name, pName))
+        {
+            return ((SINT32)idx);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Searches a map by its name.
+*
+* @param[in]  pName       name, case sensitive
+*
+* @retval     >= 0 .. handle
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+SINT32 git_test_lut_findMap(const CHAR *pName)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < LutNbOfMaps; idx++)
+    {
+        if (!strcmp(LutMap[idx].Name, pName))
+        {
+            return ((SINT32)idx);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Evaluates a curve.
+*
+* @param[in]  Handle      handle of the curve
+* @param[in]  X           input value
+*
+* @retval     output value, 0 for an unknown handle
+*******************************************************************************/
+REAL32 git_test_lut_curve(UINT32 Handle, REAL32 X)
+{
+    REAL32  Y;
+
+    git_test_lut_curveBatch(Handle, &X, &Y, 1);
+    return (Y);
+}
+
+/**
+********************************************************************************
+* @brief Evaluates a curve for an array of input values.
+*        Lut_CurveAt() is inlined, the loop has no branches except for the
+*        limits, so the compiler can vectorize it where the CPU supports
+*        gathers.
+*
+* @param[in]  Handle      handle of the curve
+* @param[in]  pX          input values
+* @param[out] pY          output values, 0 for an unknown handle
+* @param[in]  Nb          number of values
+*******************************************************************************/
+void git_test_lut_curveBatch(UINT32 Handle, const REAL32 *pX, REAL32 *pY, UINT32 Nb)
+{
+    const LUT_CURVE *pCurve;
+    UINT32  idx;
+
+    if (Handle >= LutNbOfCurves)
+    {
+        memset(pY, 0, Nb * sizeof(REAL32));
+        return;
+    }
+
+    pCurve = &LutCurve[Handle];
+    for (idx = 0; idx < Nb; idx++)
+    {
+        pY[idx] = Lut_CurveAt(pCurve, pX[idx]);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Evaluates a map.
+*
+* @param[in]  Handle      handle of the map
+* @param[in]  X           value of axis 1
+* @param[in]  Y           value of axis 2
+*
+* @retval     output value, 0 for an unknown handle
+*******************************************************************************/
+REAL32 git_test_lut_map(UINT32 Handle, REAL32 X, REAL32 Y)
+{
+    REAL32  Z;
+
+    git_test_lut_mapBatch(Handle, &X, &Y, &Z, 1);
+    return (Z);
+}
+
+/**
+********************************************************************************
+* @brief Evaluates a map for arrays of input values.
+*
+* @param[in]  Handle      handle of the map
+* @param[in]  pX          values of axis 1
+* @param[in]  pY          values of axis 2
+* @param[out] pZ          output values, 0 for an unknown handle
+* @param[in]  Nb          number of values
+*******************************************************************************/
+void git_test_lut_mapBatch(UINT32 Handle, const REAL32 *pX, const REAL32 *pY,
+                           REAL32 *pZ, UINT32 Nb)
+{
+    const LUT_MAP *pMap;
+    const REAL32 *pRow;
+    UINT32  NbOfCols;
+    UINT32  idx;
+
+    if (Handle >= LutNbOfMaps)
+    {
+        memset(pZ, 0, Nb * sizeof(REAL32));
+        return;
+    }
+
+    pMap = &LutMap[Handle];
+    NbOfCols = pMap->Y.NbOfPoints;
+
+    for (idx = 0; idx < Nb; idx++)
+    {
+        REAL32  X = pX[idx];
+        REAL32  Y = pY[idx];
+        UINT32  Row = Lut_AxisFind(&pMap->X, &X);
+        UINT32  Col = Lut_AxisFind(&pMap->Y, &Y);
+        REAL32  Z0, Z1;
+
+        /* X and Y are now the fractions within the segments */
+        pRow = pMap->pZ + (Row * NbOfCols) + Col;
+        Z0 = pRow[0] + (Y * (pRow[1] - pRow[0]));
+        Z1 = pRow[NbOfCols] + (Y * (pRow[NbOfCols + 1] - pRow[NbOfCols]));
+        pZ[idx] = Z0 + (X * (Z1 - Z0));
+    }
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_lut_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(LutVarList, sizeof(LutVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Builds a curve from its configuration group.
+*
+* @param[in]  pGroup      configuration group
+* @param[out] pCurve      curve
+*
+* @retval     = 0 .. OK
+* @retval     = ERROR .. group does not exist
+* @retval     < 0 .. MIO_ER_BADCONF, bad configuration
+*******************************************************************************/
+MLOCAL SINT32 Lut_LoadCurve(const CHAR *pGroup, LUT_CURVE *pCurve)
+{
+    static const CHAR *pFunc = __func__;
+    REAL32  Bp[GIT_TEST_LUT_MAXPOINTS];
+    REAL32  Val[GIT_TEST_LUT_MAXPOINTS];
+    UINT32  NbOfBp, NbOfVal;
+    SINT32  Grid;
+    REAL64  Dx, X0, X1, Y0, Y1, Err, MaxErr;
+    UINT32  idx;
+
+    if (Lut_ReadList(pGroup, "X", Bp, GIT_TEST_LUT_MAXPOINTS, &NbOfBp) == ERROR)
+    {
+        return (ERROR);
+    }
+    if ((Lut_ReadList(pGroup, "Y", Val, GIT_TEST_LUT_MAXPOINTS, &NbOfVal) < 0) ||
+        (NbOfBp < 2) || (NbOfVal != NbOfBp))
+    {
+        LOG_E(0, pFunc, "'%s': X and Y need the same number of values, at least 2", pGroup);
+        return (MIO_ER_BADCONF);
+    }
+    for (idx = 1; idx < NbOfBp; idx++)
+    {
+        if (Bp[idx] <= Bp[idx - 1])
+        {
+            LOG_E(0, pFunc, "'%s': X must be strictly increasing", pGroup);
+            return (MIO_ER_BADCONF);
+        }
+    }
+
+    if ((git_test_cfgidx_getInt(pGroup, "Grid", GIT_TEST_LUT_DEFGRID, &Grid) == MIO_ER_BADCONF) ||
+        (Grid < 2) || (Grid > GIT_TEST_LUT_MAXGRID))
+    {
+        LOG_E(0, pFunc, "'%s': Grid must be 2 .. %d", pGroup, GIT_TEST_LUT_MAXGRID);
+        return (MIO_ER_BADCONF);
+    }
+    (void)git_test_cfgidx_getStrg(pGroup, "Name", pGroup, pCurve->Name, sizeof(pCurve->Name));
+
+    pCurve->NbOfCells = (UINT32)Grid - 1;
+    pCurve->pBase = Lut_Alloc(pCurve->NbOfCells * sizeof(REAL32));
+    pCurve->pSlope = Lut_Alloc(pCurve->NbOfCells * sizeof(REAL32));
+    if (!pCurve->pBase || !pCurve->pSlope)
+    {
+        LOG_E(0, pFunc, "'%s': no memory for %d grid points", pGroup, Grid);
+        return (MIO_ER_BADCONF);
+    }
+
+    pCurve->XMin = Bp[0];
+    pCurve->XMax = Bp[NbOfBp - 1];
+    Dx = ((REAL64)pCurve->XMax - pCurve->XMin) / pCurve->NbOfCells;
+    pCurve->InvDx = (REAL32)(1.0 / Dx);
+
+    for (idx = 0; idx < pCurve->NbOfCells; idx++)
+    {
+        X0 = pCurve->XMin + (idx * Dx);
+        X1 = X0 + Dx;
+        Y0 = Lut_Linear(Bp, Val, NbOfBp, (REAL32)X0);
+        Y1 = Lut_Linear(Bp, Val, NbOfBp, (REAL32)X1);
+        pCurve->pSlope[idx] = (REAL32)((Y1 - Y0) / Dx);
+        pCurve->pBase[idx] = (REAL32)(Y0 - (pCurve->pSlope[idx] * X0));
+    }
+
+    /* Error of the resampling at the breakpoints */
+    MaxErr = 0;
+    for (idx = 0; idx < NbOfBp; idx++)
+    {
+        Err = Lut_CurveAt(pCurve, Bp[idx]) - Val[idx];
+        Err = (Err < 0) ? -Err : Err;
+        MaxErr = (Err > MaxErr) ? Err : MaxErr;
+    }
+    LOG_I(1, pFunc, "Curve '%s': %d points on %d grid points, max. error %g",
+          pCurve->Name, NbOfBp, Grid, MaxErr);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Builds a map from its configuration group.
+*
+* @param[in]  pGroup      configuration group
+* @param[out] pMap        map
+*
+* @retval     = 0 .. OK
+* @retval     = ERROR .. group does not exist
+* @retval     < 0 .. MIO_ER_BADCONF, bad configuration
+*******************************************************************************/
+MLOCAL SINT32 Lut_LoadMap(const CHAR *pGroup, LUT_MAP *pMap)
+{
+    static const CHAR *pFunc = __func__;
+    REAL32  BpX[GIT_TEST_LUT_MAXPOINTS];
+    REAL32  BpY[GIT_TEST_LUT_MAXPOINTS];
+    UINT32  NbX, NbY, NbZ;
+
+    if (Lut_ReadList(pGroup, "X", BpX, GIT_TEST_LUT_MAXPOINTS, &NbX) == ERROR)
+    {
+        return (ERROR);
+    }
+    if ((Lut_ReadList(pGroup, "Y", BpY, GIT_TEST_LUT_MAXPOINTS, &NbY) < 0) ||
+        (Lut_AxisInit(pGroup, &pMap->X, BpX, NbX) < 0) ||
+        (Lut_AxisInit(pGroup, &pMap->Y, BpY, NbY) < 0))
+    {
+        return (MIO_ER_BADCONF);
+    }
+    (void)git_test_cfgidx_getStrg(pGroup, "Name", pGroup, pMap->Name, sizeof(pMap->Name));
+
+    pMap->pZ = Lut_Alloc(NbX * NbY * sizeof(REAL32));
+    if (!pMap->pZ)
+    {
+        LOG_E(0, pFunc, "'%s': no memory for %d x %d values", pGroup, NbX, NbY);
+        return (MIO_ER_BADCONF);
+    }
+    if ((Lut_ReadList(pGroup, "Z", pMap->pZ, NbX * NbY, &NbZ) < 0) || (NbZ != (NbX * NbY)))
+    {
+        LOG_E(0, pFunc, "'%s': Z needs %d x %d values", pGroup, NbX, NbY);
+        return (MIO_ER_BADCONF);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads a comma separated list of values.
+*        The list is continued with the keys "<key>_2", "<key>_3", ...
+*
+* @param[in]  pGroup      configuration group
+* @param[in]  pKey        key of the first line
+* @param[out] pVals       values
+* @param[in]  MaxVals     size of pVals
+* @param[out] pNbOfVals   number of values read
+*
+* @retval     = 0 .. OK
+* @retval     = ERROR .. key does not exist
+* @retval     < 0 .. MIO_ER_BADCONF, malformed value or too many values
+*******************************************************************************/
+MLOCAL SINT32 Lut_ReadList(const CHAR *pGroup, const CHAR *pKey, REAL32 *pVals, UINT32 MaxVals,
+                           UINT32 *pNbOfVals)
+{
+    static const CHAR *pFunc = __func__;
+    CHAR    Line[LUT_LINELEN];
+    CHAR    Key[PF_KEYLEN_A];
+    CHAR    *pPos;
+    CHAR    *pEnd;
+    UINT32  Cont;
+    SINT32  ret;
+
+    *pNbOfVals = 0;
+
+    for (Cont = 1; Cont <= LUT_MAXCONT; Cont++)
+    {
+        if (Cont == 1)
+        {
+            snprintf(Key, sizeof(Key), "%s", pKey);
+        }
+        else
+        {
+            snprintf(Key, sizeof(Key), "%s_%d", pKey, Cont);
+        }
+
+        ret = git_test_cfgidx_getStrg(pGroup, Key, "", Line, sizeof(Line));
+        if (ret == ERROR)
+        {
+            return ((Cont == 1) ? ERROR : OK);
+        }
+        if (ret < 0)
+        {
+            return (MIO_ER_BADCONF);
+        }
+
+        for (pPos = Line; *pPos; pPos = pEnd)
+        {
+            while ((*pPos == ' ') || (*pPos == ',') || (*pPos == '\t'))
+            {
+                pPos++;
+            }
+            if (!*pPos)
+            {
+                break;
+            }
+
+            if (*pNbOfVals >= MaxVals)
+            {
+                LOG_E(0, pFunc, "'(%s)%s': more than %d values", pGroup, pKey, MaxVals);
+                return (MIO_ER_BADCONF);
+            }
+
+            pVals[*pNbOfVals] = (REAL32)strtod(pPos, &pEnd);
+            if (pEnd == pPos)
+            {
+                LOG_E(0, pFunc, "'(%s)%s': '%s' is not a number", pGroup, Key, pPos);
+                return (MIO_ER_BADCONF);
+            }
+            (*pNbOfVals)++;
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Sets up an axis of a map with its index.
+*        The index grid is finer than the smallest breakpoint distance, so
+*        each index cell contains at most one breakpoint.
+*
+* @param[in]  pGroup      configuration group, for messages
+* @param[out] pAxis       axis
+* @param[in]  pBp         breakpoints
+* @param[in]  Nb          number of breakpoints
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Lut_AxisInit(const CHAR *pGroup, LUT_AXIS *pAxis, const REAL32 *pBp, UINT32 Nb)
+{
+    static const CHAR *pFunc = __func__;
+    REAL64  MinSpan, Span, Cell;
+    UINT32  Seg;
+    UINT32  idx;
+
+    if (Nb < 2)
+    {
+        LOG_E(0, pFunc, "'%s': each axis needs at least 2 breakpoints", pGroup);
+        return (ERROR);
+    }
+
+    MinSpan = (REAL64)pBp[1] - pBp[0];
+    for (idx = 1; idx < Nb; idx++)
+    {
+        Span = (REAL64)pBp[idx] - pBp[idx - 1];
+        if (Span <= 0)
+        {
+            LOG_E(0, pFunc, "'%s': breakpoints must be strictly increasing", pGroup);
+            return (ERROR);
+        }
+        MinSpan = (Span < MinSpan) ? Span : MinSpan;
+    }
+
+    Span = (REAL64)pBp[Nb - 1] - pBp[0];
+    pAxis->NbOfIdx = (UINT32)(Span / MinSpan) + 1;
+    if (pAxis->NbOfIdx > GIT_TEST_LUT_MAXIDX)
+    {
+        LOG_E(0, pFunc, "'%s': breakpoints too unevenly spaced, index of %d cells",
+              pGroup, pAxis->NbOfIdx);
+        return (ERROR);
+    }
+    Cell = Span / pAxis->NbOfIdx;
+    pAxis->InvCell = (REAL32)(1.0 / Cell);
+
+    pAxis->NbOfPoints = Nb;
+    pAxis->pBp = Lut_Alloc(Nb * sizeof(REAL32));
+    pAxis->pInvSpan = Lut_Alloc((Nb - 1) * sizeof(REAL32));
+    pAxis->pIdx = Lut_Alloc(pAxis->NbOfIdx * sizeof(UINT16));
+    if (!pAxis->pBp || !pAxis->pInvSpan || !pAxis->pIdx)
+    {
+        LOG_E(0, pFunc, "'%s': no memory for the axis", pGroup);
+        return (ERROR);
+    }
+
+    memcpy(pAxis->pBp, pBp, Nb * sizeof(REAL32));
+    for (idx = 0; idx < (Nb - 1); idx++)
+    {
+        pAxis->pInvSpan[idx] = (REAL32)(1.0 / ((REAL64)pBp[idx + 1] - pBp[idx]));
+    }
+
+    /* Last segment which starts at or before the start of the cell */
+    Seg = 0;
+    for (idx = 0; idx < pAxis->NbOfIdx; idx++)
+    {
+        while ((Seg < (Nb - 2)) && (pBp[Seg + 1] <= (pBp[0] + (idx * Cell))))
+        {
+            Seg++;
+        }
+        pAxis->pIdx[idx] = (UINT16)Seg;
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Evaluates a curve at one value.
+*
+* @param[in]  pCurve      curve
+* @param[in]  X           input value
+*
+* @retval     output value
+*******************************************************************************/
+MLOCAL REAL32 Lut_CurveAt(const LUT_CURVE *pCurve, REAL32 X)
+{
+    UINT32  Cell;
+
+    X = (X < pCurve->XMin) ? pCurve->XMin : ((X > pCurve->XMax) ? pCurve->XMax : X);
+    Cell = (UINT32)((X - pCurve->XMin) * pCurve->InvDx);
+    Cell = (Cell >= pCurve->NbOfCells) ? (pCurve->NbOfCells - 1) : Cell;
+
+    return (pCurve->pBase[Cell] + (pCurve->pSlope[Cell] * X));
+}
+
+/**
+********************************************************************************
+* @brief Finds the segment of a value on a map axis.
+*
+* @param[in]  pAxis       axis
+* @param[in,out] pX       value, returns the fraction 0..1 within the segment
+*
+* @retval     index of the segment
+*******************************************************************************/
+MLOCAL UINT32 Lut_AxisFind(const LUT_AXIS *pAxis, REAL32 *pX)
+{
+    const REAL32 *pBp = pAxis->pBp;
+    REAL32  X = *pX;
+    REAL32  Min = pBp[0];
+    REAL32  Max = pBp[pAxis->NbOfPoints - 1];
+    UINT32  Cell;
+    UINT32  Seg;
+
+    X = (X < Min) ? Min : ((X > Max) ? Max : X);
+    Cell = (UINT32)((X - Min) * pAxis->InvCell);
+    Cell = (Cell >= pAxis->NbOfIdx) ? (pAxis->NbOfIdx - 1) : Cell;
+    Seg = pAxis->pIdx[Cell];
+
+    /* At most one breakpoint within the cell */
+    Seg += ((Seg < (pAxis->NbOfPoints - 2)) && (X >= pBp[Seg + 1])) ? 1 : 0;
+
+    *pX = (X - pBp[Seg]) * pAxis->pInvSpan[Seg];
+    return (Seg);
+}
+
+/**
+********************************************************************************
+* @brief Linear interpolation between breakpoints by search.
+*        Only used while building the tables.
+*
+* @param[in]  pX          breakpoints, strictly increasing
+* @param[in]  pY          values
+* @param[in]  Nb          number of breakpoints
+* @param[in]  X           input value
+*
+* @retval     output value, held at the ends
+*******************************************************************************/
+MLOCAL REAL32 Lut_Linear(const REAL32 *pX, const REAL32 *pY, UINT32 Nb, REAL32 X)
+{
+    UINT32  idx;
+
+    if (X <= pX[0])
+    {
+        return (pY[0]);
+    }
+
+    for (idx = 1; idx < Nb; idx++)
+    {
+        if (X <= pX[idx])
+        {
+            return (pY[idx - 1] + (((X - pX[idx - 1]) * (pY[idx] - pY[idx - 1])) /
+                                   (pX[idx] - pX[idx - 1])));
+        }
+    }
+
+    return (pY[Nb - 1]);
+}
+
+/**
+********************************************************************************
+* @brief Carves a block from the pool of the tables.
+*
+* @param[in]  Size        size in bytes
+*
+* @retval     block, aligned to 4 bytes, NULL if the pool is exhausted
+*******************************************************************************/
+MLOCAL void *Lut_Alloc(UINT32 Size)
+{
+    void    *pBlk;
+
+    Size = (Size + sizeof(UINT32) - 1) & ~(sizeof(UINT32) - 1);
+    if ((LutPoolUsed + Size) > sizeof(LutPool))
+    {
+        return (NULL);
+    }
+
+    pBlk = (UINT8 *)LutPool + LutPoolUsed;
+    LutPoolUsed += Size;
+    return (pBlk);
+}
+
+/**
+********************************************************************************
+* @brief CRC over the text of all keys of the groups "Curve<n>" and "Map<n>",
+*        including the continuation keys of the lists.
+*
+* @retval     CRC32
+*******************************************************************************/
+MLOCAL UINT32 Lut_CfgCrc(void)
+{
+    static const CHAR *pKeys[] = {"Name", "Grid", "X", "Y", "Z"};
+    static const CHAR *pKinds[] = {"Curve", "Map"};
+    static const UINT32 MaxGroups[] = {GIT_TEST_LUT_MAXCURVES, GIT_TEST_LUT_MAXMAPS};
+    struct
+    {
+        UINT32  Crc;                    /* CRC up to the previous key */
+        CHAR    Text[PF_KEYLEN_A * 2 + LUT_LINELEN + 4];
+    } Item;
+    CHAR    Group[PF_KEYLEN_A];
+    CHAR    Key[PF_KEYLEN_A];
+    CHAR    Line[LUT_LINELEN];
+    UINT32  Kind, Nb, idx, Cont;
+
+    Item.Crc = 0;
+
+    for (Kind = 0; Kind < sizeof(pKinds) / sizeof(pKinds[0]); Kind++)
+    {
+        for (Nb = 1; Nb <= MaxGroups[Kind]; Nb++)
+        {
+            /* Groups are numbered without gaps, as in git_test_lut_load() */
+            sprintf(Group, "%s%d", pKinds[Kind], Nb);
+            if (git_test_cfgidx_getStrg(Group, "X", "", Line, sizeof(Line)) == ERROR)
+            {
+                break;
+            }
+
+            for (idx = 0; idx < sizeof(pKeys) / sizeof(pKeys[0]); idx++)
+            {
+                for (Cont = 1; Cont <= LUT_MAXCONT; Cont++)
+                {
+                    if (Cont == 1)
+                    {
+                        snprintf(Key, sizeof(Key), "%s", pKeys[idx]);
+                    }
+                    else
+                    {
+                        snprintf(Key, sizeof(Key), "%s_%d", pKeys[idx], Cont);
+                    }
+
+                    if (git_test_cfgidx_getStrg(Group, Key, "", Line, sizeof(Line)) == ERROR)
+                    {
+                        break;
+                    }
+
+                    memset(Item.Text, 0, sizeof(Item.Text));
+                    snprintf(Item.Text, sizeof(Item.Text), "(%s)%s=%s", Group, Key, Line);
+                    Item.Crc = git_test_cfgimg_crc(&Item, sizeof(Item.Crc) + sizeof(Item.Text));
+                }
+            }
+        }
+    }
+
+    return (Item.Crc);
+}
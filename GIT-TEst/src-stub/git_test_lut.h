@@ -0,0 +1,49 @@
+/**
+********************************************************************************
+* @file     git_test_lut.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the characteristic curves
+*           and maps of the control task.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_LUT__H
+#define GIT_TEST_LUT__H
+
+/* Defines: dimensions */
+#define GIT_TEST_LUT_MAXCURVES  16      /* groups "Curve1" .. "Curve16" */
+#define GIT_TEST_LUT_MAXMAPS    8       /* groups "Map1" .. "Map8" */
+#define GIT_TEST_LUT_MAXPOINTS  128     /* maximum number of breakpoints per list */
+#define GIT_TEST_LUT_DEFGRID    256     /* grid points of a curve if not configured ("Grid") */
+#define GIT_TEST_LUT_MAXGRID    4096    /* maximum grid points of a curve */
+#define GIT_TEST_LUT_MAXIDX     1024    /* maximum size of the index of a map axis */
+#define GIT_TEST_LUT_POOLSIZE   (64 * 1024) /* memory of all tables in bytes */
+#define GIT_TEST_LUT_NAMELEN    32      /* maximum length of a name including '\0' */
+
+/*--- Functions ---*/
+
+/* bTask: build all tables from the configuration, at EOI before the tasks are started */
+extern SINT32 git_test_lut_load(void);
+
+/* bTask: TRUE if the curves and maps of a new configuration differ from the loaded ones */
+extern UINT32 git_test_lut_cfgChanged(void);
+
+/* Any task: handle of a curve or map by its "Name", < 0 if not found */
+extern SINT32 git_test_lut_findCurve(const CHAR *pName);
+extern SINT32 git_test_lut_findMap(const CHAR *pName);
+
+/* Control task: evaluation, values outside of the table are held at its ends */
+extern REAL32 git_test_lut_curve(UINT32 Handle, REAL32 X);
+extern void git_test_lut_curveBatch(UINT32 Handle, const REAL32 *pX, REAL32 *pY, UINT32 Nb);
+extern REAL32 git_test_lut_map(UINT32 Handle, REAL32 X, REAL32 Y);
+extern void git_test_lut_mapBatch(UINT32 Handle, const REAL32 *pX, const REAL32 *pY,
+                                  REAL32 *pZ, UINT32 Nb);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_lut_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
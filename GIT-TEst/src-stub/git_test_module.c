@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <setjmp.h>
 #include <sysLib.h>
+#include <tickLib.h>
 #include <symLib.h>
 #include <sysSymTbl.h>
 
@@ -45,6 +46,15 @@
 /* Project includes */
 #include "git_test_e.h"
 #include "git_test_int.h"
+#include "git_test_snap.h"
+#include "git_test_wrq.h"
+#include "git_test_blk.h"
+#include "git_test_arena.h"
+#include "git_test_smirpl.h"
+#include "git_test_cfgidx.h"
+#include "git_test_stack.h"
+#include "git_test_retain.h"
+#include "git_test_persist.h"
 #include "../src-gen/git_test_direct.h"
 #include "../src-gen/git_test_direct_int.h"
 #include "../src-gen/git_test_pi_int.h"
@@ -54,6 +64,7 @@
 /* Defines for SMI server task */
 #define SMI_SRV_PRIO        120         /* Priority (range 118 ... 127) */
 #define SMI_SRV_STACKSIZE   10000       /* Stack size in bytes */
+#define SMI_SRV_IDLETIME    100         /* Period for background work in ms */
 
 /* Variable definitions */
 UINT32  git_test_ModState;            /* Module state */
@@ -64,9 +75,16 @@ GIT_TEST_BASE_PARMS git_test_BaseParams;
 SINT32  git_test_DebugMode;           /* Debug level of module */
 
 SMI_ID *git_test_pSmiId;              /* Id of module-SMI */
+SINT32  git_test_bTaskId = ERROR;     /* Task id of the bTask */
+UINT32  git_test_bTaskStackSize = SMI_SRV_STACKSIZE;   /* ("SmiServer", "StackSize") */
 UINT32  git_test_SviHandle = 0;       /* SVI server handle */
 CHAR    git_test_ModuleInfoDesc[SMI_DESCLEN_A];
 MLOCAL jmp_buf JumpEnv;          /* Jump Environment for 'longjmp' */
+MLOCAL UINT32 BaseInitDone = FALSE;     /* BaseInit() has been completed successfully */
+
+/* Pointer tables of RpcGetMapInfoLst(), carved from the arena once at EOI */
+MLOCAL void **pMapInfoTbl = NULL;
+MLOCAL UINT32 MapInfoNbOfCh = 0;
 
 /* Functions to be called from outside this file */
 SINT32  git_test_Init(MOD_CONF * pConf, MOD_LOAD * pLoad);
@@ -74,6 +92,8 @@ SINT32  git_test_Init(MOD_CONF * pConf, MOD_LOAD * pLoad);
 /* Functions to be called only from within this file */
 MLOCAL SINT32 BaseInit(void);
 MLOCAL void BaseDeinit(void);
+MLOCAL UINT32 BaseIntact(void);
+MLOCAL SINT32 WarmRestart(void);
 MLOCAL void bTaskMain(void);
 MLOCAL void RpcNull(SMI_MSG *pMsg);
 MLOCAL void RpcReset(SMI_MSG *pMsg);
@@ -86,6 +106,7 @@ MLOCAL void RpcGetInfo(SMI_MSG *pMsg);
 MLOCAL void RpcGetMapInfoLst(SMI_MSG *pMsg);
 MLOCAL void RpcEndOfInit(SMI_MSG *pMsg);
 MLOCAL void PanicHandler(UINT32 PanicMode);
+MLOCAL SINT32 MapInfoAlloc(void);
 
 /* Function pointer for extended version of smi_receive and svi_MsgHandler */
 MLOCAL FUNCPTR fpSmiReceive = NULL;
@@ -184,8 +205,16 @@ SINT32 git_test_Init(MOD_CONF *pConf, MOD_LOAD *pLoad)
          * This task should be in the priority group "Application 2"
          */
         sprintf(TaskName, "b%s", git_test_BaseParams.AppName);
+        (void)git_test_cfgidx_getInt("SmiServer", "StackSize", SMI_SRV_STACKSIZE,
+                                     (SINT32 *)&git_test_bTaskStackSize);
+        if ((SINT32)git_test_bTaskStackSize < GIT_TEST_STACK_MINSIZE)
+        {
+            LOG_W(0, pFunc, "StackSize of the bTask too small, using %d", SMI_SRV_STACKSIZE);
+            git_test_bTaskStackSize = SMI_SRV_STACKSIZE;
+        }
         TskId = sys_TaskSpawn(git_test_BaseParams.AppName, TaskName, SMI_SRV_PRIO,
-                              VX_FP_TASK, SMI_SRV_STACKSIZE, (FUNCPTR)bTaskMain);
+                              VX_FP_TASK, git_test_bTaskStackSize, (FUNCPTR)bTaskMain);
+        git_test_bTaskId = TskId;
 
         /* Test if task is successfully started */
         if (TskId == ERROR)
@@ -254,6 +283,8 @@ MLOCAL SINT32 BaseInit(void)
     const CHAR *pFunc = __func__;
     SINT32  ret = 0;
 
+    BaseInitDone = FALSE;
+
     /* create semaphore for halting all tasks in STOP state of module */
     if (!(git_test_StateSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY)))
     {
@@ -261,6 +292,27 @@ MLOCAL SINT32 BaseInit(void)
         return (ERROR);
     }
 
+    /* All later allocations of the module are carved from the arena */
+    ret = git_test_arena_init();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Reply buffers of the SMI server */
+    ret = git_test_smirpl_init();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* Retained state from non-volatile memory, restored at "End Of Init" */
+    ret = git_test_persist_init();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
     /*
      * Read configuration.
      * The SVI of the module can depend on the configuration,
@@ -293,6 +345,16 @@ MLOCAL SINT32 BaseInit(void)
         return (ret);
     }
 
+    /* Initialize SVI server for application specific variables */
+    ret = git_test_AppSviInit();
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    /* All base resources are in place, a warm restart may keep them */
+    BaseInitDone = TRUE;
+
     return (ret);
 }
 
@@ -306,6 +368,8 @@ MLOCAL void BaseDeinit(void)
     SINT32  ret;
     static const CHAR *pFunc = __FUNCTION__;
 
+    BaseInitDone = FALSE;
+
     /* Inform resource handler about changes of the module state */
     ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_DEINIT);
     if (ret != RES_E_OK)
@@ -331,10 +395,66 @@ MLOCAL void BaseDeinit(void)
      * before the exported resources are being deleted
      */
     git_test_sviServer_deinit();
+    git_test_AppSviDeinit();
 
     /* De-initialize resources allocated in git_test_AppInit() */
     git_test_AppDeinit();
 
+    /* Retained state of the deleted control task to non-volatile memory */
+    git_test_persist_deinit();
+
+    /* Nothing may use the arena any more */
+    pMapInfoTbl = NULL;
+    MapInfoNbOfCh = 0;
+    git_test_AppArenaRelease();
+    git_test_arena_deinit();
+
+}
+
+/**
+********************************************************************************
+* @brief Checks if the base resources of BaseInit() are still in place.
+*        A BaseInit() which has failed part way through does not count,
+*        even if some of the resources exist.
+*
+* @retval     TRUE .. a warm restart is possible
+* @retval     FALSE .. BaseDeinit() and BaseInit() are required
+*******************************************************************************/
+MLOCAL UINT32 BaseIntact(void)
+{
+    if (!BaseInitDone || !git_test_StateSema || !git_test_SviHandle || !git_test_pSmiId)
+    {
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Restarts the application, keeping the base resources.
+*        Semaphores, SVI server, arena and configuration of BaseInit() are
+*        kept, only the application tasks are deleted. They are created
+*        again at "End Of Init" and continue with the retained state.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, base resources are not intact
+*******************************************************************************/
+MLOCAL SINT32 WarmRestart(void)
+{
+    if (!BaseIntact())
+    {
+        return (ERROR);
+    }
+
+    /* The bTask might hold resources of an interrupted SVI call */
+    git_test_wrq_abort();
+    git_test_blk_unpin();
+
+    git_test_AppDeinit();
+
+    LOG_I(1, __func__, "Warm restart, base resources kept");
+    return (OK);
 }
 
 /**
@@ -351,10 +471,18 @@ MLOCAL void bTaskMain(void)
     SMI_MSG Msg;
     SINT32  ret;
     UINT32  UserSessionId = 0;          /* Session Id for checking user rights */
+    SINT32  IdleTicks;                  /* Period for background work in ticks */
+    UINT32  LastIdle;                   /* Tick of last background work */
     static const CHAR *pFunc = __FUNCTION__;
 
     LOG_I(2, pFunc, "Starting communication task");
 
+    IdleTicks = (SMI_SRV_IDLETIME * sysClkRateGet()) / 1000;
+    if (IdleTicks < 1)
+    {
+        IdleTicks = 1;
+    }
+
     /*
      * The function setjmp() acts as entry point after exceptions.
      * This is necessary if you want to restart you application
@@ -376,25 +504,39 @@ MLOCAL void bTaskMain(void)
         /* This branch will be taken after longjmp() (after an exception) */
         LOG_I(2, pFunc, "Task restarted on signal %d.", Status);
 
-        /* Cleanup after an exception */
-        BaseDeinit();
-
-        /* Make base initialization of module (after an exception) */
-        if (BaseInit() < 0)
+        if (BaseIntact())
         {
-            ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_ERROR);
-            if (ret != RES_E_OK)
-            {
-                LOG_E(0, pFunc, "Change of Software-Module-State to EOI failed!");
-            }
+            /*
+             * Only the bTask has been hit, the application tasks keep
+             * running with their state. Release what the interrupted
+             * call may have held.
+             */
+            git_test_wrq_abort();
+            git_test_blk_unpin();
+            LOG_I(1, pFunc, "Base resources intact, application keeps running");
         }
         else
         {
-            /* Module is now running correctly */
-            ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_RUN);
-            if (ret != RES_E_OK)
+            /* Cleanup after an exception */
+            BaseDeinit();
+
+            /* Make base initialization of module (after an exception) */
+            if (BaseInit() < 0)
+            {
+                ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_ERROR);
+                if (ret != RES_E_OK)
+                {
+                    LOG_E(0, pFunc, "Change of Software-Module-State to EOI failed!");
+                }
+            }
+            else
             {
-                LOG_E(0, pFunc, "Change of Software-Module-State to RUN failed!");
+                /* Module is now running correctly */
+                ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_RUN);
+                if (ret != RES_E_OK)
+                {
+                    LOG_E(0, pFunc, "Change of Software-Module-State to RUN failed!");
+                }
             }
         }
     }
@@ -408,7 +550,10 @@ MLOCAL void bTaskMain(void)
      * The timeout in smi_Receive() is only required if the software module
      * expects replies of other modules to own requests,
      * and these replies have to be checked for timeout.
+     * Here the timeout is used for the periodic background work of the
+     * application (git_test_AppIdle).
      */
+    LastIdle = tickGet();
     while (1)
     {
         /*
@@ -419,11 +564,18 @@ MLOCAL void bTaskMain(void)
         sys_CycleEnd();
 
         /* Wait for SMI message in receive buffer */
-        Status = fpSmiReceive(git_test_pSmiId, &Msg, WAIT_FOREVER, &UserSessionId);
+        Status = fpSmiReceive(git_test_pSmiId, &Msg, IdleTicks, &UserSessionId);
 
         /* Inform the system that the cycle starts */
         sys_CycleStart();
 
+        /* Background work, also under permanent SMI load */
+        if ((tickGet() - LastIdle) >= (UINT32)IdleTicks)
+        {
+            LastIdle = tickGet();
+            git_test_AppIdle();
+        }
+
         /* Test if SMI message has been received */
         if (Status != 0)
         {
@@ -489,20 +641,50 @@ MLOCAL void bTaskMain(void)
                      * will be handled by the SVI handler.
                      */
 
-                    /* for information on server and variable properties */
-                case SVI_PROC_GETADDR:
-                case SVI_PROC_GETPVINF:
-                case SVI_PROC_GETSERVINF:
-                    /* mainly used for list access access by SC and HMI */
+                    /*
+                     * Read access: take over the last completed control cycle,
+                     * so that all values of a list or block belong to the same cycle.
+                     */
                 case SVI_PROC_GETVALLST:
-                case SVI_PROC_SETVALLST:
-                    /* mainly used by other applications for single access */
                 case SVI_PROC_GETVAL:
-                case SVI_PROC_SETVAL:
                 case SVI_PROC_GETBLK:
-                case SVI_PROC_SETBLK:
                 case SVI_PROC_GETMULTIBLK:
+                    if (git_test_snap_refresh() < 0)
+                    {
+                        LOG_W(2, git_test_BaseParams.AppName, "%s: no consistent snapshot, SVI read failed", pFunc);
+                        smi_FreeData(&Msg);
+                        if (smi_SendReply(git_test_pSmiId, &Msg, SMI_E_FAILED, 0, 0) < 0)
+                        {
+                            LOG_E(0, pFunc, "smi_SendReply failed!");
+                        }
+                        break;
+                    }
+                    git_test_blk_pin();
+                    LOG_I(4, git_test_BaseParams.AppName, "%s: received call SVI_PROC_GET...", pFunc);
+                    /* Pass call to message handler */
+                    (void)fpSviMsgHandler(git_test_SviHandle, &Msg, git_test_pSmiId, UserSessionId);
+                    git_test_blk_unpin();
+                    break;
+
+                    /*
+                     * Write access: all writes of one call are queued as one group
+                     * and applied by the control task at its next cycle start.
+                     */
+                case SVI_PROC_SETVALLST:
+                case SVI_PROC_SETVAL:
+                case SVI_PROC_SETBLK:
                 case SVI_PROC_SETMULTIBLK:
+                    LOG_I(4, git_test_BaseParams.AppName, "%s: received call SVI_PROC_SET...", pFunc);
+                    git_test_wrq_begin();
+                    /* Pass call to message handler */
+                    (void)fpSviMsgHandler(git_test_SviHandle, &Msg, git_test_pSmiId, UserSessionId);
+                    git_test_wrq_commit();
+                    break;
+
+                    /* for information on server and variable properties */
+                case SVI_PROC_GETADDR:
+                case SVI_PROC_GETPVINF:
+                case SVI_PROC_GETSERVINF:
                     LOG_I(4, git_test_BaseParams.AppName, "%s: received call SVI_PROC_....", pFunc);
                     /* Pass call to message handler */
                     (void)fpSviMsgHandler(git_test_SviHandle, &Msg, git_test_pSmiId, UserSessionId);
@@ -553,7 +735,10 @@ MLOCAL void RpcNull(SMI_MSG *pMsg)
 ********************************************************************************
 * @brief Resets the module to the same state as after template_Init()
 *
-*        All module specific resources were freed and new allocated.
+*        If the base resources are intact, only the application is
+*        restarted and continues with the retained state at "End Of Init".
+*        Otherwise all module specific resources were freed and new
+*        allocated.
 *
 * @param[in]  pMsg    SMI call
 *******************************************************************************/
@@ -563,11 +748,19 @@ MLOCAL void RpcReset(SMI_MSG *pMsg)
     SINT32  ret;
     Reply.RetCode = SMI_E_OK;
 
-    /* Freeing application specific resources */
-    BaseDeinit();
+    /* Warm restart if possible, otherwise freeing all module resources */
+    if (WarmRestart() < 0)
+    {
+        BaseDeinit();
+        ret = BaseInit();
+    }
+    else
+    {
+        ret = OK;
+    }
 
     /* Make base initialization of module */
-    if (BaseInit() < 0)
+    if (ret < 0)
     {
         /* Set module state to ERROR */
         ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_ERROR);
@@ -658,6 +851,9 @@ MLOCAL void RpcRun(SMI_MSG *pMsg)
     }
     else
     {
+        /* Common time of the first cycle of all tasks */
+        git_test_AppResume();
+
         /* Set module state to RUN */
         ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_RUN);
         if (ret != RES_E_OK)
@@ -694,11 +890,11 @@ MLOCAL void RpcNewCfg(SMI_MSG *pMsg)
     if (git_test_ModState == RES_S_STOP || git_test_ModState == RES_S_RUN ||
         git_test_ModState == RES_S_ERROR)
     {
-        /* Remove application (if it is running) */
-        git_test_AppDeinit();
-
-        /* Restart application with the new configuration */
-        if (git_test_CfgRead() || git_test_AppEOI())
+        /*
+         * Take over the new configuration.
+         * The application is only restarted if the changes require it.
+         */
+        if (git_test_AppNewCfg())
         {
             ret = res_ModState(git_test_BaseParams.AppName, git_test_ModState = RES_S_ERROR);
             if (ret != RES_E_OK)
@@ -815,7 +1011,7 @@ MLOCAL void RpcEndOfInit(SMI_MSG *pMsg)
     }
 
     /* Installing my application task */
-    if (git_test_AppEOI() < 0)
+    if ((git_test_AppEOI() < 0) || (MapInfoAlloc() < 0))
     {
         Reply.RetCode = SMI_E_FAILED;
     }
@@ -832,6 +1028,7 @@ MLOCAL void RpcEndOfInit(SMI_MSG *pMsg)
         else
         {
             /* Restart all stopped tasks of the module which are waiting in semTake() */
+            git_test_AppResume();
             (void)semFlush(git_test_StateSema);
 
             LOG_I(1, pFunc, "Module successfully started.");
@@ -903,15 +1100,10 @@ MLOCAL void RpcGetInfo(SMI_MSG *pMsg)
     smi_FreeData(pMsg);
 
     /* Allocate memory for the answer */
-    pReply = smi_MemAlloc(sizeof(*pReply));
+    pReply = git_test_smirpl_get(sizeof(*pReply));
     if (!pReply)
     {
-        LOG_E(0, "RpcGetInfo", "No memory!");
-        if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
-        {
-            LOG_E(0, "RpcGetInfo", "SendReply failed!");
-        }
-
+        git_test_smirpl_sendNoMem(pMsg, "RpcGetInfo");
         return;
     }
 
@@ -939,7 +1131,7 @@ MLOCAL void RpcGetInfo(SMI_MSG *pMsg)
     pReply->RetCode = SMI_E_OK;
 
     /* Send reply */
-    if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_OK, pReply, sizeof(*pReply)) < 0)
+    if (git_test_smirpl_send(pMsg, SMI_E_OK, pReply, sizeof(*pReply)) < 0)
     {
         LOG_E(0, "RpcGetInfo", "SendReply of module information (Ping) failed!");
     }
@@ -961,45 +1153,74 @@ MLOCAL void RpcGetMapInfoLst(SMI_MSG *pMsg)
     UINT32 ReplyLen        = 0;
     UINT32 ChCount         = 0;
     UINT32 i               = 0;
-    CHAR *pPiInVarNames[NbOfPiInCh];
-    CHAR *pPiInMapNames[NbOfPiInCh];
-    CHAR *pPiOutVarNames[NbOfPiOutCh];
-    CHAR *pPiOutMapNames[NbOfPiOutCh];
-    CHAR *pDirectInVarNames[NbOfDirectInCh];
-    CHAR *pDirectInMapNames[NbOfDirectInCh];
-    CHAR *pDirectOutVarNames[NbOfDirectOutCh];
-    CHAR *pDirectOutMapNames[NbOfDirectOutCh];
-    SINT32 *pPiInStatus[NbOfPiInCh];
-    SINT32 *pPiOutStatus[NbOfPiOutCh];
-    SINT32 *pDirectInStatus[NbOfDirectInCh];
-    SINT32 *pDirectOutStatus[NbOfDirectOutCh];
+    UINT32 NbOfCh          = NbOfPiInCh + NbOfPiOutCh + NbOfDirectInCh + NbOfDirectOutCh;
+    void **pTbl;
+    CHAR **pPiInVarNames = NULL;
+    CHAR **pPiInMapNames = NULL;
+    CHAR **pPiOutVarNames = NULL;
+    CHAR **pPiOutMapNames = NULL;
+    CHAR **pDirectInVarNames = NULL;
+    CHAR **pDirectInMapNames = NULL;
+    CHAR **pDirectOutVarNames = NULL;
+    CHAR **pDirectOutMapNames = NULL;
+    SINT32 **pPiInStatus = NULL;
+    SINT32 **pPiOutStatus = NULL;
+    SINT32 **pDirectInStatus = NULL;
+    SINT32 **pDirectOutStatus = NULL;
 
 
     smi_FreeData(pMsg);
 
-    /* Get mapping info of pi variables */
-    (void)git_test_pi_getMapInfo(pPiInVarNames, pPiInMapNames,
-                                pPiOutVarNames, pPiOutMapNames,
-                                pPiInStatus, pPiOutStatus);
+    /* Pointer tables sized at EOI, the number of channels is fixed by the generated code */
+    if (NbOfCh > MapInfoNbOfCh)
+    {
+        git_test_smirpl_sendNoMem(pMsg, "RpcGetMapInfoLst");
+        return;
+    }
+
+    /* No channels: nothing to collect, the reply only holds the counts */
+    if (NbOfCh)
+    {
+        pTbl = pMapInfoTbl;
+        pPiInVarNames      = (CHAR **)pTbl;    pTbl += NbOfPiInCh;
+        pPiInMapNames      = (CHAR **)pTbl;    pTbl += NbOfPiInCh;
+        pPiInStatus        = (SINT32 **)pTbl;  pTbl += NbOfPiInCh;
+        pPiOutVarNames     = (CHAR **)pTbl;    pTbl += NbOfPiOutCh;
+        pPiOutMapNames     = (CHAR **)pTbl;    pTbl += NbOfPiOutCh;
+        pPiOutStatus       = (SINT32 **)pTbl;  pTbl += NbOfPiOutCh;
+        pDirectInVarNames  = (CHAR **)pTbl;    pTbl += NbOfDirectInCh;
+        pDirectInMapNames  = (CHAR **)pTbl;    pTbl += NbOfDirectInCh;
+        pDirectInStatus    = (SINT32 **)pTbl;  pTbl += NbOfDirectInCh;
+        pDirectOutVarNames = (CHAR **)pTbl;    pTbl += NbOfDirectOutCh;
+        pDirectOutMapNames = (CHAR **)pTbl;    pTbl += NbOfDirectOutCh;
+        pDirectOutStatus   = (SINT32 **)pTbl;
+
+        /*
+         * The generated code allocates the names and states of each channel
+         * from the heap, they are freed below. This is the only heap use of
+         * the module after init, see git_test_arena.c.
+         */
 
-    /* Get mapping info of direct variables */
-    (void)git_test_direct_getMapInfo(pDirectInVarNames, pDirectInMapNames,
-                                pDirectOutVarNames, pDirectOutMapNames,
-                                pDirectInStatus, pDirectOutStatus);
+        /* Get mapping info of pi variables */
+        (void)git_test_pi_getMapInfo(pPiInVarNames, pPiInMapNames,
+                                    pPiOutVarNames, pPiOutMapNames,
+                                    pPiInStatus, pPiOutStatus);
+
+        /* Get mapping info of direct variables */
+        (void)git_test_direct_getMapInfo(pDirectInVarNames, pDirectInMapNames,
+                                    pDirectOutVarNames, pDirectOutMapNames,
+                                    pDirectInStatus, pDirectOutStatus);
+    }
 
     /* Calculate length of reply message. */
     ReplyLen = sizeof(*pReply) - (sizeof(SMI_COMPCHINFO)) +
                (NbOfPiInCh + NbOfDirectInCh + NbOfPiOutCh + NbOfDirectOutCh) * sizeof(SMI_COMPCHINFO);
 
     /* Allocate memory for the answer */
-    pReply = smi_MemAlloc((UINT32)ReplyLen);
+    pReply = git_test_smirpl_get((UINT32)ReplyLen);
     if (!pReply)
     {
-        LOG_E(0, "RpcGetMapInfoLst", "No memory!");
-        if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
-        {
-            LOG_E(0, "RpcGetMapInfoLst", "SendReply failed!");
-        }
+        git_test_smirpl_sendNoMem(pMsg, "RpcGetMapInfoLst");
         return;
     }
 
@@ -1065,12 +1286,43 @@ MLOCAL void RpcGetMapInfoLst(SMI_MSG *pMsg)
     pReply->RetCode = SMI_E_OK;
 
 
-    if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_OK, pReply, ReplyLen) < 0)
+    if (git_test_smirpl_send(pMsg, SMI_E_OK, pReply, ReplyLen) < 0)
     {
         LOG_E(0, "RpcGetInfo", "SendReply of module information (Ping) failed!");
     }
 }
 
+/**
+********************************************************************************
+* @brief Carves the pointer tables of RpcGetMapInfoLst() from the arena,
+*        so that neither the stack of the bTask nor the heap is used for them.
+*        Called once at EOI, when the number of channels is known; the
+*        tables are kept until the arena is released at deinit.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, arena exhausted
+*******************************************************************************/
+MLOCAL SINT32 MapInfoAlloc(void)
+{
+    UINT32 NbOfCh = git_test_pi_getNbOfInChans() + git_test_pi_getNbOfOutChans() +
+                    git_test_direct_getNbOfInChans() + git_test_direct_getNbOfOutChans();
+
+    /* Already carved, or no channels at all */
+    if (pMapInfoTbl || !NbOfCh)
+    {
+        return (OK);
+    }
+
+    pMapInfoTbl = git_test_arena_alloc(3 * NbOfCh * sizeof(void *), "mapping info");
+    if (!pMapInfoTbl)
+    {
+        return (ERROR);
+    }
+    MapInfoNbOfCh = NbOfCh;
+
+    return (OK);
+}
+
 /**
 ********************************************************************************
 * @brief Handler for panic-situation.
@@ -1079,9 +1331,15 @@ MLOCAL void RpcGetMapInfoLst(SMI_MSG *pMsg)
 *******************************************************************************/
 MLOCAL void PanicHandler(UINT32 PanicMode)
 {
+    /*
+     * Only the blocks of the retained state which are still dirty are
+     * written, the rest has been written by the bTask before.
+     */
+    git_test_persist_flush();
+
     /*
      * TODO:
-     * Bring critical parts to a predefined state.
-     * For example save data to NV-RAM or close open files.
+     * Bring further critical parts to a predefined state.
+     * For example close open files.
      */
 }
@@ -0,0 +1,278 @@
+/**
+********************************************************************************
+* @file     git_test_param.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the versioned parameter sets of the
+*           control task.
+*
+*           A parameter set is never changed after it has been published.
+*           The bTask fills a free block and publishes it by setting
+*           ParamNext. The control task takes over ParamNext at each cycle
+*           start with a single pointer copy and counts its cycles.
+*           The block which has been replaced is retired with the cycle
+*           count read after the publish. It is free again as soon as the
+*           control task has completed a cycle which started after the
+*           publish, i.e. after two more cycle starts.
+*           Neither side waits for the other one.
+*
+*           Recipes are complete parameter sets stored by SMI call.
+*           Selecting a recipe publishes it as a new set, so all values
+*           change within the same cycle.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "../src-gen/git_test_config.h"
+#include "git_test.h"
+#include "git_test_int.h"
+#include "git_test_param.h"
+
+/* State of a parameter block */
+enum paramState {PARAM_FREE, PARAM_PUBLISHED, PARAM_RETIRED};
+
+/* Parameter block with administration data of the bTask */
+typedef struct PARAM_BLK
+{
+    GIT_TEST_PARAM Param;               /* published parameter set */
+    UINT32  State;                      /* see enum paramState */
+    UINT32  RetireCycle;                /* ParamCycle read when the block was replaced */
+} PARAM_BLK;
+
+/* Recipe slot */
+typedef struct PARAM_RECIPE
+{
+    UINT32  Valid;                      /* recipe has been stored */
+    CONFIG  Config;                     /* configuration values */
+} PARAM_RECIPE;
+
+/* Functions: being called only within this file */
+MLOCAL PARAM_BLK *Param_Alloc(void);
+
+/* Global variables: parameter sets */
+const GIT_TEST_PARAM *git_test_pParam = NULL;
+MLOCAL PARAM_BLK ParamBlk[GIT_TEST_PARAM_NBBLOCKS];
+MLOCAL PARAM_BLK *volatile pParamNext = NULL;  /* published by the bTask */
+MLOCAL volatile UINT32 ParamCycle = 0;  /* cycle starts of the control task */
+MLOCAL UINT32 ParamVersion = 0;         /* version of the latest published set */
+MLOCAL UINT32 ParamActiveVersion = 0;   /* version used by the control task */
+MLOCAL SINT32 ParamActiveRecipe = GIT_TEST_PARAM_FROMCFG;
+MLOCAL PARAM_RECIPE ParamRecipe[GIT_TEST_NB_RECIPES];
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR ParamVarList[] = {
+    {"Param/Version", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &ParamActiveVersion, 0, 0, NULL, NULL, 0, NULL},
+    {"Param/Recipe", SVI_F_OUT | SVI_F_SINT32, sizeof(SINT32),
+     &ParamActiveRecipe, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Sets the first parameter set and frees all others.
+*        Must only be called while the control task is not running.
+*
+* @param[in]  pConfig   configuration values, NULL for all zero
+*******************************************************************************/
+void git_test_param_reset(const CONFIG *pConfig)
+{
+    PARAM_BLK *pBlk = &ParamBlk[0];
+
+    memset(ParamBlk, 0, sizeof(ParamBlk));
+
+    if (pConfig)
+    {
+        pBlk->Param.Config = *pConfig;
+    }
+    pBlk->Param.Version = ++ParamVersion;
+    pBlk->Param.Recipe = GIT_TEST_PARAM_FROMCFG;
+    pBlk->State = PARAM_PUBLISHED;
+
+    pParamNext = pBlk;
+    git_test_pParam = &pBlk->Param;
+    ParamActiveVersion = pBlk->Param.Version;
+    ParamActiveRecipe = pBlk->Param.Recipe;
+    GIT_TEST_MEMBARRIER();
+}
+
+/**
+********************************************************************************
+* @brief Publishes a new parameter set.
+*        The control task takes it over at its next cycle start.
+*        Does not wait for the control task.
+*
+* @param[in]  pConfig   configuration values
+* @param[in]  Recipe    recipe index or GIT_TEST_PARAM_FROMCFG
+*
+* @retval     > 0 .. version of the new set
+* @retval     < 0 .. ERROR, no free block (control task not cycling)
+*******************************************************************************/
+SINT32 git_test_param_publish(const CONFIG *pConfig, SINT32 Recipe)
+{
+    PARAM_BLK *pBlk;
+    PARAM_BLK *pPrev = pParamNext;
+
+    pBlk = Param_Alloc();
+    if (!pBlk)
+    {
+        LOG_W(0, __func__, "No free parameter block, control task is not cycling");
+        return (ERROR);
+    }
+
+    pBlk->Param.Config = *pConfig;
+    pBlk->Param.Version = ++ParamVersion;
+    pBlk->Param.Recipe = Recipe;
+    pBlk->State = PARAM_PUBLISHED;
+
+    /* Block must be complete before it is published */
+    GIT_TEST_MEMBARRIER();
+    pParamNext = pBlk;
+
+    /* Publish must be visible before the cycle count is read */
+    GIT_TEST_MEMBARRIER();
+    if (pPrev)
+    {
+        pPrev->RetireCycle = ParamCycle;
+        pPrev->State = PARAM_RETIRED;
+    }
+
+    LOG_I(1, __func__, "Parameter set %d published", pBlk->Param.Version);
+
+    return ((SINT32)pBlk->Param.Version);
+}
+
+/**
+********************************************************************************
+* @brief Returns the latest published parameter set,
+*        which may not yet be used by the control task.
+*
+* @retval     parameter set, NULL before git_test_param_reset()
+*******************************************************************************/
+const GIT_TEST_PARAM *git_test_param_getLatest(void)
+{
+    return (pParamNext ? &pParamNext->Param : NULL);
+}
+
+/**
+********************************************************************************
+* @brief Stores a recipe.
+*
+* @param[in]  Recipe    recipe index
+* @param[in]  pData     configuration values, layout of CONFIG
+* @param[in]  Len       size of the data, must be sizeof(CONFIG)
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_param_recipeSet(UINT32 Recipe, const void *pData, UINT32 Len)
+{
+    if ((Recipe >= GIT_TEST_NB_RECIPES) || (Len != sizeof(CONFIG)))
+    {
+        LOG_W(0, __func__, "Bad recipe %d or size %d, expected %d", Recipe, Len, sizeof(CONFIG));
+        return (ERROR);
+    }
+
+    memcpy(&ParamRecipe[Recipe].Config, pData, Len);
+    ParamRecipe[Recipe].Valid = TRUE;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Publishes a stored recipe as new parameter set.
+*
+* @param[in]  Recipe    recipe index
+*
+* @retval     > 0 .. version of the new set
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_param_recipeSelect(UINT32 Recipe)
+{
+    if ((Recipe >= GIT_TEST_NB_RECIPES) || !ParamRecipe[Recipe].Valid)
+    {
+        LOG_W(0, __func__, "Recipe %d has not been stored", Recipe);
+        return (ERROR);
+    }
+
+    return (git_test_param_publish(&ParamRecipe[Recipe].Config, (SINT32)Recipe));
+}
+
+/**
+********************************************************************************
+* @brief Takes over the latest published parameter set.
+*        Called by the control task at cycle start, git_test_pParam
+*        does not change until the next cycle start.
+*******************************************************************************/
+void git_test_param_cycleStart(void)
+{
+    PARAM_BLK *pNext = pParamNext;
+
+    if (pNext && (&pNext->Param != git_test_pParam))
+    {
+        git_test_pParam = &pNext->Param;
+        ParamActiveVersion = git_test_pParam->Version;
+        ParamActiveRecipe = git_test_pParam->Recipe;
+    }
+
+    /* Pointer must be read before the cycle is counted */
+    GIT_TEST_MEMBARRIER();
+    ParamCycle++;
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server of the module.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_param_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(ParamVarList,
+                                       sizeof(ParamVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Reclaims retired blocks and returns a free one.
+*        A retired block is free after the control task has started two
+*        more cycles, the second one has read the new block.
+*
+* @retval     free block, NULL if none
+*******************************************************************************/
+MLOCAL PARAM_BLK *Param_Alloc(void)
+{
+    PARAM_BLK *pFree = NULL;
+    UINT32  Cycle = ParamCycle;
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_PARAM_NBBLOCKS; idx++)
+    {
+        if ((ParamBlk[idx].State == PARAM_RETIRED) &&
+            ((Cycle - ParamBlk[idx].RetireCycle) >= 2))
+        {
+            ParamBlk[idx].State = PARAM_FREE;
+        }
+
+        if (!pFree && (ParamBlk[idx].State == PARAM_FREE))
+        {
+            pFree = &ParamBlk[idx];
+        }
+    }
+
+    return (pFree);
+}
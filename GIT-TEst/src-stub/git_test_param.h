@@ -0,0 +1,54 @@
+/**
+********************************************************************************
+* @file     git_test_param.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the versioned parameter
+*           sets of the control task.
+*           CONFIG must be declared before, see src-gen/git_test_config.h.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_PARAM__H
+#define GIT_TEST_PARAM__H
+
+/* Defines: parameter sets */
+#define GIT_TEST_PARAM_NBBLOCKS     4   /* active, pending and retired sets */
+#define GIT_TEST_PARAM_FROMCFG      (-1)    /* Recipe of a set from the configuration file */
+
+/* Parameter set, never changed after it has been published */
+typedef struct GIT_TEST_PARAM
+{
+    UINT32  Version;                    /* increased with each published set */
+    SINT32  Recipe;                     /* recipe index or GIT_TEST_PARAM_FROMCFG */
+    CONFIG  Config;                     /* configuration values */
+} GIT_TEST_PARAM;
+
+/*--- Variables ---*/
+
+/* Control task: parameter set of the current cycle, changes only at cycle start */
+extern const GIT_TEST_PARAM *git_test_pParam;
+
+/*--- Functions ---*/
+
+/* bTask: first set, only while the control task is not running */
+extern void git_test_param_reset(const CONFIG *pConfig);
+
+/* bTask: publish a new set, taken over at the next cycle start */
+extern SINT32 git_test_param_publish(const CONFIG *pConfig, SINT32 Recipe);
+extern const GIT_TEST_PARAM *git_test_param_getLatest(void);
+
+/* bTask: recipes, a selected recipe is published as a new set */
+extern SINT32 git_test_param_recipeSet(UINT32 Recipe, const void *pData, UINT32 Len);
+extern SINT32 git_test_param_recipeSelect(UINT32 Recipe);
+
+/* Control task: take over the latest published set, called at cycle start */
+extern void git_test_param_cycleStart(void);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_param_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,485 @@
+/**
+********************************************************************************
+* @file     git_test_persist.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the persistence of the retained state in
+*           non-volatile memory.
+*
+*           The retained state (GIT_TEST_RETAIN_DATA) is kept in the file
+*           <AppName>.ret in the directory of the configuration file, so it
+*           can be placed on NV-RAM or flash. The file consists of a header
+*           and the state, divided into blocks of GIT_TEST_PERSIST_BLKSIZE
+*           bytes. A shadow copy holds the content of the file.
+*
+*           About once a second the bTask compares the newest checkpoint
+*           of the control task with the shadow. Blocks which differ are
+*           dirty, up to GIT_TEST_PERSIST_TRICKLE of them are written per
+*           call. So the dirty set stays small and the panic handler at
+*           power-down only has to write the residual dirty blocks.
+*
+*           While blocks of different checkpoints are mixed in the file,
+*           its header is marked incomplete. It is marked complete with the
+*           CRC of the state as soon as all blocks are written. Only a
+*           complete file of the same build of the module is loaded at
+*           module init, as the layout of the state may have changed;
+*           otherwise the module starts with a cleared state.
+*
+*           Exported via SVI to size the hold-up time of the power supply:
+*           - "Persist/DirtyBlocks"      dirty blocks at the last check
+*           - "Persist/MaxDirtyBlocks"   maximum of DirtyBlocks
+*           - "Persist/Write_us"         maximum time of one block write
+*           - "Persist/FlushEstimate_us" MaxDirtyBlocks plus two header
+*                                        writes, times Write_us
+*           - "Persist/PanicFlush_us"    duration of the flush at the last
+*                                        power-down, read from the file
+*           - "Persist/Failed"           number of failed writes
+*
+*           The panic handler may interrupt a write of the bTask. The file
+*           is written without stdio, and the panic handler uses a file
+*           descriptor of its own, so an interrupted write of the bTask
+*           cannot disturb its buffer or file position. Each flush is
+*           followed by FIOSYNC, so the data is on the medium, not only in
+*           the cache of the file system. The shadow is updated only after
+*           a block has been written, so an interrupted block is still
+*           dirty and is written again by the panic handler. After the
+*           panic flush the bTask writes nothing more; if its interrupted
+*           block write still completes, the CRC in the header no longer
+*           matches and the file is not loaded (cold start instead of a
+*           mixed state).
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <ioLib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_control.h"
+#include "git_test_cfgimg.h"
+#include "git_test_retain.h"
+#include "git_test_persist.h"
+
+/* Defines: file */
+#define PERSIST_MAGIC       0x52455450  /* marks a file of this module */
+#define PERSIST_VERSION     2           /* increment on changes of PERSIST_HDR */
+#define PERSIST_IDLEDIV     10          /* check every 10th idle call */
+#define PERSIST_ALLBLKS     0xFFFFFFFF  /* no limit of blocks per call */
+
+/* Header of the file, followed by the state */
+typedef struct PERSIST_HDR
+{
+    UINT32  Magic;                      /* PERSIST_MAGIC */
+    UINT32  Version;                    /* PERSIST_VERSION */
+    CHAR    Build[24];                  /* build time of the module, layout of the state */
+    UINT32  Size;                       /* sizeof(GIT_TEST_RETAIN_DATA) */
+    UINT32  Seq;                        /* checkpoint of the state */
+    UINT32  Crc;                        /* CRC32 of the state */
+    UINT32  Complete;                   /* all blocks belong to checkpoint Seq */
+    UINT32  FlushTime_us;               /* duration of the last panic flush */
+} PERSIST_HDR;
+
+/* Functions: being called only within this file */
+MLOCAL UINT32 Persist_Write(int Fd, const GIT_TEST_RETAIN_DATA *pSnap, UINT32 Seq,
+                            UINT32 MaxBlks, UINT32 *pNbWritten);
+MLOCAL SINT32 Persist_PutHdr(int Fd, UINT32 Complete, UINT32 Seq);
+MLOCAL SINT32 Persist_Put(int Fd, UINT32 Offset, const void *pData, UINT32 Len);
+MLOCAL SINT32 Persist_Load(int Fd);
+
+/* Global variables: file */
+MLOCAL int PersistFd = ERROR;           /* file descriptor of the bTask */
+MLOCAL int PersistPanicFd = ERROR;      /* file descriptor of the panic handler */
+MLOCAL volatile UINT32 PersistPanic = FALSE;    /* panic flush has started, bTask stops writing */
+MLOCAL PERSIST_HDR PersistHdr;          /* header as in the file */
+MLOCAL GIT_TEST_RETAIN_DATA PersistShadow;      /* state as in the file */
+MLOCAL GIT_TEST_RETAIN_DATA PersistSnap;        /* checkpoint being written by the bTask */
+MLOCAL GIT_TEST_RETAIN_DATA PersistPanicSnap;   /* checkpoint being written by the panic handler */
+MLOCAL UINT32 PersistIdleCnt = 0;
+MLOCAL UINT32 PersistFlushStart = 0;    /* start time of the panic flush, 0 if none */
+
+/* Global variables: statistics */
+MLOCAL UINT32 PersistDirty = 0;
+MLOCAL UINT32 PersistMaxDirty = 0;
+MLOCAL UINT32 PersistWrite_us = 0;
+MLOCAL UINT32 PersistEstimate_us = 0;
+MLOCAL UINT32 PersistPanicFlush_us = 0;
+MLOCAL UINT32 PersistFailed = 0;
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR PersistVarList[] = {
+    {"Persist/DirtyBlocks", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistDirty, 0, 0, NULL, NULL, 0, NULL},
+    {"Persist/MaxDirtyBlocks", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistMaxDirty, 0, 0, NULL, NULL, 0, NULL},
+    {"Persist/Write_us", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistWrite_us, 0, 0, NULL, NULL, 0, NULL},
+    {"Persist/FlushEstimate_us", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistEstimate_us, 0, 0, NULL, NULL, 0, NULL},
+    {"Persist/PanicFlush_us", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistPanicFlush_us, 0, 0, NULL, NULL, 0, NULL},
+    {"Persist/Failed", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &PersistFailed, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Opens the file and loads the retained state from it.
+*        Being called at BaseInit by the bTask. If the file is missing or
+*        incomplete, it is created with a cleared state.
+*        A missing file system is not an error, the state is just not
+*        persistent then.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_persist_init(void)
+{
+    static const CHAR *pFunc = __func__;
+    CHAR    FileName[M_PATHLEN_A];
+
+    PersistIdleCnt = 0;
+    PersistPanic = FALSE;
+    memset(&PersistHdr, 0, sizeof(PersistHdr));
+    memset(&PersistShadow, 0, sizeof(PersistShadow));
+
+    if (git_test_cfgimg_fileName(FileName, sizeof(FileName), GIT_TEST_PERSIST_EXT) < 0)
+    {
+        LOG_W(0, pFunc, "No file name, retained state is not persistent");
+        return (OK);
+    }
+
+    PersistFd = open(FileName, O_RDWR, 0);
+    if (PersistFd != ERROR)
+    {
+        if (Persist_Load(PersistFd) == OK)
+        {
+            PersistPanicFlush_us = PersistHdr.FlushTime_us;
+
+            /* After a reset, the checkpoints in memory are newer */
+            if (!git_test_retain_avail())
+            {
+                git_test_retain_load(&PersistShadow, PersistHdr.Seq);
+                LOG_I(1, pFunc, "Retained state loaded from '%s'", FileName);
+            }
+        }
+        else
+        {
+            LOG_W(0, pFunc, "Retained state in '%s' is incomplete or outdated", FileName);
+            (void)close(PersistFd);
+            PersistFd = ERROR;
+        }
+    }
+
+    /* New file with a cleared state, all blocks written */
+    if (PersistFd == ERROR)
+    {
+        PersistFd = open(FileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (PersistFd == ERROR)
+        {
+            LOG_W(0, pFunc, "Could not create '%s', retained state is not persistent", FileName);
+            return (OK);
+        }
+
+        memset(&PersistHdr, 0, sizeof(PersistHdr));
+        memset(&PersistShadow, 0, sizeof(PersistShadow));
+        if ((Persist_PutHdr(PersistFd, FALSE, 0) < 0) ||
+            (Persist_Put(PersistFd, sizeof(PERSIST_HDR), &PersistShadow, sizeof(PersistShadow)) < 0))
+        {
+            (void)close(PersistFd);
+            PersistFd = ERROR;
+            return (OK);
+        }
+        (void)ioctl(PersistFd, FIOSYNC, 0);
+    }
+
+    /* The panic handler must not share the file position of the bTask */
+    PersistPanicFd = open(FileName, O_RDWR, 0);
+    if (PersistPanicFd == ERROR)
+    {
+        LOG_W(0, pFunc, "Could not open '%s' for the panic handler", FileName);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Writes all dirty blocks and closes the file.
+*        Being called at BaseDeinit by the bTask, after the control task
+*        has been deleted.
+*******************************************************************************/
+void git_test_persist_deinit(void)
+{
+    UINT32  Seq;
+    UINT32  NbWritten;
+
+    if (PersistPanicFd != ERROR)
+    {
+        (void)close(PersistPanicFd);
+        PersistPanicFd = ERROR;
+    }
+
+    if (PersistFd == ERROR)
+    {
+        return;
+    }
+
+    if (git_test_retain_read(&PersistSnap, &Seq) == OK)
+    {
+        (void)Persist_Write(PersistFd, &PersistSnap, Seq, PERSIST_ALLBLKS, &NbWritten);
+    }
+
+    (void)close(PersistFd);
+    PersistFd = ERROR;
+}
+
+/**
+********************************************************************************
+* @brief Writes some dirty blocks of the newest checkpoint.
+*        Called periodically by the bTask in the idle hook.
+*******************************************************************************/
+void git_test_persist_idle(void)
+{
+    UINT32  Seq;
+    UINT32  Start;
+    UINT32  Time_us;
+    UINT32  NbWritten;
+
+    if (++PersistIdleCnt < PERSIST_IDLEDIV)
+    {
+        return;
+    }
+    PersistIdleCnt = 0;
+
+    if ((PersistFd == ERROR) || (git_test_retain_read(&PersistSnap, &Seq) < 0))
+    {
+        return;
+    }
+
+    Start = m_GetProcTime();
+    PersistDirty = Persist_Write(PersistFd, &PersistSnap, Seq, GIT_TEST_PERSIST_TRICKLE,
+                                 &NbWritten);
+    if (PersistDirty > PersistMaxDirty)
+    {
+        PersistMaxDirty = PersistDirty;
+    }
+
+    /* Worst case of the panic flush: all dirty blocks and two header writes */
+    if (NbWritten)
+    {
+        Time_us = (m_GetProcTime() - Start) / NbWritten;
+        if (Time_us > PersistWrite_us)
+        {
+            PersistWrite_us = Time_us;
+        }
+    }
+    PersistEstimate_us = (PersistMaxDirty + 2) * PersistWrite_us;
+}
+
+/**
+********************************************************************************
+* @brief Writes all dirty blocks of the newest checkpoint.
+*        Called by the panic handler at power-down, the time needed is
+*        stored in the header, which is written last.
+*        Uses its own file descriptor, the bTask may be interrupted within
+*        a write.
+*******************************************************************************/
+void git_test_persist_flush(void)
+{
+    UINT32  Seq;
+    UINT32  NbWritten;
+
+    PersistPanic = TRUE;
+    PersistFlushStart = m_GetProcTime();
+    if ((PersistPanicFd != ERROR) && (git_test_retain_read(&PersistPanicSnap, &Seq) == OK))
+    {
+        (void)Persist_Write(PersistPanicFd, &PersistPanicSnap, Seq, PERSIST_ALLBLKS, &NbWritten);
+    }
+    PersistFlushStart = 0;
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_persist_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(PersistVarList,
+                                       sizeof(PersistVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Writes the dirty blocks of a checkpoint.
+*        The header is marked incomplete before the first block is written
+*        and complete after the last one. The bTask stops as soon as the
+*        panic flush has started.
+*
+* @param[in]  Fd          file descriptor of the calling task
+* @param[in]  pSnap       checkpoint
+* @param[in]  Seq         number of the checkpoint
+* @param[in]  MaxBlks     maximum number of blocks to be written
+* @param[out] pNbWritten  number of blocks written
+*
+* @retval     number of dirty blocks before writing
+*******************************************************************************/
+MLOCAL UINT32 Persist_Write(int Fd, const GIT_TEST_RETAIN_DATA *pSnap, UINT32 Seq,
+                            UINT32 MaxBlks, UINT32 *pNbWritten)
+{
+    UINT32  Stop = (Fd != PersistPanicFd);  /* bTask: stop on a panic flush */
+    const UINT8 *pSrc = (const UINT8 *)pSnap;
+    UINT8  *pShadow = (UINT8 *)&PersistShadow;
+    UINT32  NbOfDirty = 0;
+    UINT32  NbWritten = 0;
+    UINT32  Offset;
+    UINT32  Len;
+    UINT32  HdrWritten = FALSE;
+    SINT32  ret = OK;
+
+    for (Offset = 0; Offset < sizeof(GIT_TEST_RETAIN_DATA); Offset += GIT_TEST_PERSIST_BLKSIZE)
+    {
+        Len = sizeof(GIT_TEST_RETAIN_DATA) - Offset;
+        if (Len > GIT_TEST_PERSIST_BLKSIZE)
+        {
+            Len = GIT_TEST_PERSIST_BLKSIZE;
+        }
+
+        if (memcmp(pSrc + Offset, pShadow + Offset, Len) == 0)
+        {
+            continue;
+        }
+
+        NbOfDirty++;
+        if ((NbWritten >= MaxBlks) || (ret < 0) || (Stop && PersistPanic))
+        {
+            continue;
+        }
+
+        /* Blocks of different checkpoints are mixed until all are written */
+        if (PersistHdr.Complete)
+        {
+            ret = Persist_PutHdr(Fd, FALSE, PersistHdr.Seq);
+            HdrWritten = TRUE;
+        }
+        if (ret == OK)
+        {
+            ret = Persist_Put(Fd, sizeof(PERSIST_HDR) + Offset, pSrc + Offset, Len);
+        }
+        if (ret == OK)
+        {
+            memcpy(pShadow + Offset, pSrc + Offset, Len);
+            NbWritten++;
+        }
+    }
+
+    if ((ret == OK) && (NbWritten == NbOfDirty) && !PersistHdr.Complete &&
+        !(Stop && PersistPanic))
+    {
+        (void)Persist_PutHdr(Fd, TRUE, Seq);
+        HdrWritten = TRUE;
+    }
+
+    /* Data must be on the medium, not only in the cache of the file system */
+    if (NbWritten || HdrWritten)
+    {
+        (void)ioctl(Fd, FIOSYNC, 0);
+    }
+
+    *pNbWritten = NbWritten;
+    return (NbOfDirty);
+}
+
+/**
+********************************************************************************
+* @brief Writes the header.
+*
+* @param[in]  Fd          file descriptor of the calling task
+* @param[in]  Complete    all blocks of the state are written
+* @param[in]  Seq         number of the checkpoint
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Persist_PutHdr(int Fd, UINT32 Complete, UINT32 Seq)
+{
+    PersistHdr.Magic = PERSIST_MAGIC;
+    PersistHdr.Version = PERSIST_VERSION;
+    strncpy(PersistHdr.Build, __DATE__ " " __TIME__, sizeof(PersistHdr.Build));
+    PersistHdr.Size = sizeof(GIT_TEST_RETAIN_DATA);
+    PersistHdr.Seq = Seq;
+    PersistHdr.Crc = git_test_cfgimg_crc(&PersistShadow, sizeof(PersistShadow));
+    PersistHdr.Complete = Complete;
+
+    /* Time of the panic flush up to its last write */
+    if (Complete && PersistFlushStart)
+    {
+        PersistHdr.FlushTime_us = m_GetProcTime() - PersistFlushStart;
+    }
+
+    return (Persist_Put(Fd, 0, &PersistHdr, sizeof(PersistHdr)));
+}
+
+/**
+********************************************************************************
+* @brief Writes a range of the file.
+*
+* @param[in]  Fd          file descriptor of the calling task
+* @param[in]  Offset      position in the file
+* @param[in]  pData       data
+* @param[in]  Len         length in bytes
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Persist_Put(int Fd, UINT32 Offset, const void *pData, UINT32 Len)
+{
+    if ((lseek(Fd, (off_t)Offset, SEEK_SET) == ERROR) ||
+        (write(Fd, (char *)pData, Len) != (int)Len))
+    {
+        PersistFailed++;
+        return (ERROR);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads the header and the state into the shadow.
+*
+* @param[in]  Fd          file descriptor, positioned at the start of the file
+*
+* @retval     = 0 .. OK, file is complete and of this build
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Persist_Load(int Fd)
+{
+    if ((read(Fd, (char *)&PersistHdr, sizeof(PersistHdr)) != (int)sizeof(PersistHdr)) ||
+        (PersistHdr.Magic != PERSIST_MAGIC) ||
+        (PersistHdr.Version != PERSIST_VERSION) ||
+        (strncmp(PersistHdr.Build, __DATE__ " " __TIME__, sizeof(PersistHdr.Build)) != 0) ||
+        (PersistHdr.Size != sizeof(GIT_TEST_RETAIN_DATA)) ||
+        !PersistHdr.Complete ||
+        (read(Fd, (char *)&PersistShadow, sizeof(PersistShadow)) != (int)sizeof(PersistShadow)) ||
+        (git_test_cfgimg_crc(&PersistShadow, sizeof(PersistShadow)) != PersistHdr.Crc))
+    {
+        return (ERROR);
+    }
+
+    return (OK);
+}
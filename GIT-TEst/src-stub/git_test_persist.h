@@ -0,0 +1,37 @@
+/**
+********************************************************************************
+* @file     git_test_persist.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the persistence of the
+*           retained state in non-volatile memory.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_PERSIST__H
+#define GIT_TEST_PERSIST__H
+
+/* Defines: persistence */
+#define GIT_TEST_PERSIST_BLKSIZE    64  /* bytes per block, the unit of dirty tracking */
+#define GIT_TEST_PERSIST_TRICKLE    4   /* blocks written per idle call of the bTask */
+#define GIT_TEST_PERSIST_EXT        ".ret"  /* file name: <AppName>.ret, next to the config */
+
+/*--- Functions ---*/
+
+/* bTask: open the file and load its state at BaseInit; final flush and close at BaseDeinit */
+extern SINT32 git_test_persist_init(void);
+extern void git_test_persist_deinit(void);
+
+/* bTask: write some dirty blocks, called periodically */
+extern void git_test_persist_idle(void);
+
+/* Panic handler: write all remaining dirty blocks */
+extern void git_test_persist_flush(void);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_persist_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,507 @@
+/**
+********************************************************************************
+* @file     git_test_pid.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the PID controller blocks of the control task.
+*
+*           A bank holds up to GIT_TEST_PID_MAXINST controllers in
+*           struct-of-arrays layout. git_test_pid_cycle() works in three
+*           passes:
+*           - gather: the bound values are read from the process image
+*           - update: all controllers are computed in one loop without
+*             calls and branches, so the compiler can vectorize it
+*           - scatter: the outputs are written to the process image
+*           Each controller has:
+*           - derivative part on the process value with a first order
+*             filter, so there is no kick on setpoint steps. After setup
+*             and reset, the last process value is taken from the first
+*             gather, so there is no kick from a process value of 0 either
+*           - anti-windup: the integral part is held while the output is
+*             limited and the integration would drive it further
+*           - bumpless switching: in manual mode the integral part tracks
+*             the manual output
+*           - its own time base: it runs every CycleDiv-th cycle with the
+*             sum of the cycle times since its last update
+*           The time since the last cycle is passed by the caller, in the
+*           control task it is git_test_AppCycleDt().
+*           Only the states of a bank are retained (git_test_pid_save()/
+*           git_test_pid_load()), so changed settings always take effect.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_pid.h"
+
+/* Defines: index of the bindings in GIT_TEST_PID_BANK.Bind */
+#define PID_SP          0
+#define PID_PV          1
+#define PID_MAN         2
+#define PID_OUT         3
+#define PID_NBOFBINDS   4
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 Pid_BindCheck(const GIT_TEST_PID_BIND *pBind, UINT32 Inst, UINT32 IsOutput);
+MLOCAL REAL32 Pid_Get(const GIT_TEST_PID_BIND *pBind, const IN_VARS *pInVars,
+                      const OUT_VARS *pOutVars, REAL32 Value);
+MLOCAL void Pid_Put(const GIT_TEST_PID_BIND *pBind, OUT_VARS *pOutVars, REAL32 Value);
+MLOCAL void Pid_Update(GIT_TEST_PID_BANK *pBank, const UINT32 *pDue, const REAL32 *pDt);
+
+/**
+********************************************************************************
+* @brief Takes over the settings of all controllers.
+*        May be called again, e.g. after a new parameter set: the states are
+*        kept as long as the number of controllers is unchanged. Otherwise
+*        the bank is cleared and all controllers start in manual mode.
+*        On an error, the bank is not changed.
+*
+* @param[in]  pBank       controller bank
+* @param[in]  pCfg        settings, one per controller
+* @param[in]  NbOfInst    number of controllers
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_pid_setup(GIT_TEST_PID_BANK *pBank, const GIT_TEST_PID_CFG *pCfg,
+                          UINT32 NbOfInst)
+{
+    static const CHAR *pFunc = __func__;
+    const GIT_TEST_PID_CFG *pInst;
+    UINT32  idx;
+
+    if (NbOfInst > GIT_TEST_PID_MAXINST)
+    {
+        LOG_E(0, pFunc, "Too many controllers: %d, maximum is %d", NbOfInst, GIT_TEST_PID_MAXINST);
+        return (ERROR);
+    }
+
+    /* Check all settings before anything is changed */
+    for (idx = 0; idx < NbOfInst; idx++)
+    {
+        pInst = &pCfg[idx];
+        if ((pInst->Ti_s < 0) || (pInst->Td_s < 0) || (pInst->Tf_s < 0) ||
+            (pInst->OutMin > pInst->OutMax) || (pInst->CycleDiv > GIT_TEST_PID_MAXDIV))
+        {
+            LOG_E(0, pFunc, "Bad settings of controller %d", idx);
+            return (ERROR);
+        }
+
+        if ((Pid_BindCheck(&pInst->Sp, idx, FALSE) < 0) ||
+            (Pid_BindCheck(&pInst->Pv, idx, FALSE) < 0) ||
+            (Pid_BindCheck(&pInst->Man, idx, FALSE) < 0) ||
+            (Pid_BindCheck(&pInst->Out, idx, TRUE) < 0))
+        {
+            return (ERROR);
+        }
+    }
+
+    if (NbOfInst != pBank->NbOfInst)
+    {
+        memset(pBank, 0, sizeof(*pBank));
+    }
+
+    for (idx = 0; idx < NbOfInst; idx++)
+    {
+        pInst = &pCfg[idx];
+        pBank->Bind[PID_SP][idx] = pInst->Sp;
+        pBank->Bind[PID_PV][idx] = pInst->Pv;
+        pBank->Bind[PID_MAN][idx] = pInst->Man;
+        pBank->Bind[PID_OUT][idx] = pInst->Out;
+        pBank->Kp[idx] = pInst->Kp;
+        pBank->InvTi[idx] = (pInst->Ti_s > 0) ? (1.0f / pInst->Ti_s) : 0;
+        pBank->Td[idx] = pInst->Td_s;
+        pBank->Tf[idx] = pInst->Tf_s;
+        pBank->OutMin[idx] = pInst->OutMin;
+        pBank->OutMax[idx] = pInst->OutMax;
+        pBank->CycleDiv[idx] = pInst->CycleDiv ? pInst->CycleDiv : 1;
+    }
+    pBank->NbOfInst = NbOfInst;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Clears the states of all controllers, the settings and the modes
+*        are kept.
+*
+* @param[in]  pBank       controller bank
+*******************************************************************************/
+void git_test_pid_reset(GIT_TEST_PID_BANK *pBank)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < pBank->NbOfInst; idx++)
+    {
+        pBank->DivCnt[idx] = 0;
+        pBank->Elapsed[idx] = 0;
+        pBank->I[idx] = 0;
+        pBank->D[idx] = 0;
+        pBank->PrevValid[idx] = FALSE;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Copies the states of all controllers, to be kept in the retained
+*        state. Called by the control task at the end of each cycle.
+*
+* @param[in]  pBank       controller bank
+* @param[out] pSave       states
+*******************************************************************************/
+void git_test_pid_save(const GIT_TEST_PID_BANK *pBank, GIT_TEST_PID_SAVE *pSave)
+{
+    UINT32  Nb = pBank->NbOfInst;
+
+    pSave->NbOfInst = Nb;
+    memcpy(pSave->Auto, pBank->Auto, Nb * sizeof(UINT32));
+    memcpy(pSave->Out, pBank->Out, Nb * sizeof(REAL32));
+    memcpy(pSave->I, pBank->I, Nb * sizeof(REAL32));
+    memcpy(pSave->D, pBank->D, Nb * sizeof(REAL32));
+    memcpy(pSave->PrevPv, pBank->PrevPv, Nb * sizeof(REAL32));
+    memcpy(pSave->PrevValid, pBank->PrevValid, Nb * sizeof(UINT32));
+}
+
+/**
+********************************************************************************
+* @brief Continues all controllers in their retained states.
+*        Called by the control task before the first cycle, after
+*        git_test_pid_setup(). States of a different number of controllers
+*        (cold start, changed settings) are not used, the controllers are
+*        reset and start in manual mode then.
+*
+* @param[in]  pBank       controller bank, set up
+* @param[in]  pSave       retained states
+*******************************************************************************/
+void git_test_pid_load(GIT_TEST_PID_BANK *pBank, const GIT_TEST_PID_SAVE *pSave)
+{
+    UINT32  Nb = pBank->NbOfInst;
+    UINT32  idx;
+
+    git_test_pid_reset(pBank);
+
+    if (!Nb || (pSave->NbOfInst != Nb))
+    {
+        memset(pBank->Auto, 0, sizeof(pBank->Auto));
+        memset(pBank->Out, 0, sizeof(pBank->Out));
+        if (Nb)
+        {
+            LOG_I(1, __func__, "No retained states, all controllers in manual mode");
+        }
+        return;
+    }
+
+    for (idx = 0; idx < Nb; idx++)
+    {
+        pBank->Auto[idx] = pSave->Auto[idx] ? TRUE : FALSE;
+        pBank->Out[idx] = pSave->Out[idx];
+        pBank->I[idx] = pSave->I[idx];
+        pBank->D[idx] = pSave->D[idx];
+        pBank->PrevPv[idx] = pSave->PrevPv[idx];
+        pBank->PrevValid[idx] = pSave->PrevValid[idx] ? TRUE : FALSE;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Switches a controller between manual and automatic mode.
+*        The switch is bumpless in both directions: the integral part
+*        tracks the manual output, and the manual output should be preset
+*        with the last output (GIT_TEST_PID_BANK.Out) before switching to
+*        manual mode.
+*
+* @param[in]  pBank       controller bank
+* @param[in]  Inst        index of the controller
+* @param[in]  Auto        TRUE .. automatic, FALSE .. manual mode
+*******************************************************************************/
+void git_test_pid_setAuto(GIT_TEST_PID_BANK *pBank, UINT32 Inst, UINT32 Auto)
+{
+    if (Inst < pBank->NbOfInst)
+    {
+        pBank->Auto[Inst] = Auto ? TRUE : FALSE;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Updates all controllers of a bank.
+*        Called once per cycle by the control task.
+*
+* @param[in]  pBank       controller bank
+* @param[in]  pInVars     process image input data
+* @param[in,out] pOutVars  process image output data
+* @param[in]  Dt_s        time since the last call in s
+*******************************************************************************/
+void git_test_pid_cycle(GIT_TEST_PID_BANK *pBank, const IN_VARS *pInVars,
+                        OUT_VARS *pOutVars, REAL32 Dt_s)
+{
+    UINT32  Due[GIT_TEST_PID_MAXINST];
+    REAL32  Dt[GIT_TEST_PID_MAXINST];
+    UINT32  idx;
+
+    /* Gather: time base and bound inputs */
+    for (idx = 0; idx < pBank->NbOfInst; idx++)
+    {
+        pBank->DivCnt[idx]++;
+        pBank->Elapsed[idx] += Dt_s;
+        Due[idx] = (pBank->DivCnt[idx] >= pBank->CycleDiv[idx]);
+        Dt[idx] = pBank->Elapsed[idx];
+        if (Due[idx])
+        {
+            pBank->DivCnt[idx] = 0;
+            pBank->Elapsed[idx] = 0;
+        }
+
+        pBank->Sp[idx] = Pid_Get(&pBank->Bind[PID_SP][idx], pInVars, pOutVars, pBank->Sp[idx]);
+        pBank->Pv[idx] = Pid_Get(&pBank->Bind[PID_PV][idx], pInVars, pOutVars, pBank->Pv[idx]);
+        pBank->Man[idx] = Pid_Get(&pBank->Bind[PID_MAN][idx], pInVars, pOutVars, pBank->Man[idx]);
+
+        /* First pass after setup or reset: no derivative of the step from 0 */
+        if (!pBank->PrevValid[idx])
+        {
+            pBank->PrevPv[idx] = pBank->Pv[idx];
+            pBank->PrevValid[idx] = TRUE;
+        }
+    }
+
+    Pid_Update(pBank, Due, Dt);
+
+    /* Scatter: outputs of the updated controllers */
+    for (idx = 0; idx < pBank->NbOfInst; idx++)
+    {
+        if (Due[idx])
+        {
+            Pid_Put(&pBank->Bind[PID_OUT][idx], pOutVars, pBank->Out[idx]);
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Computes all controllers of a bank.
+*        One loop over the arrays without calls and branches, the
+*        conditions are selects. Controllers which are not due keep their
+*        states and output.
+*
+* @param[in]  pBank       controller bank
+* @param[in]  pDue        TRUE if the controller is to be updated
+* @param[in]  pDt         time since the last update of the controller in s
+*******************************************************************************/
+MLOCAL void Pid_Update(GIT_TEST_PID_BANK *pBank, const UINT32 *pDue, const REAL32 *pDt)
+{
+    UINT32  Nb = pBank->NbOfInst;
+    UINT32  idx;
+
+    for (idx = 0; idx < Nb; idx++)
+    {
+        REAL32  Pv = pBank->Pv[idx];
+        REAL32  Err = pBank->Sp[idx] - Pv;
+        REAL32  Kp = pBank->Kp[idx];
+        REAL32  Tf = pBank->Tf[idx];
+        REAL32  Dt = pDt[idx];
+        REAL32  Min = pBank->OutMin[idx];
+        REAL32  Max = pBank->OutMax[idx];
+        REAL32  Den = Tf + Dt;
+        REAL32  P, D, Inc, I, U, Sat, Man;
+
+        P = Kp * Err;
+
+        /* Derivative of the process value, backward Euler with filter */
+        D = (Den > 0) ?
+            (((Tf * pBank->D[idx]) + (Kp * pBank->Td[idx] * (pBank->PrevPv[idx] - Pv))) / Den) : 0;
+
+        /* Anti-windup: no integration further into a limit */
+        Inc = Kp * pBank->InvTi[idx] * Dt * Err;
+        U = P + pBank->I[idx] + Inc + D;
+        Inc = (((U > Max) && (Inc > 0)) || ((U < Min) && (Inc < 0))) ? 0 : Inc;
+        I = pBank->I[idx] + Inc;
+        U = P + I + D;
+        Sat = (U > Max) ? Max : ((U < Min) ? Min : U);
+
+        /* Manual mode: the integral part tracks the manual output */
+        Man = pBank->Man[idx];
+        Man = (Man > Max) ? Max : ((Man < Min) ? Min : Man);
+        I = pBank->Auto[idx] ? I : (Man - P - D);
+        Sat = pBank->Auto[idx] ? Sat : Man;
+
+        pBank->I[idx] = pDue[idx] ? I : pBank->I[idx];
+        pBank->D[idx] = pDue[idx] ? D : pBank->D[idx];
+        pBank->PrevPv[idx] = pDue[idx] ? Pv : pBank->PrevPv[idx];
+        pBank->Out[idx] = pDue[idx] ? Sat : pBank->Out[idx];
+    }
+}
+
+/**
+********************************************************************************
+* @brief Checks a binding against the size of the process image.
+*
+* @param[in]  pBind       binding
+* @param[in]  Inst        index of the controller, for messages
+* @param[in]  IsOutput    TRUE if the binding is written
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Pid_BindCheck(const GIT_TEST_PID_BIND *pBind, UINT32 Inst, UINT32 IsOutput)
+{
+    static const CHAR *pFunc = __func__;
+    UINT32  Size;
+    UINT32  Limit;
+
+    switch (pBind->Format)
+    {
+        case GIT_TEST_PID_F_REAL32:
+        case GIT_TEST_PID_F_SINT32:
+            Size = sizeof(UINT32);
+            break;
+        case GIT_TEST_PID_F_SINT16:
+        case GIT_TEST_PID_F_UINT16:
+            Size = sizeof(UINT16);
+            break;
+        default:
+            LOG_E(0, pFunc, "Controller %d: unknown format %d", Inst, pBind->Format);
+            return (ERROR);
+    }
+
+    switch (pBind->Src)
+    {
+        case GIT_TEST_PID_SRC_NONE:
+            return (OK);
+        case GIT_TEST_PID_SRC_IN:
+            Limit = IsOutput ? 0 : sizeof(IN_VARS);
+            break;
+        case GIT_TEST_PID_SRC_OUT:
+            Limit = sizeof(OUT_VARS);
+            break;
+        default:
+            Limit = 0;
+            break;
+    }
+
+    if ((pBind->Offset + Size) > Limit)
+    {
+        LOG_E(0, pFunc, "Controller %d: bad binding, source %d, offset %d",
+              Inst, pBind->Src, pBind->Offset);
+        return (ERROR);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads a bound value from the process image.
+*
+* @param[in]  pBind       binding
+* @param[in]  pInVars     process image input data
+* @param[in]  pOutVars    process image output data
+* @param[in]  Value       value which is returned if not bound
+*
+* @retval     value in engineering units
+*******************************************************************************/
+MLOCAL REAL32 Pid_Get(const GIT_TEST_PID_BIND *pBind, const IN_VARS *pInVars,
+                      const OUT_VARS *pOutVars, REAL32 Value)
+{
+    const UINT8 *pRaw;
+    REAL32  Real;
+    SINT32  Sint32;
+    SINT16  Sint16;
+    UINT16  Uint16;
+
+    switch (pBind->Src)
+    {
+        case GIT_TEST_PID_SRC_IN:
+            pRaw = (const UINT8 *)pInVars + pBind->Offset;
+            break;
+        case GIT_TEST_PID_SRC_OUT:
+            pRaw = (const UINT8 *)pOutVars + pBind->Offset;
+            break;
+        default:
+            return (Value);
+    }
+
+    /* Elements of the process image need not be aligned */
+    switch (pBind->Format)
+    {
+        case GIT_TEST_PID_F_SINT32:
+            memcpy(&Sint32, pRaw, sizeof(Sint32));
+            Real = (REAL32)Sint32;
+            break;
+        case GIT_TEST_PID_F_SINT16:
+            memcpy(&Sint16, pRaw, sizeof(Sint16));
+            Real = (REAL32)Sint16;
+            break;
+        case GIT_TEST_PID_F_UINT16:
+            memcpy(&Uint16, pRaw, sizeof(Uint16));
+            Real = (REAL32)Uint16;
+            break;
+        default:
+            memcpy(&Real, pRaw, sizeof(Real));
+            break;
+    }
+
+    return (pBind->Scale ? (Real * pBind->Scale) : Real);
+}
+
+/**
+********************************************************************************
+* @brief Writes a value to a bound element of the process image.
+*        Integer formats are rounded and limited to their range.
+*
+* @param[in]  pBind       binding
+* @param[out] pOutVars    process image output data
+* @param[in]  Value       value in engineering units
+*******************************************************************************/
+MLOCAL void Pid_Put(const GIT_TEST_PID_BIND *pBind, OUT_VARS *pOutVars, REAL32 Value)
+{
+    UINT8   *pRaw;
+    REAL32  Raw;
+    SINT32  Sint32;
+    SINT16  Sint16;
+    UINT16  Uint16;
+
+    if (pBind->Src != GIT_TEST_PID_SRC_OUT)
+    {
+        return;
+    }
+
+    pRaw = (UINT8 *)pOutVars + pBind->Offset;
+    Raw = pBind->Scale ? (Value / pBind->Scale) : Value;
+
+    switch (pBind->Format)
+    {
+        case GIT_TEST_PID_F_SINT32:
+            Raw = (Raw > 2147483520.0f) ? 2147483520.0f : ((Raw < -2147483648.0f) ? -2147483648.0f : Raw);
+            Sint32 = (SINT32)((Raw < 0) ? (Raw - 0.5f) : (Raw + 0.5f));
+            memcpy(pRaw, &Sint32, sizeof(Sint32));
+            break;
+        case GIT_TEST_PID_F_SINT16:
+            Raw = (Raw > 32767.0f) ? 32767.0f : ((Raw < -32768.0f) ? -32768.0f : Raw);
+            Sint16 = (SINT16)((Raw < 0) ? (Raw - 0.5f) : (Raw + 0.5f));
+            memcpy(pRaw, &Sint16, sizeof(Sint16));
+            break;
+        case GIT_TEST_PID_F_UINT16:
+            Raw = (Raw > 65535.0f) ? 65535.0f : ((Raw < 0) ? 0 : Raw);
+            Uint16 = (UINT16)(Raw + 0.5f);
+            memcpy(pRaw, &Uint16, sizeof(Uint16));
+            break;
+        default:
+            memcpy(pRaw, &Raw, sizeof(Raw));
+            break;
+    }
+}
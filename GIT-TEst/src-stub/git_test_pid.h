@@ -0,0 +1,128 @@
+/**
+********************************************************************************
+* @file     git_test_pid.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the PID controller blocks
+*           of the control task.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_PID__H
+#define GIT_TEST_PID__H
+
+/* Defines: controller bank */
+#define GIT_TEST_PID_MAXINST    16      /* maximum number of controllers in a bank */
+#define GIT_TEST_PID_MAXDIV     1000    /* maximum cycle divider of a controller */
+
+/* Defines: source of a bound value */
+#define GIT_TEST_PID_SRC_NONE   0       /* not bound, value is set/read in the bank */
+#define GIT_TEST_PID_SRC_IN     1       /* element of IN_VARS */
+#define GIT_TEST_PID_SRC_OUT    2       /* element of OUT_VARS */
+
+/* Defines: format of a bound value */
+#define GIT_TEST_PID_F_REAL32   0
+#define GIT_TEST_PID_F_SINT32   1
+#define GIT_TEST_PID_F_SINT16   2
+#define GIT_TEST_PID_F_UINT16   3
+
+/*
+ * Binding of a controller value to an element of the process image.
+ * Value = raw value * Scale; a controller output is converted back,
+ * rounded and limited to the range of the format.
+ * Use offsetof() for Offset, e.g. offsetof(IN_VARS, TempAct).
+ */
+typedef struct GIT_TEST_PID_BIND
+{
+    UINT16  Src;                        /* GIT_TEST_PID_SRC_... */
+    UINT16  Format;                     /* GIT_TEST_PID_F_... */
+    UINT32  Offset;                     /* byte offset in IN_VARS/OUT_VARS */
+    REAL32  Scale;                      /* engineering units per raw unit, 0 = 1.0 */
+} GIT_TEST_PID_BIND;
+
+/* Settings of one controller */
+typedef struct GIT_TEST_PID_CFG
+{
+    GIT_TEST_PID_BIND Sp;               /* setpoint */
+    GIT_TEST_PID_BIND Pv;               /* process value */
+    GIT_TEST_PID_BIND Man;              /* output in manual mode */
+    GIT_TEST_PID_BIND Out;              /* controller output */
+    REAL32  Kp;                         /* proportional gain */
+    REAL32  Ti_s;                       /* integral time in s, 0 = no integral part */
+    REAL32  Td_s;                       /* derivative time in s, 0 = no derivative part */
+    REAL32  Tf_s;                       /* time constant of the derivative filter in s */
+    REAL32  OutMin;                     /* lower output limit */
+    REAL32  OutMax;                     /* upper output limit */
+    UINT32  CycleDiv;                   /* controller runs every CycleDiv-th cycle, 0 = 1 */
+} GIT_TEST_PID_CFG;
+
+/*
+ * Bank of controllers in struct-of-arrays layout, all controllers are
+ * updated in one pass per cycle. It holds no pointers.
+ * Only the states are kept on a warm restart (GIT_TEST_PID_SAVE), the
+ * settings are always taken from git_test_pid_setup().
+ */
+typedef struct GIT_TEST_PID_BANK
+{
+    UINT32  NbOfInst;                   /* number of controllers, 0 = not set up */
+
+    /* settings, see git_test_pid_setup() */
+    GIT_TEST_PID_BIND Bind[4][GIT_TEST_PID_MAXINST];  /* Sp, Pv, Man, Out */
+    REAL32  Kp[GIT_TEST_PID_MAXINST];
+    REAL32  InvTi[GIT_TEST_PID_MAXINST];  /* 1 / Ti, 0 = no integral part */
+    REAL32  Td[GIT_TEST_PID_MAXINST];
+    REAL32  Tf[GIT_TEST_PID_MAXINST];
+    REAL32  OutMin[GIT_TEST_PID_MAXINST];
+    REAL32  OutMax[GIT_TEST_PID_MAXINST];
+    UINT32  CycleDiv[GIT_TEST_PID_MAXINST];
+
+    /* inputs and output of the last pass, unbound values are set/read here */
+    REAL32  Sp[GIT_TEST_PID_MAXINST];
+    REAL32  Pv[GIT_TEST_PID_MAXINST];
+    REAL32  Man[GIT_TEST_PID_MAXINST];
+    REAL32  Out[GIT_TEST_PID_MAXINST];
+
+    /* states */
+    UINT32  Auto[GIT_TEST_PID_MAXINST];  /* TRUE .. automatic, FALSE .. manual mode */
+    UINT32  DivCnt[GIT_TEST_PID_MAXINST];  /* cycles since the last update */
+    REAL32  Elapsed[GIT_TEST_PID_MAXINST];  /* time since the last update in s */
+    REAL32  I[GIT_TEST_PID_MAXINST];    /* integral part */
+    REAL32  D[GIT_TEST_PID_MAXINST];    /* filtered derivative part */
+    REAL32  PrevPv[GIT_TEST_PID_MAXINST];  /* process value of the last update */
+    UINT32  PrevValid[GIT_TEST_PID_MAXINST];  /* FALSE .. PrevPv not yet gathered */
+} GIT_TEST_PID_BANK;
+
+/* States of all controllers of a bank, kept in the retained state, see git_test_pid_save() */
+typedef struct GIT_TEST_PID_SAVE
+{
+    UINT32  NbOfInst;                   /* number of saved controllers, 0 = none */
+    UINT32  Auto[GIT_TEST_PID_MAXINST];
+    REAL32  Out[GIT_TEST_PID_MAXINST];
+    REAL32  I[GIT_TEST_PID_MAXINST];
+    REAL32  D[GIT_TEST_PID_MAXINST];
+    REAL32  PrevPv[GIT_TEST_PID_MAXINST];
+    UINT32  PrevValid[GIT_TEST_PID_MAXINST];
+} GIT_TEST_PID_SAVE;
+
+/*--- Functions ---*/
+
+/* Control task: settings of all controllers, the states are kept if the number is unchanged */
+extern SINT32 git_test_pid_setup(GIT_TEST_PID_BANK *pBank, const GIT_TEST_PID_CFG *pCfg,
+                                 UINT32 NbOfInst);
+extern void git_test_pid_reset(GIT_TEST_PID_BANK *pBank);
+
+/* Control task: states of all controllers to/from the retained state, after git_test_pid_setup() */
+extern void git_test_pid_save(const GIT_TEST_PID_BANK *pBank, GIT_TEST_PID_SAVE *pSave);
+extern void git_test_pid_load(GIT_TEST_PID_BANK *pBank, const GIT_TEST_PID_SAVE *pSave);
+
+/* Control task: switch between manual and automatic mode, bumpless */
+extern void git_test_pid_setAuto(GIT_TEST_PID_BANK *pBank, UINT32 Inst, UINT32 Auto);
+
+/* Control task: update all controllers, Dt_s is the time since the last cycle */
+extern void git_test_pid_cycle(GIT_TEST_PID_BANK *pBank, const IN_VARS *pInVars,
+                               OUT_VARS *pOutVars, REAL32 Dt_s);
+
+#endif /* Avoid problems with multiple include */
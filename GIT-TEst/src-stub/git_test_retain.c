@@ -0,0 +1,253 @@
+/**
+********************************************************************************
+* @file     git_test_retain.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the retained process state of the module.
+*
+*           The control task works on git_test_Retain. At each cycle end a
+*           checkpoint of it is written to one of two slots in static memory,
+*           alternately, so there is always one complete checkpoint, even if
+*           the task is deleted while writing.
+*           A slot is valid if its magic, size and CRC match. Static memory
+*           is kept as long as the module is loaded, so the checkpoints
+*           survive RpcReset and the restart of the bTask after an
+*           exception.
+*           Before the control task is started again, the newest valid
+*           checkpoint is copied back to git_test_Retain (warm start).
+*           Without a valid checkpoint, after module load or if the size of
+*           GIT_TEST_RETAIN_DATA has changed, it is cleared (cold start).
+*           After power-up, the checkpoint can be loaded from non-volatile
+*           memory, see git_test_persist.c.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_control.h"
+#include "git_test_cfgimg.h"
+#include "git_test_retain.h"
+
+/* Checkpoint of the retained state */
+typedef struct RETAIN_SLOT
+{
+    volatile UINT32 Magic;              /* GIT_TEST_RETAIN_MAGIC if complete */
+    UINT32  Size;                       /* sizeof(GIT_TEST_RETAIN_DATA) */
+    UINT32  Seq;                        /* number of the checkpoint */
+    UINT32  Crc;                        /* CRC32 of Data */
+    GIT_TEST_RETAIN_DATA Data;
+} RETAIN_SLOT;
+
+/* Functions: being called only within this file */
+MLOCAL RETAIN_SLOT *Retain_Newest(void);
+
+/* Global variables: retained state, working copy of the control task */
+GIT_TEST_RETAIN_DATA git_test_Retain;
+
+/* Global variables: checkpoints */
+MLOCAL RETAIN_SLOT RetainSlot[GIT_TEST_RETAIN_NBSLOTS];
+MLOCAL UINT32 RetainSeq = 0;            /* number of the last checkpoint */
+MLOCAL UINT32 RetainWarm = FALSE;       /* last start has restored a checkpoint */
+MLOCAL UINT32 RetainNbOfWarm = 0;       /* number of warm starts */
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR RetainVarList[] = {
+    {"Retain/Warm", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &RetainWarm, 0, 0, NULL, NULL, 0, NULL},
+    {"Retain/NbOfWarm", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &RetainNbOfWarm, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Writes a checkpoint of git_test_Retain.
+*        Called by the control task at each cycle end.
+*        The older slot is overwritten, it is invalid while being written.
+*******************************************************************************/
+void git_test_retain_save(void)
+{
+    RETAIN_SLOT *pSlot = &RetainSlot[(RetainSeq + 1) % GIT_TEST_RETAIN_NBSLOTS];
+
+    pSlot->Magic = 0;
+    GIT_TEST_MEMBARRIER();
+
+    pSlot->Data = git_test_Retain;
+    pSlot->Size = sizeof(GIT_TEST_RETAIN_DATA);
+    pSlot->Seq = RetainSeq + 1;
+    pSlot->Crc = git_test_cfgimg_crc(&pSlot->Data, sizeof(pSlot->Data));
+
+    /* Slot must be complete before it is marked as valid */
+    GIT_TEST_MEMBARRIER();
+    pSlot->Magic = GIT_TEST_RETAIN_MAGIC;
+    RetainSeq++;
+}
+
+/**
+********************************************************************************
+* @brief Restores git_test_Retain from the newest valid checkpoint.
+*        Called by the bTask before the control task is started,
+*        it must not be running.
+*
+* @retval     TRUE .. warm start, the retained state has been restored
+* @retval     FALSE .. cold start, the retained state has been cleared
+*******************************************************************************/
+UINT32 git_test_retain_restore(void)
+{
+    static const CHAR *pFunc = __func__;
+    RETAIN_SLOT *pSlot = Retain_Newest();
+
+    if (!pSlot)
+    {
+        memset(&git_test_Retain, 0, sizeof(git_test_Retain));
+        memset(RetainSlot, 0, sizeof(RetainSlot));
+        RetainSeq = 0;
+        RetainWarm = FALSE;
+        LOG_I(1, pFunc, "Cold start, retained state cleared");
+        return (FALSE);
+    }
+
+    git_test_Retain = pSlot->Data;
+    RetainSeq = pSlot->Seq;
+    RetainWarm = TRUE;
+    RetainNbOfWarm++;
+    LOG_I(1, pFunc, "Warm start, retained state of cycle %u restored",
+          git_test_Retain.CycleCnt);
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Checks if there is a valid checkpoint.
+*
+* @retval     TRUE .. a warm start is possible
+* @retval     FALSE .. next start is a cold start
+*******************************************************************************/
+UINT32 git_test_retain_avail(void)
+{
+    return (Retain_Newest() ? TRUE : FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Copies the newest checkpoint.
+*        May be called while the control task is writing checkpoints,
+*        the copy is retried if the slot has been overwritten meanwhile.
+*
+* @param[out] pData       retained state
+* @param[out] pSeq        number of the checkpoint
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no valid checkpoint
+*******************************************************************************/
+SINT32 git_test_retain_read(GIT_TEST_RETAIN_DATA *pData, UINT32 *pSeq)
+{
+    RETAIN_SLOT *pSlot;
+    UINT32  Seq;
+    UINT32  Crc;
+    UINT32  Retry;
+
+    for (Retry = 0; Retry < GIT_TEST_RETAIN_RETRIES; Retry++)
+    {
+        pSlot = Retain_Newest();
+        if (!pSlot)
+        {
+            return (ERROR);
+        }
+
+        Seq = pSlot->Seq;
+        Crc = pSlot->Crc;
+        GIT_TEST_MEMBARRIER();
+        *pData = pSlot->Data;
+        GIT_TEST_MEMBARRIER();
+
+        if ((pSlot->Magic == GIT_TEST_RETAIN_MAGIC) && (pSlot->Seq == Seq) &&
+            (git_test_cfgimg_crc(pData, sizeof(*pData)) == Crc))
+        {
+            *pSeq = Seq;
+            return (OK);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Enters a checkpoint read from non-volatile memory.
+*        Called by the bTask at module init, the control task must not be
+*        running. The checkpoint is restored by git_test_retain_restore().
+*
+* @param[in]  pData       retained state
+* @param[in]  Seq         number of the checkpoint
+*******************************************************************************/
+void git_test_retain_load(const GIT_TEST_RETAIN_DATA *pData, UINT32 Seq)
+{
+    RETAIN_SLOT *pSlot = &RetainSlot[Seq % GIT_TEST_RETAIN_NBSLOTS];
+
+    memset(RetainSlot, 0, sizeof(RetainSlot));
+    pSlot->Data = *pData;
+    pSlot->Size = sizeof(GIT_TEST_RETAIN_DATA);
+    pSlot->Seq = Seq;
+    pSlot->Crc = git_test_cfgimg_crc(&pSlot->Data, sizeof(pSlot->Data));
+    pSlot->Magic = GIT_TEST_RETAIN_MAGIC;
+    RetainSeq = Seq;
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_retain_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(RetainVarList,
+                                       sizeof(RetainVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Searches the newest valid checkpoint.
+*
+* @retval     slot, NULL if there is no valid checkpoint
+*******************************************************************************/
+MLOCAL RETAIN_SLOT *Retain_Newest(void)
+{
+    RETAIN_SLOT *pNewest = NULL;
+    RETAIN_SLOT *pSlot;
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_RETAIN_NBSLOTS; idx++)
+    {
+        pSlot = &RetainSlot[idx];
+        if ((pSlot->Magic != GIT_TEST_RETAIN_MAGIC) ||
+            (pSlot->Size != sizeof(GIT_TEST_RETAIN_DATA)) ||
+            (git_test_cfgimg_crc(&pSlot->Data, sizeof(pSlot->Data)) != pSlot->Crc))
+        {
+            continue;
+        }
+
+        /* Sequence numbers may wrap around */
+        if (!pNewest || ((SINT32)(pSlot->Seq - pNewest->Seq) > 0))
+        {
+            pNewest = pSlot;
+        }
+    }
+
+    return (pNewest);
+}
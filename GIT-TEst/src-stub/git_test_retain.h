@@ -0,0 +1,45 @@
+/**
+********************************************************************************
+* @file     git_test_retain.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the retained process state
+*           of the module.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_RETAIN__H
+#define GIT_TEST_RETAIN__H
+
+/* Defines: checkpoints */
+#define GIT_TEST_RETAIN_NBSLOTS 2       /* checkpoints, written alternately */
+#define GIT_TEST_RETAIN_MAGIC   0x52544E31  /* marks a complete checkpoint */
+#define GIT_TEST_RETAIN_RETRIES 3       /* reads of a checkpoint being overwritten */
+
+/* Retained state, defined by the user in git_test_control.h */
+struct GIT_TEST_RETAIN_DATA;
+
+/*--- Functions ---*/
+
+/* Control task: checkpoint git_test_Retain, called at cycle end */
+extern void git_test_retain_save(void);
+
+/* bTask: restore git_test_Retain before the control task is started, TRUE on a warm start */
+extern UINT32 git_test_retain_restore(void);
+
+/* bTask: TRUE if there is a valid checkpoint */
+extern UINT32 git_test_retain_avail(void);
+
+/* Any task: copy of the newest checkpoint, while the control task is running */
+extern SINT32 git_test_retain_read(struct GIT_TEST_RETAIN_DATA *pData, UINT32 *pSeq);
+
+/* bTask: checkpoint from non-volatile memory, before the control task is started */
+extern void git_test_retain_load(const struct GIT_TEST_RETAIN_DATA *pData, UINT32 Seq);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_retain_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,509 @@
+/**
+********************************************************************************
+* @file     git_test_sm.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the state machines of the control task, e.g.
+*           for sequence control.
+*
+*           The instances of git_test_SmList[] (git_test_control.c) refer
+*           to machine definitions with states and transitions by name.
+*           At BaseInit all machines are compiled into one transition table:
+*           the states of all machines are numbered globally and the
+*           transitions of each state are stored contiguously (transitions
+*           from any state first), as arrays of mask, value, timeout and
+*           target. Guards are input bits and the time in state, so a step
+*           needs no calls.
+*           git_test_sm_step() steps all instances in one pass. Each
+*           instance checks the transitions of its state in order and takes
+*           at most one per step, so the time of a step is bounded by the
+*           number of transitions per state; the bound is logged at init.
+*           Per instance, SVI variables "Sm/<name>/State" (index of the
+*           state in the machine), "Sm/<name>/TimeInState_ms" and
+*           "Sm/<name>/Transitions" are exported.
+*           The states and times in state are part of the retained state
+*           (git_test_sm_save()/git_test_sm_load()), so the sequences
+*           continue after a warm restart and after power-up.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_sm.h"
+
+/* Defines: SVI variables */
+#define SM_NBOFVARS     3               /* SVI variables per instance */
+#define SM_MAXMACH      GIT_TEST_SM_MAXINST /* different machines */
+
+/* State of an instance, kept together for git_test_sm_stateSave() */
+typedef struct SM_INST
+{
+    UINT32  State;                      /* global state index */
+    UINT32  Base;                       /* global index of the first state of the machine */
+    UINT32  Inputs;                     /* input bits of this cycle */
+    UINT32  Outputs;                    /* output bits of the state */
+    UINT32  Rem_us;                     /* time in state below 1 ms */
+} SM_INST;
+
+/* Functions: being called only within this file */
+MLOCAL SINT32 Sm_Compile(const GIT_TEST_SM_MACHINE *pMach, UINT32 *pBase);
+MLOCAL SINT32 Sm_StateIdx(const GIT_TEST_SM_MACHINE *pMach, const CHAR *pName);
+MLOCAL void Sm_Enter(UINT32 Inst, UINT32 State);
+
+/* Global variables: compiled transition table */
+MLOCAL UINT16 SmFirst[GIT_TEST_SM_MAXSTATES + 1];  /* first transition of each state */
+MLOCAL UINT32 SmStateOut[GIT_TEST_SM_MAXSTATES];   /* output bits of each state */
+MLOCAL UINT32 SmMask[GIT_TEST_SM_MAXTRANS];
+MLOCAL UINT32 SmValue[GIT_TEST_SM_MAXTRANS];
+MLOCAL UINT32 SmTimeout[GIT_TEST_SM_MAXTRANS];
+MLOCAL UINT16 SmTo[GIT_TEST_SM_MAXTRANS];
+MLOCAL UINT32 SmNbOfStates = 0;
+MLOCAL UINT32 SmNbOfTrans = 0;
+
+/* Global variables: instances */
+MLOCAL const GIT_TEST_SM_INST *pSmList = NULL;
+MLOCAL SM_INST SmInst[GIT_TEST_SM_MAXINST];
+MLOCAL SM_INST SmInstSave[GIT_TEST_SM_MAXINST];
+MLOCAL UINT32 SmNbOfInst = 0;
+
+/* Global variables: per instance, exported via SVI */
+MLOCAL UINT32 SmState[GIT_TEST_SM_MAXINST];        /* state index within the machine */
+MLOCAL UINT32 SmTime_ms[GIT_TEST_SM_MAXINST];
+MLOCAL UINT32 SmNbOfSteps[GIT_TEST_SM_MAXINST];   /* transitions taken */
+MLOCAL UINT32 SmStateSave[GIT_TEST_SM_MAXINST];
+MLOCAL UINT32 SmTimeSave[GIT_TEST_SM_MAXINST];
+MLOCAL UINT32 SmStepsSave[GIT_TEST_SM_MAXINST];
+MLOCAL CHAR SmVarName[GIT_TEST_SM_MAXINST * SM_NBOFVARS][SVI_ADDRLEN];
+MLOCAL SVI_GLOBVAR SmVarList[GIT_TEST_SM_MAXINST * SM_NBOFVARS];
+
+/**
+********************************************************************************
+* @brief Compiles the machines of all instances into the transition table
+*        and registers the SVI variables.
+*        Called by the bTask at BaseInit, the control task is not running.
+*
+* @param[in]  pList       instances, terminated by an entry with pMachine = NULL
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_sm_sviServerInit(const GIT_TEST_SM_INST *pList)
+{
+    static const CHAR *pFunc = __func__;
+    static const CHAR *pSuffix[SM_NBOFVARS] = {"State", "TimeInState_ms", "Transitions"};
+    static UINT32 *const pVars[SM_NBOFVARS] = {SmState, SmTime_ms, SmNbOfSteps};
+    const GIT_TEST_SM_MACHINE *pMach[SM_MAXMACH];
+    UINT32  MachBase[SM_MAXMACH];
+    UINT32  NbOfMach = 0;
+    UINT32  MaxChecks = 0;
+    UINT32  Checks;
+    SVI_GLOBVAR *pVar;
+    UINT32  idx;
+    UINT32  m;
+    UINT32  s;
+    UINT32  var;
+
+    memset(SmInst, 0, sizeof(SmInst));
+    memset(SmVarList, 0, sizeof(SmVarList));
+    SmNbOfStates = 0;
+    SmNbOfTrans = 0;
+    SmNbOfInst = 0;
+    SmFirst[0] = 0;
+    pSmList = pList;
+
+    for (idx = 0; pList[idx].pMachine; idx++)
+    {
+        if (idx >= GIT_TEST_SM_MAXINST)
+        {
+            LOG_E(0, pFunc, "Too many instances, maximum is %d", GIT_TEST_SM_MAXINST);
+            return (ERROR);
+        }
+
+        /* Each machine is compiled once, its instances share the table */
+        for (m = 0; (m < NbOfMach) && (pMach[m] != pList[idx].pMachine); m++)
+        {
+        }
+        if (m == NbOfMach)
+        {
+            if (Sm_Compile(pList[idx].pMachine, &MachBase[m]) < 0)
+            {
+                return (ERROR);
+            }
+            pMach[m] = pList[idx].pMachine;
+            NbOfMach++;
+
+            /* Most transitions to be checked by one instance of this machine */
+            Checks = 0;
+            for (s = MachBase[m]; s < SmNbOfStates; s++)
+            {
+                Checks = ((UINT32)(SmFirst[s + 1] - SmFirst[s]) > Checks) ?
+                         (UINT32)(SmFirst[s + 1] - SmFirst[s]) : Checks;
+            }
+        }
+        else
+        {
+            Checks = 0;
+            for (s = MachBase[m]; s < (MachBase[m] + pMach[m]->NbOfStates); s++)
+            {
+                Checks = ((UINT32)(SmFirst[s + 1] - SmFirst[s]) > Checks) ?
+                         (UINT32)(SmFirst[s + 1] - SmFirst[s]) : Checks;
+            }
+        }
+        MaxChecks += Checks;
+
+        SmInst[idx].Base = MachBase[m];
+        Sm_Enter(idx, MachBase[m]);
+        SmNbOfSteps[idx] = 0;
+
+        for (var = 0; var < SM_NBOFVARS; var++)
+        {
+            pVar = &SmVarList[(idx * SM_NBOFVARS) + var];
+            snprintf(SmVarName[(idx * SM_NBOFVARS) + var], SVI_ADDRLEN, "Sm/%s/%s",
+                     pList[idx].pName, pSuffix[var]);
+            pVar->VarName = SmVarName[(idx * SM_NBOFVARS) + var];
+            pVar->Format = SVI_F_OUT | SVI_F_UINT32;
+            pVar->Size = sizeof(UINT32);
+            pVar->pVar = &pVars[var][idx];
+        }
+    }
+    SmNbOfInst = idx;
+
+    if (!SmNbOfInst)
+    {
+        return (OK);
+    }
+
+    LOG_I(1, pFunc, "%d instances, %d states, %d transitions, max. %d checks per step",
+          SmNbOfInst, SmNbOfStates, SmNbOfTrans, MaxChecks);
+
+    return (git_test_AppSviAddGlobVars(SmVarList, SmNbOfInst * SM_NBOFVARS));
+}
+
+/**
+********************************************************************************
+* @brief Steps all instances.
+*        Called by the control task once per cycle, after the input bits
+*        have been set.
+*
+* @param[in]  Dt_s        time since the last step
+*******************************************************************************/
+void git_test_sm_step(REAL32 Dt_s)
+{
+    UINT32  Dt_us = (UINT32)((Dt_s * 1000000) + 0.5);
+    SM_INST *pInst = SmInst;
+    UINT32  idx;
+    UINT32  Trans;
+    UINT32  Last;
+
+    for (idx = 0; idx < SmNbOfInst; idx++, pInst++)
+    {
+        /* Time in state, in ms with the remainder kept */
+        pInst->Rem_us += Dt_us;
+        if (pInst->Rem_us >= 1000)
+        {
+            SmTime_ms[idx] += pInst->Rem_us / 1000;
+            pInst->Rem_us %= 1000;
+        }
+
+        Last = SmFirst[pInst->State + 1];
+        for (Trans = SmFirst[pInst->State]; Trans < Last; Trans++)
+        {
+            if (((pInst->Inputs & SmMask[Trans]) == SmValue[Trans]) &&
+                (SmTime_ms[idx] >= SmTimeout[Trans]))
+            {
+                Sm_Enter(idx, SmTo[Trans]);
+                SmNbOfSteps[idx]++;
+                break;
+            }
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Searches an instance by its name.
+*
+* @param[in]  pName       instance name, case sensitive
+*
+* @retval     >= 0 .. index of the instance
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+SINT32 git_test_sm_findInst(const CHAR *pName)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < SmNbOfInst; idx++)
+    {
+        if (!strcmp(pSmList[idx].pName, pName))
+        {
+            return ((SINT32)idx);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Sets the input bits of an instance for the next step.
+*
+* @param[in]  Inst        index of the instance
+* @param[in]  Inputs      input bits
+*******************************************************************************/
+void git_test_sm_setInputs(UINT32 Inst, UINT32 Inputs)
+{
+    if (Inst < SmNbOfInst)
+    {
+        SmInst[Inst].Inputs = Inputs;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the output bits of the state of an instance.
+*
+* @param[in]  Inst        index of the instance
+*
+* @retval     output bits, 0 for an unknown instance
+*******************************************************************************/
+UINT32 git_test_sm_outputs(UINT32 Inst)
+{
+    return ((Inst < SmNbOfInst) ? SmInst[Inst].Outputs : 0);
+}
+
+/**
+********************************************************************************
+* @brief Returns the state of an instance.
+*
+* @param[in]  Inst        index of the instance
+*
+* @retval     index of the state in the states of the machine
+*******************************************************************************/
+UINT32 git_test_sm_state(UINT32 Inst)
+{
+    return ((Inst < SmNbOfInst) ? SmState[Inst] : 0);
+}
+
+/**
+********************************************************************************
+* @brief Sets an instance to the initial state of its machine.
+*
+* @param[in]  Inst        index of the instance
+*******************************************************************************/
+void git_test_sm_reset(UINT32 Inst)
+{
+    if (Inst < SmNbOfInst)
+    {
+        Sm_Enter(Inst, SmInst[Inst].Base);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes the states of all instances into the retained state.
+*        Called by the control task at cycle end.
+*
+* @param[out] pSave       retained states
+*******************************************************************************/
+void git_test_sm_save(GIT_TEST_SM_SAVE *pSave)
+{
+    pSave->NbOfInst = SmNbOfInst;
+    memcpy(pSave->State, SmState, SmNbOfInst * sizeof(UINT32));
+    memcpy(pSave->Time_ms, SmTime_ms, SmNbOfInst * sizeof(UINT32));
+}
+
+/**
+********************************************************************************
+* @brief Continues all instances in their retained states.
+*        Called by the control task before the first cycle. Retained states
+*        of a different list of instances (cold start, changed
+*        git_test_SmList[]) are not used, all instances start in their
+*        initial state then.
+*
+* @param[in]  pSave       retained states
+*******************************************************************************/
+void git_test_sm_load(const GIT_TEST_SM_SAVE *pSave)
+{
+    UINT32  Valid = (pSave->NbOfInst == SmNbOfInst);
+    UINT32  idx;
+
+    for (idx = 0; Valid && (idx < SmNbOfInst); idx++)
+    {
+        Valid = (pSave->State[idx] < pSmList[idx].pMachine->NbOfStates);
+    }
+
+    for (idx = 0; idx < SmNbOfInst; idx++)
+    {
+        Sm_Enter(idx, SmInst[idx].Base + (Valid ? pSave->State[idx] : 0));
+        SmTime_ms[idx] = Valid ? pSave->Time_ms[idx] : 0;
+    }
+
+    if (SmNbOfInst && !Valid)
+    {
+        LOG_I(1, __func__, "No retained states, all instances in their initial state");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Keeps a copy of the states of all instances.
+*******************************************************************************/
+void git_test_sm_stateSave(void)
+{
+    memcpy(SmInstSave, SmInst, SmNbOfInst * sizeof(SM_INST));
+    memcpy(SmStateSave, SmState, SmNbOfInst * sizeof(UINT32));
+    memcpy(SmTimeSave, SmTime_ms, SmNbOfInst * sizeof(UINT32));
+    memcpy(SmStepsSave, SmNbOfSteps, SmNbOfInst * sizeof(UINT32));
+}
+
+/**
+********************************************************************************
+* @brief Restores the copy of git_test_sm_stateSave().
+*******************************************************************************/
+void git_test_sm_stateRestore(void)
+{
+    memcpy(SmInst, SmInstSave, SmNbOfInst * sizeof(SM_INST));
+    memcpy(SmState, SmStateSave, SmNbOfInst * sizeof(UINT32));
+    memcpy(SmTime_ms, SmTimeSave, SmNbOfInst * sizeof(UINT32));
+    memcpy(SmNbOfSteps, SmStepsSave, SmNbOfInst * sizeof(UINT32));
+}
+
+/**
+********************************************************************************
+* @brief Appends the states and transitions of a machine to the table.
+*
+* @param[in]  pMach       machine
+* @param[out] pBase       global index of its first state
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Sm_Compile(const GIT_TEST_SM_MACHINE *pMach, UINT32 *pBase)
+{
+    static const CHAR *pFunc = __func__;
+    const GIT_TEST_SM_TRANS *pTrans;
+    UINT32  Pass;
+    UINT32  State;
+    UINT32  idx;
+    SINT32  From;
+    SINT32  To;
+
+    if (!pMach->NbOfStates || ((SmNbOfStates + pMach->NbOfStates) > GIT_TEST_SM_MAXSTATES))
+    {
+        LOG_E(0, pFunc, "Machine '%s': no states or more than %d states in total",
+              pMach->pName, GIT_TEST_SM_MAXSTATES);
+        return (ERROR);
+    }
+
+    /* Names must be resolvable before anything is added */
+    for (idx = 0; idx < pMach->NbOfTrans; idx++)
+    {
+        pTrans = &pMach->pTrans[idx];
+        if (((strcmp(pTrans->pFrom, GIT_TEST_SM_ANY) != 0) &&
+             (Sm_StateIdx(pMach, pTrans->pFrom) < 0)) ||
+            (Sm_StateIdx(pMach, pTrans->pTo) < 0) || (pTrans->Value & ~pTrans->Mask))
+        {
+            LOG_E(0, pFunc, "Machine '%s': bad transition %d, '%s' -> '%s'",
+                  pMach->pName, idx, pTrans->pFrom, pTrans->pTo);
+            return (ERROR);
+        }
+    }
+
+    *pBase = SmNbOfStates;
+    for (State = 0; State < pMach->NbOfStates; State++)
+    {
+        SmStateOut[SmNbOfStates] = pMach->pStates[State].Outputs;
+
+        /* Pass 0: transitions from any state, pass 1: from this state */
+        for (Pass = 0; Pass < 2; Pass++)
+        {
+            for (idx = 0; idx < pMach->NbOfTrans; idx++)
+            {
+                pTrans = &pMach->pTrans[idx];
+                From = strcmp(pTrans->pFrom, GIT_TEST_SM_ANY) ? Sm_StateIdx(pMach, pTrans->pFrom) : -1;
+                To = Sm_StateIdx(pMach, pTrans->pTo);
+
+                /* From any state, but not from its target: no step, the time keeps counting */
+                if ((Pass == 0) ? ((From >= 0) || (To == (SINT32)State)) : (From != (SINT32)State))
+                {
+                    continue;
+                }
+
+                if (SmNbOfTrans >= GIT_TEST_SM_MAXTRANS)
+                {
+                    LOG_E(0, pFunc, "Machine '%s': more than %d transitions in total",
+                          pMach->pName, GIT_TEST_SM_MAXTRANS);
+                    return (ERROR);
+                }
+
+                SmMask[SmNbOfTrans] = pTrans->Mask;
+                SmValue[SmNbOfTrans] = pTrans->Value;
+                SmTimeout[SmNbOfTrans] = pTrans->Timeout_ms;
+                SmTo[SmNbOfTrans] = (UINT16)(*pBase + To);
+                SmNbOfTrans++;
+            }
+        }
+
+        SmNbOfStates++;
+        SmFirst[SmNbOfStates] = (UINT16)SmNbOfTrans;
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns the index of a state within its machine.
+*
+* @param[in]  pMach       machine
+* @param[in]  pName       state name
+*
+* @retval     >= 0 .. index of the state
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+MLOCAL SINT32 Sm_StateIdx(const GIT_TEST_SM_MACHINE *pMach, const CHAR *pName)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < pMach->NbOfStates; idx++)
+    {
+        if (!strcmp(pMach->pStates[idx].pName, pName))
+        {
+            return ((SINT32)idx);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Enters a state, the time in state starts again.
+*
+* @param[in]  Inst        index of the instance
+* @param[in]  State       global state index
+*******************************************************************************/
+MLOCAL void Sm_Enter(UINT32 Inst, UINT32 State)
+{
+    SM_INST *pInst = &SmInst[Inst];
+
+    pInst->State = State;
+    pInst->Outputs = SmStateOut[State];
+    pInst->Rem_us = 0;
+    SmState[Inst] = State - pInst->Base;
+    SmTime_ms[Inst] = 0;
+}
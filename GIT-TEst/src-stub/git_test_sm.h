@@ -0,0 +1,94 @@
+/**
+********************************************************************************
+* @file     git_test_sm.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the state machines of
+*           the control task.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_SM__H
+#define GIT_TEST_SM__H
+
+/* Defines: dimensions */
+#define GIT_TEST_SM_MAXINST     64      /* maximum number of instances */
+#define GIT_TEST_SM_MAXSTATES   256     /* maximum number of states of all machines */
+#define GIT_TEST_SM_MAXTRANS    1024    /* maximum number of transitions of all machines */
+#define GIT_TEST_SM_ANY         "*"     /* transition from any state */
+
+/* State of a machine */
+typedef struct GIT_TEST_SM_STATE
+{
+    const CHAR *pName;                  /* unique within the machine */
+    UINT32  Outputs;                    /* output bits while in this state */
+} GIT_TEST_SM_STATE;
+
+/*
+ * Transition of a machine. It fires if
+ *   (input bits & Mask) == Value  and  time in state >= Timeout_ms.
+ * The transitions of a state are checked in the order of the list,
+ * transitions from GIT_TEST_SM_ANY first. At most one fires per cycle.
+ * A transition from GIT_TEST_SM_ANY is not checked in its target state.
+ */
+typedef struct GIT_TEST_SM_TRANS
+{
+    const CHAR *pFrom;                  /* state name or GIT_TEST_SM_ANY */
+    const CHAR *pTo;                    /* state name */
+    UINT32  Mask;                       /* input bits to be checked */
+    UINT32  Value;                      /* required value of these bits */
+    UINT32  Timeout_ms;                 /* minimum time in state, 0 = none */
+} GIT_TEST_SM_TRANS;
+
+/* Machine, the first state is the initial state */
+typedef struct GIT_TEST_SM_MACHINE
+{
+    const CHAR *pName;                  /* name, for messages */
+    const GIT_TEST_SM_STATE *pStates;
+    UINT32  NbOfStates;
+    const GIT_TEST_SM_TRANS *pTrans;
+    UINT32  NbOfTrans;
+} GIT_TEST_SM_MACHINE;
+
+/* Instance of a machine */
+typedef struct GIT_TEST_SM_INST
+{
+    const CHAR *pName;                  /* unique name, SVI "Sm/<name>/..." */
+    const GIT_TEST_SM_MACHINE *pMachine;  /* NULL terminates the list */
+} GIT_TEST_SM_INST;
+
+/* States of all instances, kept in the retained state, see git_test_sm_save() */
+typedef struct GIT_TEST_SM_SAVE
+{
+    UINT32  NbOfInst;                   /* number of saved instances, 0 = none */
+    UINT32  State[GIT_TEST_SM_MAXINST]; /* state index within the machine */
+    UINT32  Time_ms[GIT_TEST_SM_MAXINST];  /* time in state */
+} GIT_TEST_SM_SAVE;
+
+/*--- Functions ---*/
+
+/* bTask: compile the transition tables and register the SVI variables */
+extern SINT32 git_test_sm_sviServerInit(const GIT_TEST_SM_INST *pList);
+
+/* Control task: step all instances, Dt_s is the time since the last step */
+extern void git_test_sm_step(REAL32 Dt_s);
+
+/* Control task: access to one instance, index by git_test_sm_findInst() */
+extern SINT32 git_test_sm_findInst(const CHAR *pName);
+extern void git_test_sm_setInputs(UINT32 Inst, UINT32 Inputs);
+extern UINT32 git_test_sm_outputs(UINT32 Inst);
+extern UINT32 git_test_sm_state(UINT32 Inst);
+extern void git_test_sm_reset(UINT32 Inst);
+
+/* Control task: states of all instances to and from the retained state */
+extern void git_test_sm_save(GIT_TEST_SM_SAVE *pSave);
+extern void git_test_sm_load(const GIT_TEST_SM_SAVE *pSave);
+
+/* Control task: keep and restore the states of all instances, e.g. around dry-run cycles */
+extern void git_test_sm_stateSave(void);
+extern void git_test_sm_stateRestore(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,169 @@
+/**
+********************************************************************************
+* @file     git_test_smirpl.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the pool of SMI reply buffers.
+*
+*           Reply buffers are taken from pools of fixed size classes, which
+*           are carved from the arena at BaseInit. Such a reply is sent with
+*           smi_SendCReply(), which copies the data, so the buffer is
+*           returned to its pool right after sending.
+*           Only if there is no free buffer of a suitable class, the reply
+*           is allocated with smi_MemAlloc() and handed over to the SMI with
+*           smi_SendReply() as before. These fallbacks are counted.
+*           All functions are only called by the bTask.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <smi_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_arena.h"
+#include "git_test_smirpl.h"
+
+/* Size and number of buffers of each class, small replies are the common case */
+MLOCAL const UINT32 SmiRplSize[GIT_TEST_SMIRPL_NBCLASSES] = {128, 512, SMI_DATALEN};
+MLOCAL const UINT32 SmiRplNbOf[GIT_TEST_SMIRPL_NBCLASSES] = {4, 2, 1};
+
+/* Global variables: pools */
+MLOCAL GIT_TEST_ARENA_POOL SmiRplPool[GIT_TEST_SMIRPL_NBCLASSES];
+MLOCAL UINT32 SmiRplPooled = 0;         /* replies sent from a pool */
+MLOCAL UINT32 SmiRplFallback = 0;       /* replies allocated with smi_MemAlloc() */
+
+/* Global variables: List of all state variables */
+MLOCAL SVI_GLOBVAR SmiRplVarList[] = {
+    {"SmiRpl/Pooled", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &SmiRplPooled, 0, 0, NULL, NULL, 0, NULL},
+    {"SmiRpl/Fallback", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &SmiRplFallback, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Carves the pools of all size classes from the arena.
+*        Being called at BaseInit, after the arena has been allocated.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_smirpl_init(void)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_SMIRPL_NBCLASSES; idx++)
+    {
+        if (git_test_arena_poolCreate(&SmiRplPool[idx], "SMI replies",
+                                      SmiRplSize[idx], SmiRplNbOf[idx]) < 0)
+        {
+            return (ERROR);
+        }
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns a reply buffer.
+*        The buffer is taken from the smallest class which fits and has a
+*        free buffer, otherwise it is allocated with smi_MemAlloc().
+*
+* @param[in]  Size        size of the reply in bytes
+*
+* @retval     reply buffer, NULL if out of memory
+*******************************************************************************/
+void *git_test_smirpl_get(UINT32 Size)
+{
+    void   *pReply;
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_SMIRPL_NBCLASSES; idx++)
+    {
+        if (Size <= SmiRplPool[idx].BlkSize)
+        {
+            pReply = git_test_arena_poolGet(&SmiRplPool[idx]);
+            if (pReply)
+            {
+                return (pReply);
+            }
+        }
+    }
+
+    SmiRplFallback++;
+    return (smi_MemAlloc(Size));
+}
+
+/**
+********************************************************************************
+* @brief Sends a reply and releases the reply buffer.
+*
+* @param[in]  pMsg        SMI message to reply
+* @param[in]  RetCode     return code of the reply
+* @param[in]  pReply      reply buffer from git_test_smirpl_get()
+* @param[in]  ReplyLen    length of the reply in bytes
+*
+* @retval     result of smi_SendCReply() / smi_SendReply()
+*******************************************************************************/
+SINT32 git_test_smirpl_send(SMI_MSG *pMsg, UINT32 RetCode, void *pReply, UINT32 ReplyLen)
+{
+    SINT32  ret;
+    UINT32  idx;
+
+    for (idx = 0; idx < GIT_TEST_SMIRPL_NBCLASSES; idx++)
+    {
+        if (git_test_arena_poolOwns(&SmiRplPool[idx], pReply))
+        {
+            ret = smi_SendCReply(git_test_pSmiId, pMsg, RetCode, pReply, ReplyLen);
+            git_test_arena_poolPut(&SmiRplPool[idx], pReply);
+            SmiRplPooled++;
+            return (ret);
+        }
+    }
+
+    /* Allocated with smi_MemAlloc(), freed by the SMI */
+    return (smi_SendReply(git_test_pSmiId, pMsg, RetCode, pReply, ReplyLen));
+}
+
+/**
+********************************************************************************
+* @brief Replies SMI_E_ARGS, if no reply buffer could be allocated.
+*
+* @param[in]  pMsg        SMI message to reply
+* @param[in]  pFunc       name of the calling function for messages
+*******************************************************************************/
+void git_test_smirpl_sendNoMem(SMI_MSG *pMsg, const CHAR *pFunc)
+{
+    LOG_E(0, pFunc, "No memory for SMI reply!");
+    if (smi_SendReply(git_test_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+    {
+        LOG_E(0, pFunc, "SendReply failed!");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Registers the state variables at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_smirpl_sviServerInit(void)
+{
+    return (git_test_AppSviAddGlobVars(SmiRplVarList,
+                                       sizeof(SmiRplVarList) / sizeof(SVI_GLOBVAR)));
+}
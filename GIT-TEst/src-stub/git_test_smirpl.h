@@ -0,0 +1,37 @@
+/**
+********************************************************************************
+* @file     git_test_smirpl.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the pool of SMI reply
+*           buffers.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_SMIRPL__H
+#define GIT_TEST_SMIRPL__H
+
+/* Defines: size classes of reply buffers */
+#define GIT_TEST_SMIRPL_NBCLASSES   3
+
+/*--- Functions ---*/
+
+/* bTask: carve the pools from the arena at BaseInit */
+extern SINT32 git_test_smirpl_init(void);
+
+/* bTask: reply buffer of at least Size bytes, NULL if out of memory */
+extern void *git_test_smirpl_get(UINT32 Size);
+
+/* bTask: send a reply from git_test_smirpl_get(), the buffer is released */
+extern SINT32 git_test_smirpl_send(SMI_MSG *pMsg, UINT32 RetCode, void *pReply, UINT32 ReplyLen);
+
+/* bTask: reply SMI_E_ARGS, if there is no reply buffer */
+extern void git_test_smirpl_sendNoMem(SMI_MSG *pMsg, const CHAR *pFunc);
+
+/* bTask: register the state variables at the SVI server */
+extern SINT32 git_test_smirpl_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,192 @@
+/**
+********************************************************************************
+* @file     git_test_snap.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the cycle consistent snapshot of the
+*           SVI variables exported by the application.
+*
+*           The control task and the bTask exchange the exported values
+*           through a sequence lock (seqlock):
+*           - the control task works on git_test_SnapWork during the cycle
+*             and copies it to the published buffer at cycle end.
+*             It never waits for the bTask.
+*           - the bTask copies the published buffer to the SVI buffer
+*             before an SVI read call is passed to the SVI message handler.
+*             If the control task has published in the meantime, the copy
+*             is repeated. After SNAP_MAX_RETRIES the read is failed, the
+*             bTask does not wait for a control task which does not finish
+*             its publish.
+*           If the control task is deleted while publishing, the bTask
+*           completes the publish before the task is restarted, see
+*           git_test_snap_reset().
+*           All snapshot variables are registered on the SVI buffer, which
+*           is only written by the bTask. Therefore a list or block read
+*           always returns the values of one single cycle and the variables
+*           don't need pSviStart/pSviEnd lock functions.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_snap.h"
+
+/* Number of immediate retries before the bTask gives up its time slice */
+#define SNAP_SPIN_RETRIES   4
+
+/* Number of retries before an SVI read is failed */
+#define SNAP_MAX_RETRIES    20
+
+/* Published buffer, protected by the sequence counter */
+typedef struct SNAP_BUF
+{
+    volatile UINT32 Seq;                /* odd while the control task is writing */
+    GIT_TEST_SNAP   Data;               /* last completed cycle */
+} SNAP_BUF;
+
+/* Global variables: snapshot buffers */
+GIT_TEST_SNAP git_test_SnapWork;        /* working copy of the control task */
+UINT32  git_test_SnapRetries = 0;       /* statistics: repeated snapshot reads */
+MLOCAL SNAP_BUF SnapPub;                /* published by the control task */
+MLOCAL GIT_TEST_SNAP SnapSvi;           /* read by SVI clients, written by bTask */
+
+/*
+ * Global variables: List of all snapshot variables
+ * All variables point into SnapSvi, no lock functions are necessary.
+ */
+MLOCAL SVI_GLOBVAR SnapVarList[] = {
+    {"Snap/CycleCnt", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &SnapSvi.CycleCnt, 0, 0, NULL, NULL, 0, NULL},
+    {"Snap/InVars", SVI_F_OUT | SVI_F_BLK | SVI_F_UINT8, sizeof(IN_VARS),
+     &SnapSvi.InVars, 0, 0, NULL, NULL, 0, NULL},
+    {"Snap/OutVars", SVI_F_OUT | SVI_F_BLK | SVI_F_UINT8, sizeof(OUT_VARS),
+     &SnapSvi.OutVars, 0, 0, NULL, NULL, 0, NULL},
+    {"Snap/Retries", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_SnapRetries, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Publishes the working copy as the new consistent cycle.
+*        Called by the control task at cycle end, does never block.
+*******************************************************************************/
+void git_test_snap_publish(void)
+{
+    /* odd sequence: readers will discard what they copy now */
+    SnapPub.Seq++;
+    GIT_TEST_MEMBARRIER();
+
+    memcpy(&SnapPub.Data, &git_test_SnapWork, sizeof(SnapPub.Data));
+
+    /* even sequence: cycle is complete */
+    GIT_TEST_MEMBARRIER();
+    SnapPub.Seq++;
+}
+
+/**
+********************************************************************************
+* @brief Copies the last published cycle to the SVI buffer.
+*        Called by the bTask before an SVI read call is handled.
+*        The copy is repeated until it has not been overlapped by a publish.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no consistent copy within SNAP_MAX_RETRIES
+*******************************************************************************/
+SINT32 git_test_snap_refresh(void)
+{
+    UINT32  SeqStart;
+    UINT32  Retries;
+
+    for (Retries = 0; Retries < SNAP_MAX_RETRIES; Retries++)
+    {
+        SeqStart = SnapPub.Seq;
+        GIT_TEST_MEMBARRIER();
+
+        /* Only copy if the control task is not publishing right now */
+        if (!(SeqStart & 1))
+        {
+            memcpy(&SnapSvi, &SnapPub.Data, sizeof(SnapSvi));
+            GIT_TEST_MEMBARRIER();
+
+            if (SnapPub.Seq == SeqStart)
+            {
+                return (OK);
+            }
+        }
+
+        git_test_SnapRetries++;
+
+        /* Let the control task finish its copy */
+        if (Retries >= SNAP_SPIN_RETRIES)
+        {
+            (void)taskDelay(0);
+        }
+    }
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Completes a publish which has been interrupted.
+*        Called by the bTask before the control task is restarted, the task
+*        must not be running. If the task has been deleted within
+*        git_test_snap_publish(), the sequence is odd and git_test_SnapWork
+*        still holds the completed cycle, so the copy is done again.
+*******************************************************************************/
+void git_test_snap_reset(void)
+{
+    if (!(SnapPub.Seq & 1))
+    {
+        return;
+    }
+
+    memcpy(&SnapPub.Data, &git_test_SnapWork, sizeof(SnapPub.Data));
+    GIT_TEST_MEMBARRIER();
+    SnapPub.Seq++;
+}
+
+/**
+********************************************************************************
+* @brief Returns the snapshot as seen by SVI clients.
+*        Used by virtual SVI variables to read back values of the snapshot.
+*
+* @retval     pointer to the SVI buffer
+*******************************************************************************/
+const GIT_TEST_SNAP *git_test_snap_sviData(void)
+{
+    return (&SnapSvi);
+}
+
+/**
+********************************************************************************
+* @brief Registers all snapshot variables at the SVI server of the module.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_snap_sviServerInit(void)
+{
+    /* Start with a consistent, empty snapshot */
+    memset(&git_test_SnapWork, 0, sizeof(git_test_SnapWork));
+    memset(&SnapPub, 0, sizeof(SnapPub));
+    memset(&SnapSvi, 0, sizeof(SnapSvi));
+    git_test_SnapRetries = 0;
+
+    return (git_test_AppSviAddGlobVars(SnapVarList,
+                                       sizeof(SnapVarList) / sizeof(SVI_GLOBVAR)));
+}
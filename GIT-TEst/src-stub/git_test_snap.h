@@ -0,0 +1,69 @@
+/**
+********************************************************************************
+* @file     git_test_snap.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the cycle consistent
+*           snapshot of the SVI variables exported by the application.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_SNAP__H
+#define GIT_TEST_SNAP__H
+
+#include "../src-gen/git_test_pi.h"
+
+#define GIT_TEST_NB_SETP    8           /* number of setpoints written by SVI clients */
+
+/*
+ * Set values, which are written by SVI clients.
+ * SVI writes are queued and applied at cycle start, see git_test_wrq.c.
+ */
+typedef struct GIT_TEST_SETP
+{
+    UINT32  Mode;                       /* operating mode requested by the HMI */
+    REAL32  Value[GIT_TEST_NB_SETP];    /* setpoints */
+} GIT_TEST_SETP;
+
+/*
+ * Values exported via SVI.
+ * The control task writes git_test_SnapWork during the cycle, the content is
+ * published as a whole at cycle end. SVI clients only see published cycles.
+ */
+typedef struct GIT_TEST_SNAP
+{
+    UINT32   CycleCnt;                  /* number of executed control cycles */
+    IN_VARS  InVars;                    /* process image input data of the cycle */
+    OUT_VARS OutVars;                   /* process image output data of the cycle */
+    GIT_TEST_SETP Setp;                 /* set values used in the cycle */
+} GIT_TEST_SNAP;
+
+/*--- Variables ---*/
+
+/* Working copy, written only by the control task */
+extern GIT_TEST_SNAP git_test_SnapWork;
+
+/* Number of snapshot reads which had to be repeated */
+extern UINT32 git_test_SnapRetries;
+
+/*--- Functions ---*/
+
+/* Control task: publish git_test_SnapWork, called at cycle end */
+extern void git_test_snap_publish(void);
+
+/* bTask: take over the last published cycle before an SVI read access */
+extern SINT32 git_test_snap_refresh(void);
+
+/* bTask: complete an interrupted publish before the control task is restarted */
+extern void git_test_snap_reset(void);
+
+/* bTask: snapshot as seen by SVI clients, valid after git_test_snap_refresh */
+extern const GIT_TEST_SNAP *git_test_snap_sviData(void);
+
+/* bTask: register the snapshot variables at the SVI server */
+extern SINT32 git_test_snap_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,202 @@
+/**
+********************************************************************************
+* @file     git_test_stack.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the stack high-water marks of the tasks of
+*           the module.
+*
+*           VxWorks fills the stack of each spawned task with a pattern
+*           (tasks are spawned without VX_NO_STACK_FILL), taskInfoGet()
+*           reports the deepest byte which has been overwritten.
+*           The bTask reads it for all supervised tasks about once a
+*           second and exports for each task via SVI:
+*           - "Stack/<name>/Size"         configured stack size
+*           - "Stack/<name>/HighWater"    maximum stack use in bytes
+*           - "Stack/<name>/Recommended"  HighWater plus
+*             GIT_TEST_STACK_MARGINPCT percent, rounded up to
+*             GIT_TEST_STACK_ROUND; value for the key "StackSize"
+*           A warning is logged once, if a task uses more than
+*           GIT_TEST_STACK_WARNPCT percent of its stack.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_stack.h"
+
+/* Defines: supervision */
+#define STACK_IDLEDIV   10              /* read every 10th idle call */
+#define STACK_NBOFVARS  3               /* SVI variables per task */
+
+/* Supervised task */
+typedef struct STACK_TASK
+{
+    CHAR    Name[SVI_ADDRLEN];          /* visible name */
+    const SINT32 *pTaskId;              /* task id, ERROR if not running */
+    const UINT32 *pStackSize;           /* configured stack size */
+    UINT32  StackSize;                  /* copy of *pStackSize for SVI */
+    UINT32  HighWater;                  /* maximum stack use in bytes */
+    UINT32  Recommended;                /* recommended stack size */
+    UINT32  Warned;                     /* warning has been logged */
+} STACK_TASK;
+
+/* Functions: being called only within this file */
+MLOCAL void Stack_Update(STACK_TASK *pTask);
+
+/* Global variables: supervised tasks */
+MLOCAL STACK_TASK StackTask[GIT_TEST_STACK_MAXTASKS];
+MLOCAL UINT32 StackNbOfTasks = 0;
+MLOCAL UINT32 StackIdleCnt = 0;
+MLOCAL CHAR StackVarName[GIT_TEST_STACK_MAXTASKS * STACK_NBOFVARS][SVI_ADDRLEN];
+MLOCAL SVI_GLOBVAR StackVarList[GIT_TEST_STACK_MAXTASKS * STACK_NBOFVARS];
+
+/**
+********************************************************************************
+* @brief Removes all supervised tasks.
+*        Being called before the SVI variables are registered again.
+*******************************************************************************/
+void git_test_stack_clear(void)
+{
+    StackNbOfTasks = 0;
+}
+
+/**
+********************************************************************************
+* @brief Adds a task to the supervision.
+*        The task id and stack size are read by reference, so the task
+*        can be restarted with new settings.
+*
+* @param[in]  pName       visible name in SVI
+* @param[in]  pTaskId     task id, ERROR or 0 while the task is not running
+* @param[in]  pStackSize  configured stack size in bytes
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_stack_add(const CHAR *pName, const SINT32 *pTaskId,
+                          const UINT32 *pStackSize)
+{
+    STACK_TASK *pTask;
+
+    if (StackNbOfTasks >= GIT_TEST_STACK_MAXTASKS)
+    {
+        LOG_E(0, __func__, "Too many tasks, '%s' not supervised", pName);
+        return (ERROR);
+    }
+
+    pTask = &StackTask[StackNbOfTasks++];
+    memset(pTask, 0, sizeof(*pTask));
+    snprintf(pTask->Name, sizeof(pTask->Name), "%s", pName);
+    pTask->pTaskId = pTaskId;
+    pTask->pStackSize = pStackSize;
+    pTask->StackSize = *pStackSize;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Updates the high-water marks of all supervised tasks.
+*        Called periodically by the bTask in the idle hook.
+*******************************************************************************/
+void git_test_stack_idle(void)
+{
+    UINT32  idx;
+
+    if (++StackIdleCnt < STACK_IDLEDIV)
+    {
+        return;
+    }
+    StackIdleCnt = 0;
+
+    for (idx = 0; idx < StackNbOfTasks; idx++)
+    {
+        Stack_Update(&StackTask[idx]);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Registers the variables of all supervised tasks at the SVI server.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_stack_sviServerInit(void)
+{
+    static const CHAR *pSuffix[STACK_NBOFVARS] = {"Size", "HighWater", "Recommended"};
+    STACK_TASK *pTask;
+    UINT32  NbOfVars = 0;
+    UINT32  idx;
+    UINT32  var;
+
+    for (idx = 0; idx < StackNbOfTasks; idx++)
+    {
+        pTask = &StackTask[idx];
+        for (var = 0; var < STACK_NBOFVARS; var++)
+        {
+            snprintf(StackVarName[NbOfVars], SVI_ADDRLEN, "Stack/%s/%s", pTask->Name, pSuffix[var]);
+            memset(&StackVarList[NbOfVars], 0, sizeof(SVI_GLOBVAR));
+            StackVarList[NbOfVars].VarName = StackVarName[NbOfVars];
+            StackVarList[NbOfVars].Format = SVI_F_OUT | SVI_F_UINT32;
+            StackVarList[NbOfVars].Size = sizeof(UINT32);
+            StackVarList[NbOfVars].pVar = (var == 0) ? &pTask->StackSize :
+                                          (var == 1) ? &pTask->HighWater : &pTask->Recommended;
+            NbOfVars++;
+        }
+    }
+
+    return (git_test_AppSviAddGlobVars(StackVarList, NbOfVars));
+}
+
+/**
+********************************************************************************
+* @brief Reads the stack use of a task.
+*
+* @param[in]  pTask       supervised task
+*******************************************************************************/
+MLOCAL void Stack_Update(STACK_TASK *pTask)
+{
+    TASK_DESC Desc;
+    SINT32  TaskId = *pTask->pTaskId;
+    UINT32  Recommended;
+
+    pTask->StackSize = *pTask->pStackSize;
+    if ((TaskId == ERROR) || (TaskId == 0) || (taskInfoGet(TaskId, &Desc) != OK))
+    {
+        return;
+    }
+
+    if (Desc.td_stackHigh <= pTask->HighWater)
+    {
+        return;
+    }
+
+    pTask->HighWater = Desc.td_stackHigh;
+    Recommended = pTask->HighWater + (pTask->HighWater * GIT_TEST_STACK_MARGINPCT) / 100;
+    pTask->Recommended = ((Recommended + GIT_TEST_STACK_ROUND - 1) / GIT_TEST_STACK_ROUND) *
+                         GIT_TEST_STACK_ROUND;
+
+    if (!pTask->Warned &&
+        ((pTask->HighWater * 100) > (pTask->StackSize * GIT_TEST_STACK_WARNPCT)))
+    {
+        pTask->Warned = TRUE;
+        LOG_W(0, __func__, "Task '%s' has used %d of %d bytes stack, recommended StackSize = %d",
+              pTask->Name, pTask->HighWater, pTask->StackSize, pTask->Recommended);
+    }
+}
@@ -0,0 +1,37 @@
+/**
+********************************************************************************
+* @file     git_test_stack.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the stack high-water
+*           marks of the tasks of the module.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_STACK__H
+#define GIT_TEST_STACK__H
+
+/* Defines: stack supervision */
+#define GIT_TEST_STACK_MAXTASKS     8   /* maximum number of supervised tasks */
+#define GIT_TEST_STACK_WARNPCT      75  /* warning if more percent are used */
+#define GIT_TEST_STACK_MARGINPCT    50  /* margin of the recommended stack size */
+#define GIT_TEST_STACK_ROUND        1024    /* recommended stack size is a multiple of it */
+#define GIT_TEST_STACK_MINSIZE      4096    /* minimum for the key "StackSize" */
+
+/*--- Functions ---*/
+
+/* bTask: supervise a task, before git_test_stack_sviServerInit() */
+extern void git_test_stack_clear(void);
+extern SINT32 git_test_stack_add(const CHAR *pName, const SINT32 *pTaskId,
+                                 const UINT32 *pStackSize);
+
+/* bTask: update the high-water marks, called periodically */
+extern void git_test_stack_idle(void);
+
+/* bTask: register the high-water marks at the SVI server */
+extern SINT32 git_test_stack_sviServerInit(void);
+
+#endif /* Avoid problems with multiple include */
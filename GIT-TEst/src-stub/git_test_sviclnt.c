@@ -0,0 +1,564 @@
+/**
+********************************************************************************
+* @file     git_test_sviclnt.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the SVI client of the application.
+*
+*           The names of the remote variables are configured in mconfig:
+*               (SviClient)
+*               Var1 = "RES/..."
+*               Var2 = ...
+*           The module name is the part of the variable name before the
+*           first '/'.
+*           - At end of init the bTask gets the SVI library of each remote
+*             module once and resolves all names to SVI addresses.
+*           - At each cycle start the control task reads all variables by
+*             address in one pass, grouped per remote module. There is no
+*             name lookup in the cycle. The reads are calls into the SVI
+*             library of the remote module, not SMI messages, so there is
+*             no round trip which a multi-block request would save.
+*           - git_test_control_cycle() gets the values by the index of
+*             their key, Var1 is 0.
+*           - If a read fails (e.g. the remote module has been restarted),
+*             the remote module is marked invalid. The bTask gets the
+*             library again and resolves the names of this module in
+*             git_test_sviclnt_idle(), then the module is valid again.
+*           - Variables which could not be resolved while their module is
+*             valid (e.g. not yet created by the remote module) are
+*             retried by git_test_sviclnt_idle() about once a second.
+*           Ownership of the module data is passed by the flag Valid:
+*           the control task only uses a module while it is valid,
+*           the bTask only changes a module while it is invalid.
+*           In the same way, the flag Resolved passes a single variable
+*           of a valid module; the control task takes the flags of a module
+*           once per cycle, before the addresses are used.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stdio.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_sviclnt.h"
+#include "git_test_cfgidx.h"
+
+/* Defines: retry */
+#define SVICLNT_IDLEDIV 10              /* retry unresolved variables every 10th idle call */
+
+/* Settings and state of a remote software module */
+typedef struct SVICLNT_MOD
+{
+    CHAR    Name[M_MODNAMELEN_A];       /* name of the remote module */
+    SINT32  (**pSviLib) ();             /* SVI library of the remote module */
+    volatile UINT32 Valid;              /* addresses are resolved and may be used */
+    UINT32  NbOfResolves;               /* statistics: number of (re-)resolves */
+} SVICLNT_MOD;
+
+/* Settings and value of a remote variable */
+typedef struct SVICLNT_VAR
+{
+    CHAR    VarName[SVI_ADDRLEN];       /* full SVI name, e.g. "RES/..." */
+    UINT32  ModIdx;                     /* index in SviClntModList */
+    SVI_ADDR Addr;                      /* resolved address */
+    UINT32  Format;                     /* SVI format of the variable */
+    volatile UINT32 Resolved;           /* address has been resolved and may be used */
+    UINT32  ValValid;                   /* Val contains the value of this cycle */
+    UINT32  Val[GIT_TEST_SVICLNT_MAXVALLEN / sizeof(UINT32)];   /* value */
+} SVICLNT_VAR;
+
+/* Functions: being called only within this file */
+MLOCAL void SviClnt_CfgClear(void);
+MLOCAL SINT32 SviClnt_CfgAdd(const CHAR *pVarName);
+MLOCAL SINT32 SviClnt_Resolve(UINT32 ModIdx);
+MLOCAL void SviClnt_Retry(UINT32 ModIdx);
+MLOCAL void SviClnt_Release(UINT32 ModIdx);
+
+/* Global variables: SVI client */
+MLOCAL SVICLNT_MOD SviClntModList[GIT_TEST_SVICLNT_MAXMODS];
+MLOCAL SVICLNT_VAR SviClntVarList[GIT_TEST_SVICLNT_MAXVARS];
+MLOCAL UINT32 SviClntNbOfMods = 0;
+MLOCAL UINT32 SviClntNbOfVars = 0;
+MLOCAL UINT32 SviClntActive = FALSE;    /* client has been initialized */
+MLOCAL UINT32 SviClntIdleCnt = 0;
+
+/**
+********************************************************************************
+* @brief Reads the list of remote variables from the configuration file.
+*        All keys Var1, Var2, ... of the group "SviClient" are read
+*        until a key is missing. The group is optional.
+*        The list in use is not changed, see git_test_sviclnt_cfgSet().
+*
+* @param[out] pNames    names, unused entries are empty
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_sviclnt_cfgParse(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN])
+{
+    CHAR    key[PF_KEYLEN_A];
+    CHAR    VarName[SVI_ADDRLEN];
+    UINT32  NbOfVars = 0;
+    SINT32  ret;
+
+    memset(pNames, 0, GIT_TEST_SVICLNT_MAXVARS * SVI_ADDRLEN);
+
+    for (;;)
+    {
+        sprintf(key, "Var%d", NbOfVars + 1);
+        ret = git_test_cfgidx_getStrg("SviClient", key, "", VarName, sizeof(VarName));
+
+        /* end of list */
+        if (ret == ERROR)
+        {
+            break;
+        }
+        if (ret < 0)
+        {
+            return (ret);
+        }
+
+        if (NbOfVars >= GIT_TEST_SVICLNT_MAXVARS)
+        {
+            LOG_E(0, __func__, "Too many remote variables, maximum is %d!",
+                  GIT_TEST_SVICLNT_MAXVARS);
+            return (MIO_ER_BADCONF);
+        }
+
+        strcpy(pNames[NbOfVars++], VarName);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Returns the configured names of the remote variables,
+*        e.g. for the binary configuration image.
+*
+* @param[out] pNames    names, unused entries are empty
+*******************************************************************************/
+void git_test_sviclnt_cfgGet(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN])
+{
+    UINT32  idx;
+
+    memset(pNames, 0, GIT_TEST_SVICLNT_MAXVARS * SVI_ADDRLEN);
+
+    for (idx = 0; idx < SviClntNbOfVars; idx++)
+    {
+        strcpy(pNames[idx], SviClntVarList[idx].VarName);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Sets the names of the remote variables instead of reading
+*        them from the configuration file.
+*
+* @param[in]  pNames    names as returned by git_test_sviclnt_cfgGet()
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_sviclnt_cfgSet(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN])
+{
+    UINT32  idx;
+    SINT32  ret;
+
+    SviClnt_CfgClear();
+
+    for (idx = 0; (idx < GIT_TEST_SVICLNT_MAXVARS) && pNames[idx][0]; idx++)
+    {
+        pNames[idx][SVI_ADDRLEN - 1] = 0;
+        ret = SviClnt_CfgAdd(pNames[idx]);
+        if (ret < 0)
+        {
+            return (ret);
+        }
+    }
+
+    LOG_I(1, __func__, "%d remote variables of %d modules configured",
+          SviClntNbOfVars, SviClntNbOfMods);
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Removes all remote variables and modules.
+*******************************************************************************/
+MLOCAL void SviClnt_CfgClear(void)
+{
+    SviClntNbOfMods = 0;
+    SviClntNbOfVars = 0;
+    memset(SviClntModList, 0, sizeof(SviClntModList));
+    memset(SviClntVarList, 0, sizeof(SviClntVarList));
+}
+
+/**
+********************************************************************************
+* @brief Adds a remote variable and its module.
+*
+* @param[in]  pVarName  full SVI name, the module name is the part before '/'
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 SviClnt_CfgAdd(const CHAR *pVarName)
+{
+    static const CHAR *pFunc = __func__;
+    CHAR    ModName[M_MODNAMELEN_A];
+    CHAR    *pSlash;
+    SVICLNT_VAR *pVar;
+    UINT32  Len;
+    UINT32  ModIdx;
+
+    if (SviClntNbOfVars >= GIT_TEST_SVICLNT_MAXVARS)
+    {
+        LOG_E(0, pFunc, "Too many remote variables, maximum is %d!",
+              GIT_TEST_SVICLNT_MAXVARS);
+        return (MIO_ER_BADCONF);
+    }
+
+    pVar = &SviClntVarList[SviClntNbOfVars];
+    strcpy(pVar->VarName, pVarName);
+
+    /* Module name is the first part of the variable name */
+    pSlash = strchr(pVar->VarName, '/');
+    Len = pSlash ? (UINT32)(pSlash - pVar->VarName) : 0;
+    if ((Len < 1) || (Len > M_MODNAMELEN))
+    {
+        LOG_E(0, pFunc, "Bad configuration: no module name in '%s'", pVar->VarName);
+        return (MIO_ER_BADCONF);
+    }
+    memcpy(ModName, pVar->VarName, Len);
+    ModName[Len] = 0;
+
+    /* Find or add remote module */
+    for (ModIdx = 0; ModIdx < SviClntNbOfMods; ModIdx++)
+    {
+        if (strcmp(SviClntModList[ModIdx].Name, ModName) == 0)
+        {
+            break;
+        }
+    }
+
+    if (ModIdx == SviClntNbOfMods)
+    {
+        if (SviClntNbOfMods >= GIT_TEST_SVICLNT_MAXMODS)
+        {
+            LOG_E(0, pFunc, "Too many remote modules, maximum is %d!",
+                  GIT_TEST_SVICLNT_MAXMODS);
+            return (MIO_ER_BADCONF);
+        }
+        strcpy(SviClntModList[ModIdx].Name, ModName);
+        SviClntNbOfMods++;
+    }
+
+    pVar->ModIdx = ModIdx;
+    SviClntNbOfVars++;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Resolves all configured remote variables.
+*        A remote module which is not available yet does not lead to an
+*        error, it is resolved later by git_test_sviclnt_idle().
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_sviclnt_init(void)
+{
+    UINT32  ModIdx;
+
+    for (ModIdx = 0; ModIdx < SviClntNbOfMods; ModIdx++)
+    {
+        if (SviClnt_Resolve(ModIdx) < 0)
+        {
+            LOG_W(0, __func__, "SVI of module '%s' not available yet!",
+                  SviClntModList[ModIdx].Name);
+        }
+    }
+
+    SviClntActive = TRUE;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Informs the remote modules that their SVI libraries are
+*        no longer required.
+*        The application tasks must have been deleted before.
+*******************************************************************************/
+void git_test_sviclnt_deinit(void)
+{
+    UINT32  ModIdx;
+
+    SviClntActive = FALSE;
+
+    for (ModIdx = 0; ModIdx < SviClntNbOfMods; ModIdx++)
+    {
+        SviClntModList[ModIdx].Valid = FALSE;
+        SviClnt_Release(ModIdx);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Resolves all remote modules which have been marked invalid and
+*        retries the unresolved variables of the valid modules.
+*        Called periodically by the bTask.
+*******************************************************************************/
+void git_test_sviclnt_idle(void)
+{
+    UINT32  Retry;
+    UINT32  ModIdx;
+
+    if (!SviClntActive)
+    {
+        return;
+    }
+
+    Retry = (++SviClntIdleCnt >= SVICLNT_IDLEDIV);
+    if (Retry)
+    {
+        SviClntIdleCnt = 0;
+    }
+
+    for (ModIdx = 0; ModIdx < SviClntNbOfMods; ModIdx++)
+    {
+        if (!SviClntModList[ModIdx].Valid)
+        {
+            if (SviClnt_Resolve(ModIdx) == OK)
+            {
+                LOG_I(1, __func__, "SVI of module '%s' resolved again",
+                      SviClntModList[ModIdx].Name);
+            }
+        }
+        else if (Retry)
+        {
+            SviClnt_Retry(ModIdx);
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Reads all remote variables by their resolved addresses.
+*        Called by the control task at cycle start.
+*        The variables of one module are read in one pass.
+*        On the first error, the module is passed to the bTask
+*        for a new resolve.
+*******************************************************************************/
+void git_test_sviclnt_read(void)
+{
+    UINT32  ModIdx;
+    UINT32  idx;
+    UINT32  Len;
+    UINT32  Resolved;
+    SINT32  ret;
+    SVICLNT_MOD *pMod;
+    SVICLNT_VAR *pVar;
+
+    for (ModIdx = 0; ModIdx < SviClntNbOfMods; ModIdx++)
+    {
+        pMod = &SviClntModList[ModIdx];
+        ret = SVI_E_OK;
+
+        if (!pMod->Valid)
+        {
+            continue;
+        }
+
+        /* Variables released so far, also by SviClnt_Retry() */
+        Resolved = 0;
+        for (idx = 0; idx < SviClntNbOfVars; idx++)
+        {
+            Resolved |= ((SviClntVarList[idx].ModIdx == ModIdx) &&
+                         SviClntVarList[idx].Resolved) ? (1u << idx) : 0;
+        }
+
+        /* Module data is only used after it has been released by the bTask */
+        GIT_TEST_MEMBARRIER();
+
+        for (idx = 0; idx < SviClntNbOfVars; idx++)
+        {
+            pVar = &SviClntVarList[idx];
+            if (!(Resolved & (1u << idx)))
+            {
+                continue;
+            }
+
+            if (pVar->Format & SVI_F_BLK)
+            {
+                Len = sizeof(pVar->Val);
+                ret = svi_GetBlk(pMod->pSviLib, pVar->Addr, pVar->Val, &Len);
+            }
+            else
+            {
+                ret = svi_GetVal(pMod->pSviLib, pVar->Addr, pVar->Val);
+            }
+
+            if (ret != SVI_E_OK)
+            {
+                break;
+            }
+
+            pVar->ValValid = TRUE;
+        }
+
+        /* Pass the module to the bTask, don't touch it any more */
+        if (ret != SVI_E_OK)
+        {
+            for (idx = 0; idx < SviClntNbOfVars; idx++)
+            {
+                if (SviClntVarList[idx].ModIdx == ModIdx)
+                {
+                    SviClntVarList[idx].ValValid = FALSE;
+                }
+            }
+
+            GIT_TEST_MEMBARRIER();
+            pMod->Valid = FALSE;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the value of a remote variable read at cycle start.
+*
+* @param[in]  Idx      index of the variable, Var1 is 0
+*
+* @retval     pointer to the value, NULL if the value is not available
+*******************************************************************************/
+const void *git_test_sviclnt_getVal(UINT32 Idx)
+{
+    if ((Idx >= SviClntNbOfVars) || !SviClntVarList[Idx].ValValid)
+    {
+        return (NULL);
+    }
+
+    return (SviClntVarList[Idx].Val);
+}
+
+/**
+********************************************************************************
+* @brief Gets the SVI library of a remote module and resolves the
+*        addresses of all its variables. The module is marked valid
+*        afterwards. Variables which could not be resolved are skipped
+*        until they are resolved by SviClnt_Retry().
+*        Must only be called while the module is invalid.
+*
+* @param[in]  ModIdx   index of the remote module
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 SviClnt_Resolve(UINT32 ModIdx)
+{
+    SVICLNT_MOD *pMod = &SviClntModList[ModIdx];
+    SVICLNT_VAR *pVar;
+    UINT32  idx;
+
+    /* A library of a restarted module is not valid any more */
+    SviClnt_Release(ModIdx);
+
+    pMod->pSviLib = svi_GetLib(pMod->Name);
+    if (!pMod->pSviLib)
+    {
+        return (ERROR);
+    }
+
+    for (idx = 0; idx < SviClntNbOfVars; idx++)
+    {
+        pVar = &SviClntVarList[idx];
+        if (pVar->ModIdx != ModIdx)
+        {
+            continue;
+        }
+
+        pVar->Resolved = FALSE;
+        if (svi_GetAddr(pMod->pSviLib, pVar->VarName, &pVar->Addr, &pVar->Format) != SVI_E_OK)
+        {
+            LOG_W(0, __func__, "Could not resolve SVI variable '%s', retrying", pVar->VarName);
+            continue;
+        }
+        pVar->Resolved = TRUE;
+    }
+
+    pMod->NbOfResolves++;
+
+    /* Addresses must be complete before the control task uses them */
+    GIT_TEST_MEMBARRIER();
+    pMod->Valid = TRUE;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Resolves the variables of a valid remote module which could not be
+*        resolved so far. The control task skips such a variable, so its
+*        address may be set while the module is in use.
+*
+* @param[in]  ModIdx   index of the remote module
+*******************************************************************************/
+MLOCAL void SviClnt_Retry(UINT32 ModIdx)
+{
+    SVICLNT_MOD *pMod = &SviClntModList[ModIdx];
+    SVICLNT_VAR *pVar;
+    UINT32  idx;
+
+    for (idx = 0; idx < SviClntNbOfVars; idx++)
+    {
+        pVar = &SviClntVarList[idx];
+        if ((pVar->ModIdx != ModIdx) || pVar->Resolved)
+        {
+            continue;
+        }
+
+        if (svi_GetAddr(pMod->pSviLib, pVar->VarName, &pVar->Addr, &pVar->Format) == SVI_E_OK)
+        {
+            /* Address must be complete before the control task uses it */
+            GIT_TEST_MEMBARRIER();
+            pVar->Resolved = TRUE;
+            LOG_I(1, __func__, "SVI variable '%s' resolved", pVar->VarName);
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Releases the SVI library of a remote module.
+*
+* @param[in]  ModIdx   index of the remote module
+*******************************************************************************/
+MLOCAL void SviClnt_Release(UINT32 ModIdx)
+{
+    SVICLNT_MOD *pMod = &SviClntModList[ModIdx];
+
+    if (pMod->pSviLib)
+    {
+        if (svi_UngetLib(pMod->pSviLib) < 0)
+        {
+            LOG_E(0, __func__, "svi_UngetLib of module '%s' failed!", pMod->Name);
+        }
+        pMod->pSviLib = NULL;
+    }
+}
@@ -0,0 +1,44 @@
+/**
+********************************************************************************
+* @file     git_test_sviclnt.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the SVI client, which
+*           reads variables of other software modules.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_SVICLNT__H
+#define GIT_TEST_SVICLNT__H
+
+/* Defines: SVI client */
+#define GIT_TEST_SVICLNT_MAXVARS    32  /* maximum number of remote variables, bits of a UINT32 */
+#define GIT_TEST_SVICLNT_MAXMODS    8   /* maximum number of remote modules */
+#define GIT_TEST_SVICLNT_MAXVALLEN  64  /* maximum size of a remote variable in bytes */
+
+/*--- Functions ---*/
+
+/* bTask: read list of remote variable names from mconfig */
+extern SINT32 git_test_sviclnt_cfgParse(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN]);
+
+/* bTask: names in use; set names while the control task is not running */
+extern void git_test_sviclnt_cfgGet(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN]);
+extern SINT32 git_test_sviclnt_cfgSet(CHAR pNames[GIT_TEST_SVICLNT_MAXVARS][SVI_ADDRLEN]);
+
+/* bTask: resolve all remote variables, called at end of init */
+extern SINT32 git_test_sviclnt_init(void);
+extern void git_test_sviclnt_deinit(void);
+
+/* bTask: re-resolve remote modules which have been restarted */
+extern void git_test_sviclnt_idle(void);
+
+/* Control task: read all remote variables, called at cycle start */
+extern void git_test_sviclnt_read(void);
+
+/* Control task: value of Var<Idx + 1> read at cycle start, NULL if currently not available */
+extern const void *git_test_sviclnt_getVal(UINT32 Idx);
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,216 @@
+/**
+********************************************************************************
+* @file     git_test_svidx.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the name index of the SVI variables which
+*           are registered by the application.
+*
+*           Every variable of an SVI_GLOBVAR or SVI_VIRTVAR list is entered
+*           into a hash table in the same pass in which it is registered
+*           at the SVI server, after the SVI server has accepted it. The
+*           handle returned by the SVI server is stored in VarHandle of the
+*           list entry.
+*           The table uses open addressing with linear probing. The full
+*           32 bit hash value is stored in each slot, so a name is only
+*           compared if the hash values are equal.
+*           The cost of the duplicate check of a new name does not depend
+*           on the number of registered variables.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_svidx.h"
+
+/* Defines: hash function (FNV-1a, 32 bit) */
+#define SVIDX_FNV_OFFSET    2166136261u
+#define SVIDX_FNV_PRIME     16777619u
+#define SVIDX_MASK          (GIT_TEST_SVIDX_SIZE - 1)
+
+/* Type of the indexed list entry */
+enum svidxType {SVIDX_EMPTY, SVIDX_GLOBVAR, SVIDX_VIRTVAR};
+
+/* Slot of the hash table */
+typedef struct SVIDX_SLOT
+{
+    UINT32  Hash;                       /* hash value of the name */
+    UINT32  Type;                       /* see enum svidxType */
+    void    *pVar;                      /* SVI_GLOBVAR or SVI_VIRTVAR list entry */
+} SVIDX_SLOT;
+
+/* Functions: being called only within this file */
+MLOCAL UINT32 Svidx_Hash(const CHAR *pName);
+MLOCAL const CHAR *Svidx_Name(const SVIDX_SLOT *pSlot);
+MLOCAL SINT32 Svidx_Add(const CHAR *pName, UINT32 Type, void *pVar);
+
+/* Global variables: index */
+MLOCAL SVIDX_SLOT SvidxTable[GIT_TEST_SVIDX_SIZE];
+MLOCAL UINT32 SvidxNbOfVars = 0;
+MLOCAL UINT32 SvidxMaxProbe = 0;
+
+/**
+********************************************************************************
+* @brief Removes all entries from the index.
+*        Called before the application variables are registered.
+*******************************************************************************/
+void git_test_svidx_clear(void)
+{
+    memset(SvidxTable, 0, sizeof(SvidxTable));
+    SvidxNbOfVars = 0;
+    SvidxMaxProbe = 0;
+}
+
+/**
+********************************************************************************
+* @brief Enters a global variable into the index.
+*
+* @param[in]  pVar   list entry of the variable
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, duplicate name or index full
+*******************************************************************************/
+SINT32 git_test_svidx_addGlobVar(SVI_GLOBVAR *pVar)
+{
+    return (Svidx_Add(pVar->VarName, SVIDX_GLOBVAR, pVar));
+}
+
+/**
+********************************************************************************
+* @brief Enters a virtual variable into the index.
+*
+* @param[in]  pVar   list entry of the variable
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, duplicate name or index full
+*******************************************************************************/
+SINT32 git_test_svidx_addVirtVar(SVI_VIRTVAR *pVar)
+{
+    return (Svidx_Add(pVar->VarName, SVIDX_VIRTVAR, pVar));
+}
+
+/**
+********************************************************************************
+* @brief Returns the number of indexed variables.
+*******************************************************************************/
+UINT32 git_test_svidx_getNbOfVars(void)
+{
+    return (SvidxNbOfVars);
+}
+
+/**
+********************************************************************************
+* @brief Returns the longest probe sequence of all entries.
+*        This is the worst case number of slots visited by a duplicate check.
+*******************************************************************************/
+UINT32 git_test_svidx_getMaxProbe(void)
+{
+    return (SvidxMaxProbe);
+}
+
+/**
+********************************************************************************
+* @brief Calculates the hash value of a name (FNV-1a).
+*
+* @param[in]  pName   null terminated name
+*
+* @retval     hash value
+*******************************************************************************/
+MLOCAL UINT32 Svidx_Hash(const CHAR *pName)
+{
+    UINT32  Hash = SVIDX_FNV_OFFSET;
+
+    while (*pName)
+    {
+        Hash ^= (UINT8)*pName++;
+        Hash *= SVIDX_FNV_PRIME;
+    }
+
+    return (Hash);
+}
+
+/**
+********************************************************************************
+* @brief Returns the name of the list entry referenced by a slot.
+*******************************************************************************/
+MLOCAL const CHAR *Svidx_Name(const SVIDX_SLOT *pSlot)
+{
+    if (pSlot->Type == SVIDX_GLOBVAR)
+    {
+        return (((const SVI_GLOBVAR *)pSlot->pVar)->VarName);
+    }
+
+    return (((const SVI_VIRTVAR *)pSlot->pVar)->VarName);
+}
+
+/**
+********************************************************************************
+* @brief Enters a list entry into the index.
+*        Names are unique within the SVI server, independent of the type.
+*
+* @param[in]  pName   visible name of the variable
+* @param[in]  Type    SVIDX_GLOBVAR or SVIDX_VIRTVAR
+* @param[in]  pVar    list entry of the variable
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Svidx_Add(const CHAR *pName, UINT32 Type, void *pVar)
+{
+    UINT32  Hash;
+    UINT32  Pos;
+    UINT32  Probe;
+    SVIDX_SLOT *pSlot;
+
+    if (SvidxNbOfVars >= GIT_TEST_SVIDX_MAXVARS)
+    {
+        LOG_E(0, __func__, "SVI index full, maximum is %d variables!", GIT_TEST_SVIDX_MAXVARS);
+        return (ERROR);
+    }
+
+    Hash = Svidx_Hash(pName);
+    Pos = Hash & SVIDX_MASK;
+
+    for (Probe = 1; ; Probe++)
+    {
+        pSlot = &SvidxTable[Pos];
+
+        if (pSlot->Type == SVIDX_EMPTY)
+        {
+            break;
+        }
+
+        if ((pSlot->Hash == Hash) && (strcmp(Svidx_Name(pSlot), pName) == 0))
+        {
+            LOG_E(0, __func__, "SVI variable '%s' registered twice!", pName);
+            return (ERROR);
+        }
+
+        Pos = (Pos + 1) & SVIDX_MASK;
+    }
+
+    pSlot->Hash = Hash;
+    pSlot->Type = Type;
+    pSlot->pVar = pVar;
+    SvidxNbOfVars++;
+
+    if (Probe > SvidxMaxProbe)
+    {
+        SvidxMaxProbe = Probe;
+    }
+
+    return (OK);
+}
@@ -0,0 +1,33 @@
+/**
+********************************************************************************
+* @file     git_test_svidx.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the name index of the
+*           SVI variables registered by the application.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_SVIDX__H
+#define GIT_TEST_SVIDX__H
+
+/* Defines: size of the index */
+#define GIT_TEST_SVIDX_BITS     12      /* index has 2^BITS slots */
+#define GIT_TEST_SVIDX_SIZE     (1 << GIT_TEST_SVIDX_BITS)
+#define GIT_TEST_SVIDX_MAXVARS  ((GIT_TEST_SVIDX_SIZE * 3) / 4)    /* maximum load */
+
+/*--- Functions ---*/
+
+/* bTask: index administration, used by git_test_AppSviAdd...Vars after a variable is registered */
+extern void git_test_svidx_clear(void);
+extern SINT32 git_test_svidx_addGlobVar(SVI_GLOBVAR *pVar);
+extern SINT32 git_test_svidx_addVirtVar(SVI_VIRTVAR *pVar);
+
+/* Number of indexed variables and maximum probe length */
+extern UINT32 git_test_svidx_getNbOfVars(void);
+extern UINT32 git_test_svidx_getMaxProbe(void);
+
+#endif /* Avoid problems with multiple include */
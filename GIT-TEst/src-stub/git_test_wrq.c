@@ -0,0 +1,355 @@
+/**
+********************************************************************************
+* @file     git_test_wrq.c
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the queue of SVI write accesses.
+*
+*           Writable application variables are registered as virtual SVI
+*           variables. Their write function does not change the variable,
+*           but puts the new value into a bounded single producer /
+*           single consumer queue:
+*           - the bTask is the producer. All writes of one SVI call
+*             (e.g. SETVALLST) are collected between git_test_wrq_begin()
+*             and git_test_wrq_commit() and are made visible as one group.
+*           - the control task is the consumer. At cycle start it applies
+*             all committed groups to git_test_SnapWork.Setp.
+*           So a multi-variable setpoint change is either taken over
+*           completely within one cycle or not at all.
+*           If the queue is full, the whole group is dropped and counted,
+*           the control task never waits for the bTask.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <semLib.h>
+#include <stddef.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "git_test_int.h"
+#include "git_test_snap.h"
+#include "git_test_wrq.h"
+
+/* Defines: queue dimensions */
+#define WRQ_SIZE        64              /* number of entries, must be a power of 2 */
+#define WRQ_MASK        (WRQ_SIZE - 1)
+#define WRQ_DATALEN     32              /* maximum size of a single write in bytes */
+
+/* One queued write access */
+typedef struct WRQ_ENTRY
+{
+    UINT32  Offset;                     /* offset in GIT_TEST_SETP */
+    UINT32  Len;                        /* number of bytes to be written */
+    UINT8   Data[WRQ_DATALEN];          /* new value */
+} WRQ_ENTRY;
+
+/* Functions: access functions of the virtual SVI variables */
+MLOCAL SINT32 Wrq_SviRead(UINT32 Offset, UINT32 Size, void *pBuff, UINT32 *pBuffLen);
+MLOCAL SINT32 Wrq_SviWrite(UINT32 Offset, UINT32 Size, void *pBuff, UINT32 *pBuffLen);
+MLOCAL SINT32 Wrq_Put(UINT32 Offset, const void *pData, UINT32 Len);
+
+/* Global variables: queue */
+GIT_TEST_WRQ_STAT git_test_WrqStat;     /* statistics */
+MLOCAL WRQ_ENTRY WrqBuf[WRQ_SIZE];      /* ring buffer */
+MLOCAL volatile UINT32 WrqHead = 0;     /* next entry to apply, written by control task */
+MLOCAL volatile UINT32 WrqTail = 0;     /* end of committed entries, written by producer */
+MLOCAL UINT32 WrqTailPriv = 0;          /* end of the open group */
+MLOCAL UINT32 WrqGroupOverflow = FALSE; /* open group did not fit into the queue */
+MLOCAL SINT32 WrqGroupOwner = 0;        /* task which has opened the group */
+MLOCAL SEM_ID WrqProdSema = 0;          /* serializes producers, never taken by control task */
+
+/*
+ * Global variables: List of all writable variables
+ * The parameters Rpar1/Wpar1 contain the offset in GIT_TEST_SETP,
+ * Rpar2/Wpar2 contain the size.
+ */
+MLOCAL SVI_VIRTVAR WrqVarList[] = {
+    {"Setp/Mode", SVI_F_INOUT | SVI_F_UINT32, sizeof(UINT32),
+     offsetof(GIT_TEST_SETP, Mode), sizeof(UINT32),
+     offsetof(GIT_TEST_SETP, Mode), sizeof(UINT32),
+     Wrq_SviRead, Wrq_SviWrite},
+    {"Setp/Value", SVI_F_INOUT | SVI_F_BLK | SVI_F_REAL32, sizeof(REAL32) * GIT_TEST_NB_SETP,
+     offsetof(GIT_TEST_SETP, Value), sizeof(REAL32) * GIT_TEST_NB_SETP,
+     offsetof(GIT_TEST_SETP, Value), sizeof(REAL32) * GIT_TEST_NB_SETP,
+     Wrq_SviRead, Wrq_SviWrite}
+};
+
+/* Global variables: statistics exported via SVI */
+MLOCAL SVI_GLOBVAR WrqStatVarList[] = {
+    {"Setp/Stat/Groups", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_WrqStat.NbOfGroups, 0, 0, NULL, NULL, 0, NULL},
+    {"Setp/Stat/Writes", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_WrqStat.NbOfWrites, 0, 0, NULL, NULL, 0, NULL},
+    {"Setp/Stat/Overflows", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_WrqStat.NbOfOverflows, 0, 0, NULL, NULL, 0, NULL},
+    {"Setp/Stat/Dropped", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_WrqStat.NbOfDropped, 0, 0, NULL, NULL, 0, NULL},
+    {"Setp/Stat/MaxFill", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32),
+     &git_test_WrqStat.MaxFill, 0, 0, NULL, NULL, 0, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Opens a write group.
+*        All following writes of the calling task are collected until
+*        git_test_wrq_commit() is called.
+*******************************************************************************/
+void git_test_wrq_begin(void)
+{
+    (void)semTake(WrqProdSema, WAIT_FOREVER);
+
+    WrqGroupOwner = taskIdSelf();
+    WrqTailPriv = WrqTail;
+    WrqGroupOverflow = FALSE;
+}
+
+/**
+********************************************************************************
+* @brief Closes a write group and makes it visible for the control task.
+*        If a write of the group did not fit into the queue,
+*        the whole group is dropped.
+*******************************************************************************/
+void git_test_wrq_commit(void)
+{
+    UINT32  NbOfWrites = WrqTailPriv - WrqTail;
+    UINT32  Fill;
+
+    if (WrqGroupOverflow)
+    {
+        /* Discard the complete group */
+        git_test_WrqStat.NbOfOverflows++;
+        git_test_WrqStat.NbOfDropped += NbOfWrites;
+        WrqTailPriv = WrqTail;
+    }
+    else if (NbOfWrites)
+    {
+        /* Entries must be complete before the new tail is visible */
+        GIT_TEST_MEMBARRIER();
+        WrqTail = WrqTailPriv;
+
+        git_test_WrqStat.NbOfGroups++;
+        git_test_WrqStat.NbOfWrites += NbOfWrites;
+
+        Fill = WrqTail - WrqHead;
+        if (Fill > git_test_WrqStat.MaxFill)
+        {
+            git_test_WrqStat.MaxFill = Fill;
+        }
+    }
+
+    WrqGroupOwner = 0;
+    (void)semGive(WrqProdSema);
+}
+
+/**
+********************************************************************************
+* @brief Discards a write group left open by the calling task.
+*        Called by the bTask after it has been restarted on an exception,
+*        which may have occurred between git_test_wrq_begin() and
+*        git_test_wrq_commit().
+*******************************************************************************/
+void git_test_wrq_abort(void)
+{
+    if (!WrqProdSema || (WrqGroupOwner != taskIdSelf()))
+    {
+        return;
+    }
+
+    WrqTailPriv = WrqTail;
+    WrqGroupOwner = 0;
+    (void)semGive(WrqProdSema);
+}
+
+/**
+********************************************************************************
+* @brief Applies all committed write groups to the set values.
+*        Called by the control task at cycle start, does never block.
+*******************************************************************************/
+void git_test_wrq_apply(void)
+{
+    UINT32  Head = WrqHead;
+    UINT32  Tail = WrqTail;
+    UINT8   *pSetp = (UINT8 *)&git_test_SnapWork.Setp;
+    WRQ_ENTRY *pEntry;
+
+    /* Read the entries only after the tail */
+    GIT_TEST_MEMBARRIER();
+
+    while (Head != Tail)
+    {
+        pEntry = &WrqBuf[Head & WRQ_MASK];
+        memcpy(pSetp + pEntry->Offset, pEntry->Data, pEntry->Len);
+        Head++;
+    }
+
+    /* Entries must be consumed before they are released to the producer */
+    GIT_TEST_MEMBARRIER();
+    WrqHead = Head;
+}
+
+/**
+********************************************************************************
+* @brief Puts a single write into the open group.
+*
+* @param[in]  Offset   offset in GIT_TEST_SETP
+* @param[in]  pData    new value
+* @param[in]  Len      size of the new value in bytes
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, queue full
+*******************************************************************************/
+MLOCAL SINT32 Wrq_Put(UINT32 Offset, const void *pData, UINT32 Len)
+{
+    WRQ_ENTRY *pEntry;
+
+    if ((WrqTailPriv - WrqHead) >= WRQ_SIZE)
+    {
+        WrqGroupOverflow = TRUE;
+        return (ERROR);
+    }
+
+    pEntry = &WrqBuf[WrqTailPriv & WRQ_MASK];
+    pEntry->Offset = Offset;
+    pEntry->Len = Len;
+    memcpy(pEntry->Data, pData, Len);
+    WrqTailPriv++;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Read function of the writable virtual SVI variables.
+*        Returns the value of the last published cycle.
+*
+* @param[in]  Offset     offset in GIT_TEST_SETP
+* @param[in]  Size       size of the variable in bytes
+* @param[out] pBuff      buffer for the value
+* @param[in,out] pBuffLen  size of buffer, returns number of bytes read
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Wrq_SviRead(UINT32 Offset, UINT32 Size, void *pBuff, UINT32 *pBuffLen)
+{
+    const UINT8 *pSetp = (const UINT8 *)&git_test_snap_sviData()->Setp;
+
+    if (*pBuffLen < Size)
+    {
+        return (SVI_E_FAILED);
+    }
+
+    memcpy(pBuff, pSetp + Offset, Size);
+    *pBuffLen = Size;
+
+    return (SVI_E_OK);
+}
+
+/**
+********************************************************************************
+* @brief Write function of the writable virtual SVI variables.
+*        The new value is queued and applied at the next cycle start.
+*        If the caller is not inside a write group (e.g. access via
+*        SVI library of another module), the write forms its own group.
+*
+* @param[in]  Offset     offset in GIT_TEST_SETP
+* @param[in]  Size       size of the variable in bytes
+* @param[in]  pBuff      new value
+* @param[in]  pBuffLen   size of new value in bytes
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Wrq_SviWrite(UINT32 Offset, UINT32 Size, void *pBuff, UINT32 *pBuffLen)
+{
+    SINT32  ret;
+    UINT32  OwnGroup = (WrqGroupOwner != taskIdSelf());
+
+    if ((*pBuffLen != Size) || (Size > WRQ_DATALEN))
+    {
+        return (SVI_E_FAILED);
+    }
+
+    if (OwnGroup)
+    {
+        git_test_wrq_begin();
+    }
+
+    ret = Wrq_Put(Offset, pBuff, Size);
+
+    if (OwnGroup)
+    {
+        git_test_wrq_commit();
+    }
+
+    return ((ret < 0) ? SVI_E_FAILED : SVI_E_OK);
+}
+
+/**
+********************************************************************************
+* @brief Initializes the queue and registers all writable variables
+*        and the queue statistics at the SVI server of the module.
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 git_test_wrq_sviServerInit(void)
+{
+    SINT32  ret;
+
+    if (!WrqProdSema)
+    {
+        WrqProdSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+        if (!WrqProdSema)
+        {
+            LOG_E(0, __func__, "Could not create semaphore for write queue!");
+            return (ERROR);
+        }
+    }
+
+    WrqHead = 0;
+    WrqTail = 0;
+    WrqTailPriv = 0;
+    WrqGroupOwner = 0;
+    memset(&git_test_WrqStat, 0, sizeof(git_test_WrqStat));
+
+    ret = git_test_AppSviAddVirtVars(WrqVarList, sizeof(WrqVarList) / sizeof(SVI_VIRTVAR));
+    if (ret < 0)
+    {
+        return (ret);
+    }
+
+    return (git_test_AppSviAddGlobVars(WrqStatVarList,
+                                       sizeof(WrqStatVarList) / sizeof(SVI_GLOBVAR)));
+}
+
+/**
+********************************************************************************
+* @brief Frees the resources of the write queue.
+*******************************************************************************/
+void git_test_wrq_deinit(void)
+{
+    if (WrqProdSema)
+    {
+        if (semDelete(WrqProdSema) < 0)
+        {
+            LOG_E(0, __func__, "Could not delete semaphore for write queue!");
+        }
+        else
+        {
+            WrqProdSema = 0;
+        }
+    }
+}
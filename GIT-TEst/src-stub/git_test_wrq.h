@@ -0,0 +1,47 @@
+/**
+********************************************************************************
+* @file     git_test_wrq.h
+* @author   Bachmann electronic GmbH
+*
+* @brief    This file contains the definitions for the queue of SVI write
+*           accesses, which are applied at the start of the control cycle.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2015
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef GIT_TEST_WRQ__H
+#define GIT_TEST_WRQ__H
+
+/* Statistics of the write queue, exported via SVI */
+typedef struct GIT_TEST_WRQ_STAT
+{
+    UINT32  NbOfGroups;                 /* write groups committed */
+    UINT32  NbOfWrites;                 /* single writes committed */
+    UINT32  NbOfOverflows;              /* write groups dropped due to a full queue */
+    UINT32  NbOfDropped;                /* single writes dropped due to a full queue */
+    UINT32  MaxFill;                    /* maximum number of pending writes */
+} GIT_TEST_WRQ_STAT;
+
+/*--- Variables ---*/
+
+extern GIT_TEST_WRQ_STAT git_test_WrqStat;
+
+/*--- Functions ---*/
+
+/* bTask: bracket all writes of one SVI call, they are applied as one group */
+extern void git_test_wrq_begin(void);
+extern void git_test_wrq_commit(void);
+
+/* bTask: discard a group left open by an exception */
+extern void git_test_wrq_abort(void);
+
+/* Control task: apply all committed writes, called at cycle start */
+extern void git_test_wrq_apply(void);
+
+/* bTask: register the writable variables at the SVI server */
+extern SINT32 git_test_wrq_sviServerInit(void);
+extern void git_test_wrq_deinit(void);
+
+#endif /* Avoid problems with multiple include */